@@ -0,0 +1,475 @@
+/*
+Measures the time it takes to generate and format UUIDs. Each benchmark is run on 1 to N threads in
+powers of two, with every thread doing the same number of operations. The generators that take a
+random number generator are run with the default generator (NULL) and with a long-lived cryptorand
+instance owned by each thread.
+
+By default the throughput is measured by timing the whole run, which gives the average time per
+operation on each thread and the total number of operations per second across all threads. With
+--percentiles each operation is timed on its own and the latency percentiles are reported as well.
+This adds the overhead of reading the clock, which is measured up front and taken off each sample.
+
+Use --json to output the results in a machine-readable format for tracking regressions between
+versions.
+
+    gcc -O2 uuid_bench.c -o uuid_bench -lpthread
+    ./uuid_bench [--threads N] [--iterations N] [--percentiles] [--json] [--filter name]
+*/
+#include "../external/md5/md5.c"    /* <-- Enables version 3. */
+#include "../external/sha1/sha1.c"  /* <-- Enables version 5. */
+
+#define UUID_IMPLEMENTATION
+#include "../uuid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(UUID_SUPPORT_THREADS)
+#error "This benchmark requires threads."
+#endif
+
+#define MAX_THREAD_COUNT    256
+
+typedef enum
+{
+    BENCH_RNG_NONE,         /* The operation does not use a random number generator. */
+    BENCH_RNG_DEFAULT,
+    BENCH_RNG_CRYPTORAND
+} bench_rng;
+
+static const char* bench_rng_name(bench_rng rng)
+{
+    switch (rng)
+    {
+        case BENCH_RNG_DEFAULT:    return "default";
+        case BENCH_RNG_CRYPTORAND: return "cryptorand";
+        default:                   return "none";
+    }
+}
+
+typedef enum
+{
+    BENCH_OP_UUID1,
+    BENCH_OP_UUID3,
+    BENCH_OP_UUID4,
+    BENCH_OP_UUID5,
+    BENCH_OP_UUID_ORDERED,
+    BENCH_OP_UUID_FORMAT,
+    BENCH_OP_COUNT
+} bench_op;
+
+static const char* g_opNames[BENCH_OP_COUNT] =
+{
+    "uuid1",
+    "uuid3",
+    "uuid4",
+    "uuid5",
+    "uuid_ordered",
+    "uuid_format"
+};
+
+static int bench_op_uses_rng(bench_op op)
+{
+    return op == BENCH_OP_UUID1 || op == BENCH_OP_UUID4 || op == BENCH_OP_UUID_ORDERED;
+}
+
+static const unsigned char g_namespaceDNS[UUID_SIZE] = {0x6b, 0xa7, 0xb8, 0x10, 0x9d, 0xad, 0x11, 0xd1, 0x80, 0xb4, 0x00, 0xc0, 0x4f, 0xd4, 0x30, 0xc8};
+
+typedef struct
+{
+    bench_op op;
+    uuid_rand* pRNG;
+    unsigned char uuid[UUID_SIZE];
+    char formatted[UUID_SIZE_FORMATTED];
+} bench_state;
+
+static uuid_result bench_run_op(bench_state* pState)
+{
+    switch (pState->op)
+    {
+        case BENCH_OP_UUID1:        return uuid1(pState->uuid, pState->pRNG);
+        case BENCH_OP_UUID3:        return uuid3(pState->uuid, g_namespaceDNS, "www.example.com");
+        case BENCH_OP_UUID4:        return uuid4(pState->uuid, pState->pRNG);
+        case BENCH_OP_UUID5:        return uuid5(pState->uuid, g_namespaceDNS, "www.example.com");
+        case BENCH_OP_UUID_ORDERED: return uuid_ordered(pState->uuid, pState->pRNG);
+        case BENCH_OP_UUID_FORMAT:
+        {
+            /* Feed the output back in so the compiler can't hoist the call out of the loop. */
+            uuid_result result = uuid_format(pState->formatted, sizeof(pState->formatted), pState->uuid);
+            pState->uuid[15] ^= (unsigned char)pState->formatted[35];
+            return result;
+        }
+        default: return UUID_INVALID_ARGS;
+    }
+}
+
+static uuid_uint64 bench_get_time(void)
+{
+    uuid_uint64 time;
+    uuid_clock_get_time(NULL, &time);
+    return time;
+}
+
+
+typedef struct
+{
+    bench_op op;
+    bench_rng rng;
+    size_t iterations;
+    int percentiles;
+    uuid_uint64 timerOverhead;          /* Taken off each sample in percentile mode. */
+    uuid_uint32* pSamples;              /* iterations samples in nanoseconds. Only used in percentile mode. */
+    volatile uuid_uint32* pReadyCount;  /* Incremented by each thread before it waits on the start flag. */
+    volatile uuid_uint64* pStartFlag;
+    uuid_result result;
+    unsigned char lastUUID[UUID_SIZE];
+} bench_thread;
+
+static void bench_thread_entry(void* pUserData)
+{
+    bench_thread* pThread = (bench_thread*)pUserData;
+    bench_state state;
+    uuid_cryptorand cryptorand;
+    uuid_uint64 timeBeg;
+    uuid_uint64 timeEnd;
+    size_t i;
+
+    UUID_ZERO_OBJECT(&state);
+    state.op = pThread->op;
+
+    /* The random number generator is initialized before the start flag so it's not part of the timing. */
+    if (pThread->rng == BENCH_RNG_CRYPTORAND) {
+        pThread->result = uuid_cryptorand_init(&cryptorand);
+        if (pThread->result != UUID_SUCCESS) {
+            uuid_atomic_fetch_add_32(pThread->pReadyCount, 1);    /* Don't leave the main thread waiting. */
+            return;
+        }
+
+        state.pRNG = (uuid_rand*)&cryptorand;
+    }
+
+    /* Warm up so the default generator is initialized on this thread and the code is in the cache. */
+    for (i = 0; i < 16; i += 1) {
+        bench_run_op(&state);
+    }
+
+    /* Wait for every thread to be ready so they all start at the same time. */
+    uuid_atomic_fetch_add_32(pThread->pReadyCount, 1);
+    while (uuid_atomic_load_64(pThread->pStartFlag) == 0) {
+    }
+
+    if (pThread->percentiles) {
+        for (i = 0; i < pThread->iterations; i += 1) {
+            uuid_uint64 sample;
+
+            timeBeg = bench_get_time();
+            bench_run_op(&state);
+            timeEnd = bench_get_time();
+
+            sample = timeEnd - timeBeg;
+            sample = (sample > pThread->timerOverhead) ? sample - pThread->timerOverhead : 0;
+            pThread->pSamples[i] = (sample > 0xFFFFFFFF) ? 0xFFFFFFFF : (uuid_uint32)sample;
+        }
+    } else {
+        for (i = 0; i < pThread->iterations; i += 1) {
+            bench_run_op(&state);
+        }
+    }
+
+    pThread->result = bench_run_op(&state);     /* Catch anything that's broken rather than reporting a time for it. */
+    UUID_COPY_MEMORY(pThread->lastUUID, state.uuid, UUID_SIZE);
+
+    if (pThread->rng == BENCH_RNG_CRYPTORAND) {
+        uuid_cryptorand_uninit(&cryptorand);
+    }
+
+    uuid_default_rng_shutdown();
+}
+
+/*
+The overhead is the smallest time between two clock reads, and is what we take off each sample in
+percentile mode. The resolution is the smallest change in the clock that we can see.
+*/
+static void bench_measure_timer(uuid_uint64* pOverhead, uuid_uint64* pResolution)
+{
+    uuid_uint64 overhead   = (uuid_uint64)-1;
+    uuid_uint64 resolution = (uuid_uint64)-1;
+    int i;
+
+    for (i = 0; i < 1000; i += 1) {
+        uuid_uint64 timeBeg = bench_get_time();
+        uuid_uint64 timeEnd = bench_get_time();
+
+        if (timeEnd - timeBeg < overhead) {
+            overhead = timeEnd - timeBeg;
+        }
+    }
+
+    for (i = 0; i < 1000; i += 1) {
+        uuid_uint64 timeBeg = bench_get_time();
+        uuid_uint64 timeEnd;
+
+        do {
+            timeEnd = bench_get_time();
+        } while (timeEnd == timeBeg);
+
+        if (timeEnd - timeBeg < resolution) {
+            resolution = timeEnd - timeBeg;
+        }
+    }
+
+    *pOverhead   = overhead;
+    *pResolution = resolution;
+}
+
+
+typedef struct
+{
+    bench_op op;
+    bench_rng rng;
+    unsigned int threadCount;
+    uuid_uint64 totalOps;
+    double nsPerOp;         /* Average time per operation on each thread. */
+    double opsPerSec;       /* Across all threads. */
+    uuid_uint32 p50;
+    uuid_uint32 p90;
+    uuid_uint32 p99;
+    uuid_uint32 p999;
+    uuid_uint32 max;
+} bench_result;
+
+static int bench_compare_samples(const void* a, const void* b)
+{
+    uuid_uint32 x = *(const uuid_uint32*)a;
+    uuid_uint32 y = *(const uuid_uint32*)b;
+
+    if (x < y) return -1;
+    if (x > y) return  1;
+    return 0;
+}
+
+static uuid_uint32 bench_percentile(const uuid_uint32* pSortedSamples, size_t count, double percentile)
+{
+    size_t index = (size_t)((percentile / 100.0) * (double)(count - 1) + 0.5);
+    return pSortedSamples[index];
+}
+
+static uuid_result bench_run(bench_op op, bench_rng rng, unsigned int threadCount, size_t iterations, int percentiles, uuid_uint64 timerOverhead, bench_result* pResult)
+{
+    static uuid_thread threads[MAX_THREAD_COUNT];
+    static bench_thread threadData[MAX_THREAD_COUNT];
+    volatile uuid_uint32 readyCount = 0;
+    volatile uuid_uint64 startFlag = 0;
+    uuid_uint32* pSamples = NULL;
+    uuid_uint64 timeBeg;
+    uuid_uint64 timeEnd;
+    uuid_result result = UUID_SUCCESS;
+    unsigned int iThread;
+
+    UUID_ZERO_OBJECT(pResult);
+    pResult->op          = op;
+    pResult->rng         = rng;
+    pResult->threadCount = threadCount;
+    pResult->totalOps    = (uuid_uint64)iterations * threadCount;
+
+    if (percentiles) {
+        pSamples = (uuid_uint32*)malloc(sizeof(*pSamples) * iterations * threadCount);
+        if (pSamples == NULL) {
+            return UUID_OUT_OF_MEMORY;
+        }
+    }
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        threadData[iThread].op            = op;
+        threadData[iThread].rng           = rng;
+        threadData[iThread].iterations    = iterations;
+        threadData[iThread].percentiles   = percentiles;
+        threadData[iThread].timerOverhead = timerOverhead;
+        threadData[iThread].pSamples      = (pSamples != NULL) ? pSamples + (iterations * iThread) : NULL;
+        threadData[iThread].pReadyCount   = &readyCount;
+        threadData[iThread].pStartFlag    = &startFlag;
+        threadData[iThread].result        = UUID_SUCCESS;
+
+        if (uuid_thread_create(&threads[iThread], bench_thread_entry, &threadData[iThread]) != UUID_SUCCESS) {
+            printf("Failed to create thread %u.\n", iThread);
+            exit(1);
+        }
+    }
+
+    /* Don't start the timer until every thread is waiting, otherwise thread creation and warm up are part of the timing. */
+    while (uuid_atomic_load_32(&readyCount) < threadCount) {
+    }
+
+    timeBeg = bench_get_time();
+    uuid_atomic_exchange_64(&startFlag, 1);
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        uuid_thread_join(&threads[iThread]);
+        if (threadData[iThread].result != UUID_SUCCESS) {
+            result = threadData[iThread].result;
+        }
+    }
+
+    timeEnd = bench_get_time();
+
+    if (timeEnd == timeBeg) {
+        timeEnd += 1;
+    }
+
+    pResult->opsPerSec = ((double)pResult->totalOps * 1000000000.0) / (double)(timeEnd - timeBeg);
+    pResult->nsPerOp   = (double)(timeEnd - timeBeg) / (double)iterations;
+
+    if (pSamples != NULL) {
+        size_t sampleCount = iterations * threadCount;
+
+        qsort(pSamples, sampleCount, sizeof(*pSamples), bench_compare_samples);
+        pResult->p50  = bench_percentile(pSamples, sampleCount, 50);
+        pResult->p90  = bench_percentile(pSamples, sampleCount, 90);
+        pResult->p99  = bench_percentile(pSamples, sampleCount, 99);
+        pResult->p999 = bench_percentile(pSamples, sampleCount, 99.9);
+        pResult->max  = pSamples[sampleCount - 1];
+
+        free(pSamples);
+    }
+
+    return result;
+}
+
+
+static void bench_print_header(int percentiles)
+{
+    printf("%-14s %-11s %7s %12s %14s", "Operation", "RNG", "Threads", "ns/op", "ops/s");
+    if (percentiles) {
+        printf(" %8s %8s %8s %8s %10s", "p50", "p90", "p99", "p99.9", "max");
+    }
+    printf("\n");
+}
+
+static void bench_print_result(const bench_result* pResult, int percentiles)
+{
+    printf("%-14s %-11s %7u %12.1f %14.0f", g_opNames[pResult->op], bench_rng_name(pResult->rng), pResult->threadCount, pResult->nsPerOp, pResult->opsPerSec);
+    if (percentiles) {
+        printf(" %8u %8u %8u %8u %10u", pResult->p50, pResult->p90, pResult->p99, pResult->p999, pResult->max);
+    }
+    printf("\n");
+}
+
+static void bench_print_result_json(const bench_result* pResult, int percentiles, int isFirst)
+{
+    printf("%s\n    {\"op\": \"%s\", \"rng\": \"%s\", \"threads\": %u, \"ops\": %lu, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f",
+        isFirst ? "" : ",", g_opNames[pResult->op], bench_rng_name(pResult->rng), pResult->threadCount, (unsigned long)pResult->totalOps, pResult->nsPerOp, pResult->opsPerSec);
+    if (percentiles) {
+        printf(", \"p50_ns\": %u, \"p90_ns\": %u, \"p99_ns\": %u, \"p999_ns\": %u, \"max_ns\": %u", pResult->p50, pResult->p90, pResult->p99, pResult->p999, pResult->max);
+    }
+    printf("}");
+}
+
+/* Powers of two, but the largest count is always tested even if it's not a power of two. */
+static unsigned int next_thread_count(unsigned int threadCount, unsigned int maxThreadCount)
+{
+    if (threadCount == maxThreadCount) {
+        return maxThreadCount + 1;
+    }
+
+    return (threadCount * 2 < maxThreadCount) ? threadCount * 2 : maxThreadCount;
+}
+
+static void bench_print_usage(void)
+{
+    printf("Usage: uuid_bench [options]\n");
+    printf("  --threads N       Run on 1 to N threads in powers of two. Default: 4.\n");
+    printf("  --iterations N    Operations per thread. Default: 1000000.\n");
+    printf("  --percentiles     Time each operation and report latency percentiles in nanoseconds.\n");
+    printf("  --json            Output the results as JSON.\n");
+    printf("  --filter NAME     Only run operations whose name contains NAME.\n");
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int maxThreadCount = 4;
+    size_t iterations = 1000000;
+    int percentiles = 0;
+    int json = 0;
+    const char* pFilter = NULL;
+    uuid_uint64 timerOverhead = 0;
+    uuid_uint64 timerResolution = 0;
+    int isFirstResult = 1;
+    int iArg;
+    int iOp;
+    int iRNG;
+    unsigned int threadCount;
+
+    for (iArg = 1; iArg < argc; iArg += 1) {
+        if (strcmp(argv[iArg], "--threads") == 0 && iArg + 1 < argc) {
+            maxThreadCount = (unsigned int)atoi(argv[++iArg]);
+            if (maxThreadCount < 1 || maxThreadCount > MAX_THREAD_COUNT) {
+                printf("Thread count must be between 1 and %d.\n", MAX_THREAD_COUNT);
+                return 1;
+            }
+        } else if (strcmp(argv[iArg], "--iterations") == 0 && iArg + 1 < argc) {
+            iterations = (size_t)atol(argv[++iArg]);
+            if (iterations == 0) {
+                printf("Iteration count must be greater than 0.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[iArg], "--percentiles") == 0) {
+            percentiles = 1;
+        } else if (strcmp(argv[iArg], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[iArg], "--filter") == 0 && iArg + 1 < argc) {
+            pFilter = argv[++iArg];
+        } else {
+            bench_print_usage();
+            return 1;
+        }
+    }
+
+    bench_measure_timer(&timerOverhead, &timerResolution);
+    if (!percentiles) {
+        timerOverhead = 0;
+    } else if (timerResolution >= 1000) {
+        fprintf(stderr, "Warning: The clock only has a resolution of %lu ns so the percentiles will not be accurate. If you compiled with -std=c89, try a later standard.\n", (unsigned long)timerResolution);
+    }
+
+    if (json) {
+        printf("{\n  \"iterations\": %lu,\n  \"max_threads\": %u,\n  \"cpu_features\": %u,\n  \"timer_overhead_ns\": %lu,\n  \"timer_resolution_ns\": %lu,\n  \"results\": [", (unsigned long)iterations, maxThreadCount, (unsigned int)uuid_get_cpu_features(), (unsigned long)timerOverhead, (unsigned long)timerResolution);
+    } else {
+        bench_print_header(percentiles);
+    }
+
+    for (iOp = 0; iOp < BENCH_OP_COUNT; iOp += 1) {
+        if (pFilter != NULL && strstr(g_opNames[iOp], pFilter) == NULL) {
+            continue;
+        }
+
+        for (iRNG = BENCH_RNG_NONE; iRNG <= BENCH_RNG_CRYPTORAND; iRNG += 1) {
+            /* Operations that don't take a random number generator are only run once. */
+            if (bench_op_uses_rng((bench_op)iOp) != (iRNG != BENCH_RNG_NONE)) {
+                continue;
+            }
+
+            for (threadCount = 1; threadCount <= maxThreadCount; threadCount = next_thread_count(threadCount, maxThreadCount)) {
+                bench_result result;
+
+                if (bench_run((bench_op)iOp, (bench_rng)iRNG, threadCount, iterations, percentiles, timerOverhead, &result) != UUID_SUCCESS) {
+                    fprintf(stderr, "%s with %s failed.\n", g_opNames[iOp], bench_rng_name((bench_rng)iRNG));
+                    break;
+                }
+
+                if (json) {
+                    bench_print_result_json(&result, percentiles, isFirstResult);
+                    isFirstResult = 0;
+                } else {
+                    bench_print_result(&result, percentiles);
+                }
+            }
+        }
+    }
+
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+Tests for the C++ wrapper. This needs C++20, unlike uuid_test.cpp which is just the C test compiled
+as C++.
+
+    g++ -std=c++20 uuid_hpp_test.cpp -o uuid_hpp_test -lpthread
+*/
+#include "../external/md5/md5.c"    /* <-- Enables version 3. */
+#include "../external/sha1/sha1.c"  /* <-- Enables version 5. */
+
+#define UUID_IMPLEMENTATION
+#include "../uuid.hpp"
+
+#include <stdio.h>
+#include <map>
+#include <unordered_set>
+
+/* These are all checked at compile time. */
+constexpr uuids::uuid g_namespaceDNS("6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+static_assert(g_namespaceDNS.version() == 1);
+static_assert(g_namespaceDNS == uuids::uuid("{6BA7B810-9DAD-11D1-80B4-00C04FD430C8}"));
+static_assert(g_namespaceDNS <  uuids::uuid("6ba7b811-9dad-11d1-80b4-00c04fd430c8"));
+static_assert(uuids::uuid().is_nil());
+static_assert([] { char buffer[64] = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"; return uuids::uuid(buffer); }() == g_namespaceDNS);
+static_assert(!uuids::uuid::parse("6ba7b810-9dad-11d1-80b4-00c04fd430cx").has_value());
+
+using namespace uuids::literals;
+static_assert(g_namespaceDNS == "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid);
+static_assert(uuids::uuid3_ct(g_namespaceDNS, "www.example.com") == "5df41881-3aed-3515-88a7-2f4a814cf09e"_uuid);
+static_assert(uuids::uuid5_ct(g_namespaceDNS, "www.example.com") == "2ed6657d-e927-568b-95e1-2665a8aea6a2"_uuid);
+
+int main(int argc, char** argv)
+{
+    size_t i;
+    size_t count = 10;
+
+
+    printf("uuids::v7()\n");
+    {
+        for (i = 0; i < count; i += 1) {
+            printf("%s\n", uuids::v7().to_string().c_str());
+        }
+    }
+    printf("\n");
+
+
+    printf("uuids::generator\n");
+    {
+        uuids::chacha_rng rng;
+        uuids::generator generator(rng.get());
+        uuids::generator moved(std::move(generator));
+        std::map<uuids::uuid, size_t> ordered;
+
+        for (i = 0; i < count; i += 1) {
+            ordered[moved.v7()] = i;
+        }
+
+        /* A strictly increasing generator should come out of the map in the order it went in. */
+        i = 0;
+        for (const auto& entry : ordered) {
+            printf("%s%s\n", entry.first.to_string().c_str(), (entry.second == i) ? "" : " (OUT OF ORDER)");
+            i += 1;
+        }
+    }
+    printf("\n");
+
+
+    printf("std::hash<uuids::uuid>\n");
+    {
+        std::unordered_set<uuids::uuid> set;
+        uuids::uuid id = uuids::v4();
+
+        set.insert(id);
+        set.insert(id);
+        set.insert(uuids::v4());
+
+        printf("Size:     %d\n", (int)set.size());
+        printf("uuid_hash: %s\n", (std::hash<uuids::uuid>()(id) == (size_t)uuid_hash(id.data(), 0)) ? "OK" : "(MISMATCH)");
+    }
+    printf("\n");
+
+
+    printf("uuids::uuid3_ct() / uuids::uuid5_ct()\n");
+    {
+        /* Names around the 55 and 119 byte padding boundaries need an extra block. */
+        const char* pNames[] = { "", "www.example.com", "012345678901234567890123456789012345678", "0123456789012345678901234567890123456789", "01234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123" };
+        constexpr uuids::uuid ct3[] = {
+            uuids::uuid3_ct(g_namespaceDNS, ""),
+            uuids::uuid3_ct(g_namespaceDNS, "www.example.com"),
+            uuids::uuid3_ct(g_namespaceDNS, "012345678901234567890123456789012345678"),
+            uuids::uuid3_ct(g_namespaceDNS, "0123456789012345678901234567890123456789"),
+            uuids::uuid3_ct(g_namespaceDNS, "01234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123")
+        };
+        constexpr uuids::uuid ct5[] = {
+            uuids::uuid5_ct(g_namespaceDNS, ""),
+            uuids::uuid5_ct(g_namespaceDNS, "www.example.com"),
+            uuids::uuid5_ct(g_namespaceDNS, "012345678901234567890123456789012345678"),
+            uuids::uuid5_ct(g_namespaceDNS, "0123456789012345678901234567890123456789"),
+            uuids::uuid5_ct(g_namespaceDNS, "01234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123")
+        };
+
+        for (i = 0; i < sizeof(pNames) / sizeof(pNames[0]); i += 1) {
+            uuids::uuid rt3;
+            uuids::uuid rt5;
+
+            uuid3(rt3.data(), g_namespaceDNS.data(), pNames[i]);
+            uuid5(rt5.data(), g_namespaceDNS.data(), pNames[i]);
+
+            printf("%s%s\n", ct3[i].to_string().c_str(), (ct3[i] == rt3) ? "" : " (MISMATCH)");
+            printf("%s%s\n", ct5[i].to_string().c_str(), (ct5[i] == rt5) ? "" : " (MISMATCH)");
+        }
+    }
+    printf("\n");
+
+
+#if defined(__cpp_lib_format)
+    printf("std::format()\n");
+    {
+        printf("%s\n", std::format("{}", g_namespaceDNS).c_str());
+    }
+    printf("\n");
+#endif
+
+    (void)argc;
+    (void)argv;
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+Compares uuid_generator, which is shared between threads, against uuid_sharded_generator with one
+shard per thread. Each thread generates the same number of ordered UUIDs and the total throughput
+is printed for each thread count.
+
+    gcc -O2 uuid_shard_bench.c -o uuid_shard_bench -lpthread
+    ./uuid_shard_bench [maxThreadCount] [uuidsPerThread]
+*/
+#define UUID_IMPLEMENTATION
+#include "../uuid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(UUID_SUPPORT_THREADS)
+#error "This benchmark requires threads."
+#endif
+
+#define MAX_THREAD_COUNT    256
+
+typedef struct
+{
+    uuid_generator* pGenerator;     /* Set when benchmarking the shared generator. */
+    uuid_shard* pShard;             /* Set when benchmarking the sharded generator. */
+    size_t count;
+    volatile uuid_uint32* pReadyCount;  /* Incremented by each thread before it waits on the start flag. */
+    volatile uuid_uint64* pStartFlag;
+    unsigned char lastUUID[UUID_SIZE];
+} bench_thread;
+
+static void bench_thread_entry(void* pUserData)
+{
+    bench_thread* pThread = (bench_thread*)pUserData;
+    unsigned char uuid[UUID_SIZE];
+    size_t i;
+
+    /* Wait for every thread to be ready so they all start at the same time. */
+    uuid_atomic_fetch_add_32(pThread->pReadyCount, 1);
+    while (uuid_atomic_load_64(pThread->pStartFlag) == 0) {
+    }
+
+    if (pThread->pShard != NULL) {
+        for (i = 0; i < pThread->count; i += 1) {
+            uuid_shard_ordered(pThread->pShard, uuid);
+        }
+    } else {
+        for (i = 0; i < pThread->count; i += 1) {
+            uuid_generator_ordered(pThread->pGenerator, uuid);
+        }
+    }
+
+    UUID_COPY_MEMORY(pThread->lastUUID, uuid, UUID_SIZE);    /* Stops the compiler from optimizing out the loop. */
+}
+
+static double run(unsigned int threadCount, size_t countPerThread, int sharded)
+{
+    static uuid_thread threads[MAX_THREAD_COUNT];
+    static bench_thread threadData[MAX_THREAD_COUNT];
+    uuid_generator generator;
+    uuid_sharded_generator shardedGenerator;
+    uuid_sharded_generator_config shardedConfig;
+    volatile uuid_uint32 readyCount = 0;
+    volatile uuid_uint64 startFlag = 0;
+    uuid_uint64 timeBeg;
+    uuid_uint64 timeEnd;
+    unsigned int iThread;
+
+    if (sharded) {
+        shardedConfig = uuid_sharded_generator_config_init(threadCount);
+        if (uuid_sharded_generator_init(&shardedConfig, &shardedGenerator) != UUID_SUCCESS) {
+            return 0;
+        }
+    } else {
+        if (uuid_generator_init(NULL, NULL, &generator) != UUID_SUCCESS) {
+            return 0;
+        }
+    }
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        threadData[iThread].pGenerator  = sharded ? NULL : &generator;
+        threadData[iThread].pShard      = sharded ? uuid_sharded_generator_get_shard(&shardedGenerator, iThread) : NULL;
+        threadData[iThread].count       = countPerThread;
+        threadData[iThread].pReadyCount = &readyCount;
+        threadData[iThread].pStartFlag  = &startFlag;
+
+        if (uuid_thread_create(&threads[iThread], bench_thread_entry, &threadData[iThread]) != UUID_SUCCESS) {
+            printf("Failed to create thread %u.\n", iThread);
+            exit(1);
+        }
+    }
+
+    /* Don't start the timer until every thread is waiting, otherwise thread creation is part of the timing. */
+    while (uuid_atomic_load_32(&readyCount) < threadCount) {
+    }
+
+    uuid_clock_get_time(NULL, &timeBeg);
+    uuid_atomic_exchange_64(&startFlag, 1);
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        uuid_thread_join(&threads[iThread]);
+    }
+
+    uuid_clock_get_time(NULL, &timeEnd);
+
+    if (sharded) {
+        uuid_sharded_generator_uninit(&shardedGenerator);
+    } else {
+        uuid_generator_uninit(&generator);
+    }
+
+    /* Millions of UUIDs per second across all threads. */
+    return ((double)countPerThread * threadCount * 1000) / (double)(timeEnd - timeBeg);
+}
+
+/* Powers of two, but the largest count is always tested even if it's not a power of two. */
+static unsigned int next_thread_count(unsigned int threadCount, unsigned int maxThreadCount)
+{
+    if (threadCount == maxThreadCount) {
+        return maxThreadCount + 1;
+    }
+
+    return (threadCount * 2 < maxThreadCount) ? threadCount * 2 : maxThreadCount;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int maxThreadCount = 8;
+    size_t countPerThread = 2000000;
+    unsigned int threadCount;
+    double baseShared = 0;
+    double baseSharded = 0;
+
+    if (argc > 1) {
+        maxThreadCount = (unsigned int)atoi(argv[1]);
+        if (maxThreadCount < 1 || maxThreadCount > MAX_THREAD_COUNT) {
+            printf("Thread count must be between 1 and %d.\n", MAX_THREAD_COUNT);
+            return 1;
+        }
+    }
+
+    if (argc > 2) {
+        countPerThread = (size_t)atol(argv[2]);
+    }
+
+    printf("Threads    uuid_generator (M/s)    uuid_shard (M/s)    Scaling (shared/sharded)\n");
+
+    for (threadCount = 1; threadCount <= maxThreadCount; threadCount = next_thread_count(threadCount, maxThreadCount)) {
+        double shared  = run(threadCount, countPerThread, 0);
+        double sharded = run(threadCount, countPerThread, 1);
+
+        if (threadCount == 1) {
+            baseShared  = shared;
+            baseSharded = sharded;
+        }
+
+        printf("%7u    %20.2f    %16.2f    %9.2fx / %.2fx\n", threadCount, shared, sharded, shared / baseShared, sharded / baseSharded);
+    }
+
+    return 0;
+}
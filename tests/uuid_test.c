@@ -79,6 +79,86 @@ int main(int argc, char** argv)
     printf("\n");
 
 
+    printf("uuid5_ns()\n");
+    {
+        unsigned char nsUUID[] = {0x6b, 0xa7, 0xb8, 0x11, 0x9d, 0xad, 0x11, 0xd1, 0x80, 0xb4, 0x00, 0xc0, 0x4f, 0xd4, 0x30, 0xc8}; /* "6ba7b811-9dad-11d1-80b4-00c04fd430c8" */
+        uuid_namespace ns;
+
+        uuid_namespace_init(nsUUID, &ns);
+
+        for (i = 0; i < count; i += 1) {
+            uuid5_ns(uuid, &ns, "Hello, World!", 13);   /* <-- Should be the same as uuid5() above. */
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+            printf("%s\n", uuidFormatted);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid5_batch()\n");
+    {
+        unsigned char ns[] = {0x6b, 0xa7, 0xb8, 0x11, 0x9d, 0xad, 0x11, 0xd1, 0x80, 0xb4, 0x00, 0xc0, 0x4f, 0xd4, 0x30, 0xc8}; /* "6ba7b811-9dad-11d1-80b4-00c04fd430c8" */
+        const char* names[] = {"Hello, World!", "", "a", "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog."};
+        unsigned char uuids[UUID_SIZE * 4];
+
+        uuid5_batch(uuids, 4, ns, names, NULL);
+
+        for (i = 0; i < 4; i += 1) {
+            uuid5(uuid, ns, names[i]);  /* <-- The batched version should be the same as the normal version. */
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuids + (i * UUID_SIZE));
+            printf("%s%s\n", uuidFormatted, (memcmp(uuid, uuids + (i * UUID_SIZE), UUID_SIZE) == 0) ? "" : " (MISMATCH)");
+        }
+
+        /* The portable implementation should give the same result as the one selected for this CPU. */
+        printf("CPU features: 0x%08X\n", uuid_get_cpu_features());
+        uuid_set_cpu_features(0);
+        {
+            unsigned char uuidsPortable[UUID_SIZE * 4];
+
+            uuid5_batch(uuidsPortable, 4, ns, names, NULL);
+            printf("Portable: %s\n", (memcmp(uuids, uuidsPortable, sizeof(uuids)) == 0) ? "OK" : "MISMATCH");
+        }
+        uuid_set_cpu_features(UUID_CPU_FEATURE_ALL);
+    }
+    printf("\n");
+
+
+    printf("uuid6()\n");
+    {
+        for (i = 0; i < count; i += 1) {
+            uuid6(uuid, NULL);
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+            printf("%s\n", uuidFormatted);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid7()\n");
+    {
+        for (i = 0; i < count; i += 1) {
+            uuid7(uuid, NULL);
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+            printf("%s\n", uuidFormatted);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid8()\n");
+    {
+        /* The custom data can be the output buffer. */
+        for (i = 0; i < UUID_SIZE; i += 1) {
+            uuid[i] = (unsigned char)(0x10 + i);
+        }
+
+        uuid8(uuid, uuid);
+        uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+        printf("%s\n", uuidFormatted);     /* <-- Should be 10111213-1415-8617-9819-1a1b1c1d1e1f. */
+    }
+    printf("\n");
+
+
     printf("uuid_ordered()\n");
     {
         for (i = 0; i < count; i += 1) {
@@ -90,6 +170,252 @@ int main(int argc, char** argv)
     printf("\n");
 
 
+    printf("uuid_shard_uuid7()\n");
+    {
+        uuid_sharded_generator_config shardedConfig = uuid_sharded_generator_config_init(2);
+        uuid_sharded_generator shardedGenerator;
+
+        if (uuid_sharded_generator_init(&shardedConfig, &shardedGenerator) == UUID_SUCCESS) {
+            for (i = 0; i < count; i += 1) {
+                uuid_shard_uuid7(uuid_sharded_generator_get_shard(&shardedGenerator, (uuid_uint32)(i & 1)), uuid);
+                uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+                printf("%s (shard %d)\n", uuidFormatted, (uuid[8] >> 5) & 1);
+            }
+
+            uuid_sharded_generator_uninit(&shardedGenerator);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_pool_pop()\n");
+    {
+        uuid_pool_config poolConfig = uuid_pool_config_init();
+        uuid_pool pool;
+
+        poolConfig.capacity   = 64;
+        poolConfig.onGenerate = uuid7_batch;
+
+        if (uuid_pool_init(&poolConfig, &pool) == UUID_SUCCESS) {
+            for (i = 0; i < count; i += 1) {
+                uuid_pool_pop(&pool, uuid);
+                uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+                printf("%s\n", uuidFormatted);
+            }
+
+            uuid_pool_uninit(&pool);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid4_batch()\n");
+    {
+        unsigned char uuids[UUID_SIZE * 10];
+
+        char formatted[UUID_SIZE_FORMATTED * 10];
+        char formattedPortable[UUID_SIZE_FORMATTED * 10];
+
+        uuid4_batch(uuids, count, NULL);
+        for (i = 0; i < count; i += 1) {
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuids + (i * UUID_SIZE));
+            printf("%s\n", uuidFormatted);
+        }
+
+        /* The portable formatter should give the same result as the one selected for this CPU. */
+        uuid_format_batch(formatted, UUID_SIZE_FORMATTED, uuids, count);
+        uuid_set_cpu_features(0);
+        uuid_format_batch(formattedPortable, UUID_SIZE_FORMATTED, uuids, count);
+        uuid_set_cpu_features(UUID_CPU_FEATURE_ALL);
+        printf("Portable: %s\n", (memcmp(formatted, formattedPortable, sizeof(formatted)) == 0) ? "OK" : "MISMATCH");
+    }
+    printf("\n");
+
+
+    printf("uuid_ordered_batch()\n");
+    {
+        unsigned char uuids[UUID_SIZE * 10];
+
+        uuid_ordered_batch(uuids, count, NULL);
+        for (i = 0; i < count; i += 1) {
+            uuid_format(uuidFormatted, sizeof(uuidFormatted), uuids + (i * UUID_SIZE));
+            printf("%s\n", uuidFormatted);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_parse()\n");
+    {
+        const char* pStrings[] = {
+            "6ba7b811-9dad-11d1-80b4-00c04fd430c8",
+            "6BA7B811-9DAD-11D1-80B4-00C04FD430C8",
+            "{6ba7b811-9dad-11d1-80b4-00c04fd430c8}",
+            "urn:uuid:6ba7b811-9dad-11d1-80b4-00c04fd430c8",
+            "6ba7b8119dad11d180b400c04fd430c8",
+            "6ba7b811-9dad-11d1-80b4-00c04fd430cg"  /* <-- Invalid. */
+        };
+
+        for (i = 0; i < sizeof(pStrings) / sizeof(pStrings[0]); i += 1) {
+            if (uuid_parse(uuid, pStrings[i], (size_t)-1) == UUID_SUCCESS) {
+                uuid_format(uuidFormatted, sizeof(uuidFormatted), uuid);
+                printf("%s\n", uuidFormatted);
+            } else {
+                printf("%s (invalid)\n", pStrings[i]);
+            }
+        }
+    }
+    printf("\n");
+
+
+    printf("Compact encodings\n");
+    {
+        unsigned char uuidParsed[UUID_SIZE];
+        char encoded[UUID_SIZE_BASE32];
+
+        uuid_parse(uuid, "6ba7b811-9dad-11d1-80b4-00c04fd430c8", (size_t)-1);
+
+        uuid_format_base32(encoded, sizeof(encoded), uuid);
+        printf("base32:    %s%s\n", encoded, (uuid_parse_base32(uuidParsed, encoded, (size_t)-1) == UUID_SUCCESS && memcmp(uuid, uuidParsed, UUID_SIZE) == 0) ? "" : " (MISMATCH)");
+
+        uuid_format_base58(encoded, sizeof(encoded), uuid);
+        printf("base58:    %s%s\n", encoded, (uuid_parse_base58(uuidParsed, encoded, (size_t)-1) == UUID_SUCCESS && memcmp(uuid, uuidParsed, UUID_SIZE) == 0) ? "" : " (MISMATCH)");
+
+        uuid_format_base64url(encoded, sizeof(encoded), uuid);
+        printf("base64url: %s%s\n", encoded, (uuid_parse_base64url(uuidParsed, encoded, (size_t)-1) == UUID_SUCCESS && memcmp(uuid, uuidParsed, UUID_SIZE) == 0) ? "" : " (MISMATCH)");
+    }
+    printf("\n");
+
+
+    printf("uuid_compare()\n");
+    {
+        unsigned char uuids[UUID_SIZE * 2];
+
+        uuid_parse(uuids,             "017f22e2-79b0-7cc3-98c4-dc0c0c07398f", (size_t)-1);
+        uuid_parse(uuids + UUID_SIZE, "017f22e2-79b1-7cc3-98c4-dc0c0c07398f", (size_t)-1);    /* <-- One millisecond later. */
+
+        printf("compare:  %d\n", uuid_compare(uuids, uuids + UUID_SIZE));
+        printf("equal:    %d\n", uuid_equal(uuids, uuids));
+        printf("is_nil:   %d\n", uuid_is_nil(uuids));
+        printf("hash:     %08X%08X\n", (unsigned int)(uuid_hash(uuids, 0) >> 32), (unsigned int)(uuid_hash(uuids, 0) & 0xFFFFFFFF));
+
+        /* The inline versions must give the same results. */
+        if (uuid_compare_inline(uuids, uuids + UUID_SIZE) != uuid_compare(uuids, uuids + UUID_SIZE) ||
+            uuid_equal_inline(uuids, uuids + UUID_SIZE)   != uuid_equal(uuids, uuids + UUID_SIZE) ||
+            uuid_hash_inline(uuids, 42)                   != uuid_hash(uuids, 42)) {
+            printf("inline:   FAILED\n");
+        } else {
+            printf("inline:   OK\n");
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_set\n");
+    {
+        uuid_set_config setConfig = uuid_set_config_init();
+        uuid_set set;
+        unsigned char uuids[UUID_SIZE * 10];
+        size_t insertedCount;
+
+        if (uuid_set_init(&setConfig, &set) == UUID_SUCCESS) {
+            uuid4_batch(uuids, 10, NULL);
+            uuid_set_insert_batch(&set, uuids, 10, &insertedCount);
+
+            printf("inserted:  %d\n", (int)insertedCount);
+            printf("duplicate: %s\n", (uuid_set_insert(&set, uuids) == UUID_ALREADY_EXISTS) ? "UUID_ALREADY_EXISTS" : "(MISMATCH)");
+            printf("removed:   %s\n", (uuid_set_remove(&set, uuids) == UUID_SUCCESS && !uuid_set_contains(&set, uuids)) ? "yes" : "(MISMATCH)");
+            printf("count:     %d\n", (int)uuid_set_count(&set));
+
+            uuid_set_uninit(&set);
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_sort()\n");
+    {
+        unsigned char uuids[UUID_SIZE * 10];
+        char str[UUID_SIZE_FORMATTED];
+        int isSorted = 1;
+
+        uuid4_batch(uuids, 10, NULL);
+        uuid_sort(uuids, 10, NULL);
+
+        for (i = 0; i < 10; i += 1) {
+            uuid_format(str, sizeof(str), uuids + (i * UUID_SIZE));
+            printf("%s\n", str);
+
+            if (i > 0 && uuid_compare(uuids + ((i - 1) * UUID_SIZE), uuids + (i * UUID_SIZE)) > 0) {
+                isSorted = 0;
+            }
+        }
+
+        printf("Sorted: %s\n", isSorted ? "OK" : "(MISMATCH)");
+    }
+    printf("\n");
+
+
+    printf("uuid_column_encode()\n");
+    {
+        uuid_generator generator;
+        unsigned char uuids[UUID_SIZE * 100];
+        unsigned char decoded[UUID_SIZE * 100];
+        unsigned char encoded[UUID_SIZE * 100 + 64];
+        size_t encodedSize;
+        size_t decodedCount;
+
+        if (uuid_generator_init(NULL, NULL, &generator) == UUID_SUCCESS) {
+            for (i = 0; i < 100; i += 1) {
+                uuid_generator_uuid7(&generator, uuids + (i * UUID_SIZE));
+            }
+
+            uuid_generator_uninit(&generator);
+
+            if (uuid_column_encode(encoded, sizeof(encoded), uuids, 100, 0, &encodedSize) == UUID_SUCCESS) {
+                printf("Encoded:  %d bytes -> %d bytes\n", (int)sizeof(uuids), (int)encodedSize);
+                printf("Decoded:  %s\n", (uuid_column_decode(decoded, 100, encoded, encodedSize, &decodedCount) == UUID_SUCCESS && decodedCount == 100 && memcmp(decoded, uuids, sizeof(uuids)) == 0) ? "OK" : "(MISMATCH)");
+            }
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_clock_tsc\n");
+    {
+        uuid_clock_tsc tscClock;
+        uuid_uint64 defaultTime;
+        uuid_uint64 tscTime;
+
+        if (uuid_clock_tsc_init(&tscClock) == UUID_SUCCESS) {
+            /* An anchor ahead of the TSC, as seen from another core, must not wrap around into the future. */
+            tscClock.anchorTicks += 1000000000;
+
+            uuid_clock_get_time(NULL, &defaultTime);
+            uuid_clock_get_time((uuid_clock*)&tscClock, &tscTime);
+            printf("Anchor ahead of TSC: %s\n", (tscTime < defaultTime + 1000000000) ? "OK" : "FAILED");
+        } else {
+            printf("Not supported.\n");
+        }
+    }
+    printf("\n");
+
+
+    printf("uuid_get_stats()\n");
+    {
+        uuid_stats stats;
+
+        if (uuid_get_stats(&stats) == UUID_SUCCESS) {
+            printf("RNG calls:   %u (%u bytes)\n", (unsigned int)stats.rngCallCount, (unsigned int)stats.rngByteCount);
+            printf("Clock reads: %u\n", (unsigned int)stats.clockReadCount);
+            printf("Same tick:   %u\n", (unsigned int)stats.sameTickCount);
+        } else {
+            printf("Not enabled. Define UUID_ENABLE_STATS.\n");
+        }
+    }
+    printf("\n");
+
+
     (void)argc;
     (void)argv;
 
@@ -0,0 +1,928 @@
+/*
+Command line tool for generating UUIDs in bulk, such as for test fixtures and database loads.
+
+    gcc -O2 uuid_cli.c -o uuid -lpthread
+    ./uuid [-v 1|3|4|5|6|7|ordered] [-n count] [-f canonical|dashless|binary] [-t threads] [--sort]
+           [--namespace dns|url|oid|x500|<uuid>] [-o file]
+
+Version 4 is generated by default. Versions 3 and 5 read names from stdin, one per line, and output
+one UUID per name in the same order. Trailing carriage returns are removed from each name. The count
+is ignored for these versions.
+
+The time-based versions use a uuid_sharded_generator with one shard per thread, so the UUIDs from each
+thread are strictly increasing and never the same as those from another thread. With one thread the
+output is in order. With more than one thread, use --sort if the output needs to be in order.
+
+UUIDs are generated and formatted in chunks straight into a large output buffer which is written with
+a single call, so there are very few system calls. With more than one thread, each thread generates
+and formats whole chunks and the main thread writes them out in order. With --sort everything is
+generated up front, each thread sorts its own part, and the parts are merged while being written.
+This needs 32 bytes of memory per UUID.
+*/
+#include "../external/md5/md5.c"    /* <-- Enables version 3. */
+#include "../external/sha1/sha1.c"  /* <-- Enables version 5. */
+
+#define UUID_IMPLEMENTATION
+#include "../uuid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#define CLI_CHUNK_SIZE          32768   /* The number of UUIDs in each chunk. */
+#define CLI_BUFFER_ALIGNMENT    4096
+#define CLI_MAX_THREAD_COUNT    256
+
+typedef enum
+{
+    CLI_UUID1,
+    CLI_UUID3,
+    CLI_UUID4,
+    CLI_UUID5,
+    CLI_UUID6,
+    CLI_UUID7,
+    CLI_UUID_ORDERED
+} cli_version;
+
+typedef enum
+{
+    CLI_FORMAT_CANONICAL,   /* 36 characters and a new line. */
+    CLI_FORMAT_DASHLESS,    /* 32 characters and a new line. */
+    CLI_FORMAT_BINARY       /* 16 bytes with nothing in between. */
+} cli_format;
+
+typedef struct
+{
+    cli_version version;
+    cli_format format;
+    size_t count;
+    unsigned int threadCount;
+    int sort;
+    unsigned char namespaceUUID[UUID_SIZE];
+    const char** ppNames;
+    size_t* pNameLengths;
+    char* pNameData;
+    uuid_sharded_generator generator;
+    FILE* pOutput;
+} cli;
+
+
+static size_t cli_format_size(cli_format format)
+{
+    switch (format)
+    {
+        case CLI_FORMAT_DASHLESS: return 33;
+        case CLI_FORMAT_BINARY:   return UUID_SIZE;
+        default:                  return 37;
+    }
+}
+
+static int cli_is_time_based(cli_version version)
+{
+    return version == CLI_UUID1 || version == CLI_UUID6 || version == CLI_UUID7 || version == CLI_UUID_ORDERED;
+}
+
+/* The returned pointer must be freed with cli_aligned_free(). */
+static void* cli_aligned_malloc(size_t size)
+{
+    unsigned char* pAllocation;
+    unsigned char* pAligned;
+
+    pAllocation = (unsigned char*)malloc(size + CLI_BUFFER_ALIGNMENT + sizeof(void*));
+    if (pAllocation == NULL) {
+        return NULL;
+    }
+
+    pAligned = (unsigned char*)(((size_t)(pAllocation + sizeof(void*)) + (CLI_BUFFER_ALIGNMENT - 1)) & ~(size_t)(CLI_BUFFER_ALIGNMENT - 1));
+    ((void**)pAligned)[-1] = pAllocation;
+
+    return pAligned;
+}
+
+static void cli_aligned_free(void* p)
+{
+    if (p != NULL) {
+        free(((void**)p)[-1]);
+    }
+}
+
+
+/*
+Generates a range of UUIDs. The offset is the index of the first UUID in the whole output which is
+used to find the names for versions 3 and 5. Each thread must use its own shard index.
+*/
+static uuid_result cli_generate(cli* pCLI, unsigned int shardIndex, unsigned char* pUUIDs, size_t offset, size_t count)
+{
+    uuid_shard* pShard = NULL;
+    uuid_result result = UUID_SUCCESS;
+    size_t i;
+
+    if (cli_is_time_based(pCLI->version)) {
+        pShard = uuid_sharded_generator_get_shard(&pCLI->generator, shardIndex);
+    }
+
+    switch (pCLI->version)
+    {
+        case CLI_UUID3: return uuid3_batch(pUUIDs, count, pCLI->namespaceUUID, pCLI->ppNames + offset, pCLI->pNameLengths + offset);
+        case CLI_UUID4: return uuid4_batch(pUUIDs, count, NULL);
+        case CLI_UUID5: return uuid5_batch(pUUIDs, count, pCLI->namespaceUUID, pCLI->ppNames + offset, pCLI->pNameLengths + offset);
+
+        case CLI_UUID1:
+        {
+            for (i = 0; i < count && result == UUID_SUCCESS; i += 1) {
+                result = uuid_shard_uuid1(pShard, pUUIDs + i*UUID_SIZE);
+            }
+        } break;
+
+        case CLI_UUID6:
+        {
+            for (i = 0; i < count && result == UUID_SUCCESS; i += 1) {
+                result = uuid_shard_uuid6(pShard, pUUIDs + i*UUID_SIZE);
+            }
+        } break;
+
+        case CLI_UUID7:
+        {
+            for (i = 0; i < count && result == UUID_SUCCESS; i += 1) {
+                result = uuid_shard_uuid7(pShard, pUUIDs + i*UUID_SIZE);
+            }
+        } break;
+
+        case CLI_UUID_ORDERED:
+        {
+            for (i = 0; i < count && result == UUID_SUCCESS; i += 1) {
+                result = uuid_shard_ordered(pShard, pUUIDs + i*UUID_SIZE);
+            }
+        } break;
+
+        default: return UUID_INVALID_ARGS;
+    }
+
+    return result;
+}
+
+/* Returns the number of bytes written to pDst. */
+static size_t cli_format_uuids(char* pDst, const unsigned char* pUUIDs, size_t count, cli_format format)
+{
+    static const char* pDigits = "0123456789abcdef";
+    size_t i;
+    size_t j;
+
+    if (format == CLI_FORMAT_BINARY) {
+        UUID_COPY_MEMORY(pDst, pUUIDs, count * UUID_SIZE);
+        return count * UUID_SIZE;
+    }
+
+    if (format == CLI_FORMAT_DASHLESS) {
+        for (i = 0; i < count; i += 1) {
+            char* pStr = pDst + i*33;
+            const unsigned char* pUUID = pUUIDs + i*UUID_SIZE;
+
+            for (j = 0; j < UUID_SIZE; j += 1) {
+                pStr[j*2 + 0] = pDigits[pUUID[j] >> 4];
+                pStr[j*2 + 1] = pDigits[pUUID[j] & 0x0F];
+            }
+
+            pStr[32] = '\n';
+        }
+
+        return count * 33;
+    }
+
+    /* A stride of 37 null terminates each string which we then replace with a new line. */
+    uuid_format_batch(pDst, 37, pUUIDs, count);
+    for (i = 0; i < count; i += 1) {
+        pDst[i*37 + 36] = '\n';
+    }
+
+    return count * 37;
+}
+
+static uuid_result cli_write(cli* pCLI, const char* pData, size_t size)
+{
+    if (size > 0 && fwrite(pData, 1, size, pCLI->pOutput) != size) {
+        return UUID_ERROR;
+    }
+
+    return UUID_SUCCESS;
+}
+
+
+/*
+Sorting. Runs that are already in order, which is the case for anything coming from a shard except
+version 1, are left as is. Otherwise the UUIDs are bucketed by their first two bytes into pTemp, and
+each bucket is sorted on its own. Random UUIDs are spread evenly between buckets so these are small.
+Returns a pointer to whichever of the two buffers ends up holding the sorted UUIDs.
+*/
+static int cli_compare(const void* a, const void* b)
+{
+    return memcmp(a, b, UUID_SIZE);
+}
+
+static unsigned char* cli_sort(unsigned char* pUUIDs, unsigned char* pTemp, size_t count)
+{
+    size_t* pOffsets;
+    size_t i;
+
+    for (i = 1; i < count; i += 1) {
+        if (memcmp(pUUIDs + (i-1)*UUID_SIZE, pUUIDs + i*UUID_SIZE, UUID_SIZE) > 0) {
+            break;
+        }
+    }
+
+    if (i >= count) {
+        return pUUIDs;
+    }
+
+    pOffsets = (size_t*)calloc(65536 + 1, sizeof(*pOffsets));
+    if (pOffsets == NULL) {
+        qsort(pUUIDs, count, UUID_SIZE, cli_compare);
+        return pUUIDs;
+    }
+
+    for (i = 0; i < count; i += 1) {
+        pOffsets[((pUUIDs[i*UUID_SIZE + 0] << 8) | pUUIDs[i*UUID_SIZE + 1]) + 1] += 1;
+    }
+
+    for (i = 1; i <= 65536; i += 1) {
+        pOffsets[i] += pOffsets[i-1];
+    }
+
+    /* pOffsets[bucket] is advanced to the end of the bucket while scattering. */
+    for (i = 0; i < count; i += 1) {
+        size_t bucket = (pUUIDs[i*UUID_SIZE + 0] << 8) | pUUIDs[i*UUID_SIZE + 1];
+        UUID_COPY_MEMORY(pTemp + pOffsets[bucket]*UUID_SIZE, pUUIDs + i*UUID_SIZE, UUID_SIZE);
+        pOffsets[bucket] += 1;
+    }
+
+    for (i = 0; i < 65536; i += 1) {
+        size_t bucketBeg = (i == 0) ? 0 : pOffsets[i-1];
+        size_t bucketEnd = pOffsets[i];
+
+        if (bucketEnd - bucketBeg > 1) {
+            qsort(pTemp + bucketBeg*UUID_SIZE, bucketEnd - bucketBeg, UUID_SIZE, cli_compare);
+        }
+    }
+
+    free(pOffsets);
+    return pTemp;
+}
+
+
+typedef struct
+{
+    cli* pCLI;
+    unsigned int index;
+    unsigned char* pUUIDs;      /* Where this part starts in the buffer of all UUIDs. */
+    unsigned char* pTemp;       /* Where this part starts in the temporary buffer of the same size. */
+    unsigned char* pSorted;     /* Either pUUIDs or pTemp. */
+    size_t offset;
+    size_t count;
+    uuid_result result;
+} cli_part;
+
+static void cli_part_generate_and_sort(cli_part* pPart)
+{
+    size_t i;
+
+    for (i = 0; i < pPart->count; i += CLI_CHUNK_SIZE) {
+        size_t count = (pPart->count - i < CLI_CHUNK_SIZE) ? (pPart->count - i) : CLI_CHUNK_SIZE;
+
+        pPart->result = cli_generate(pPart->pCLI, pPart->index, pPart->pUUIDs + i*UUID_SIZE, pPart->offset + i, count);
+        if (pPart->result != UUID_SUCCESS) {
+            return;
+        }
+    }
+
+    pPart->pSorted = cli_sort(pPart->pUUIDs, pPart->pTemp, pPart->count);
+}
+
+#if defined(UUID_SUPPORT_THREADS)
+static void cli_part_entry(void* pUserData)
+{
+    cli_part_generate_and_sort((cli_part*)pUserData);
+    uuid_default_rng_shutdown();
+}
+#endif
+
+/* Merges the sorted parts into the output buffer one chunk at a time. */
+static uuid_result cli_merge(cli* pCLI, cli_part* pParts, unsigned int partCount, unsigned char* pUUIDs, char* pBuffer)
+{
+    size_t cursors[CLI_MAX_THREAD_COUNT];
+    uuid_result result;
+    size_t remaining = pCLI->count;
+    unsigned int iPart;
+
+    for (iPart = 0; iPart < partCount; iPart += 1) {
+        cursors[iPart] = 0;
+    }
+
+    while (remaining > 0) {
+        size_t count = (remaining < CLI_CHUNK_SIZE) ? remaining : CLI_CHUNK_SIZE;
+        size_t i;
+
+        for (i = 0; i < count; i += 1) {
+            const unsigned char* pMin = NULL;
+            unsigned int iMin = 0;
+
+            for (iPart = 0; iPart < partCount; iPart += 1) {
+                const unsigned char* pCandidate;
+
+                if (cursors[iPart] == pParts[iPart].count) {
+                    continue;
+                }
+
+                pCandidate = pParts[iPart].pSorted + cursors[iPart]*UUID_SIZE;
+                if (pMin == NULL || memcmp(pCandidate, pMin, UUID_SIZE) < 0) {
+                    pMin = pCandidate;
+                    iMin = iPart;
+                }
+            }
+
+            UUID_COPY_MEMORY(pUUIDs + i*UUID_SIZE, pMin, UUID_SIZE);
+            cursors[iMin] += 1;
+        }
+
+        result = cli_write(pCLI, pBuffer, cli_format_uuids(pBuffer, pUUIDs, count, pCLI->format));
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+
+        remaining -= count;
+    }
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result cli_run_sorted(cli* pCLI)
+{
+    cli_part parts[CLI_MAX_THREAD_COUNT];
+    unsigned char* pAll;
+    unsigned char* pTemp;
+    unsigned char* pChunk;
+    char* pBuffer;
+    uuid_result result = UUID_SUCCESS;
+    size_t offset = 0;
+    unsigned int iPart;
+
+    /* The count is checked in main(), but make sure the sizes below can't wrap. */
+    if (pCLI->count > ((size_t)-1) / UUID_SIZE) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    pAll    = (unsigned char*)malloc(pCLI->count * UUID_SIZE);
+    pTemp   = (unsigned char*)malloc(pCLI->count * UUID_SIZE);
+    pChunk  = (unsigned char*)malloc(CLI_CHUNK_SIZE * UUID_SIZE);
+    pBuffer = (char*)cli_aligned_malloc(CLI_CHUNK_SIZE * cli_format_size(pCLI->format));
+    if (pAll == NULL || pTemp == NULL || pChunk == NULL || pBuffer == NULL) {
+        result = UUID_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    for (iPart = 0; iPart < pCLI->threadCount; iPart += 1) {
+        cli_part* pPart = &parts[iPart];
+
+        pPart->pCLI    = pCLI;
+        pPart->index   = iPart;
+        pPart->offset  = offset;
+        pPart->count   = pCLI->count / pCLI->threadCount + ((iPart < pCLI->count % pCLI->threadCount) ? 1 : 0);
+        pPart->pUUIDs  = pAll  + offset*UUID_SIZE;
+        pPart->pTemp   = pTemp + offset*UUID_SIZE;
+        pPart->pSorted = pPart->pUUIDs;
+        pPart->result  = UUID_SUCCESS;
+
+        offset += pPart->count;
+    }
+
+#if defined(UUID_SUPPORT_THREADS)
+    if (pCLI->threadCount > 1) {
+        uuid_thread threads[CLI_MAX_THREAD_COUNT];
+        unsigned int threadCount;
+
+        for (threadCount = 0; threadCount < pCLI->threadCount; threadCount += 1) {
+            if (uuid_thread_create(&threads[threadCount], cli_part_entry, &parts[threadCount]) != UUID_SUCCESS) {
+                parts[threadCount].result = UUID_ERROR;
+                break;
+            }
+        }
+
+        for (iPart = 0; iPart < threadCount; iPart += 1) {
+            uuid_thread_join(&threads[iPart]);
+        }
+    } else
+#endif
+    {
+        cli_part_generate_and_sort(&parts[0]);
+    }
+
+    for (iPart = 0; iPart < pCLI->threadCount; iPart += 1) {
+        if (parts[iPart].result != UUID_SUCCESS) {
+            result = parts[iPart].result;
+            goto done;
+        }
+    }
+
+    result = cli_merge(pCLI, parts, pCLI->threadCount, pChunk, pBuffer);
+
+done:
+    cli_aligned_free(pBuffer);
+    free(pChunk);
+    free(pTemp);
+    free(pAll);
+    return result;
+}
+
+
+/*
+Unsorted output with more than one thread. Chunk k is generated by worker (k % threadCount) into one
+of that worker's two slots, and the main thread writes the slots in chunk order. The state of each
+slot is what hands it between threads. The events are only used to avoid spinning. They can miss a
+signal, so waits use a short timeout and check the state again.
+*/
+#if defined(UUID_SUPPORT_THREADS)
+#define CLI_SLOT_FREE   0
+#define CLI_SLOT_READY  1
+
+typedef struct
+{
+    volatile uuid_uint64 state;
+    char* pData;
+    size_t size;
+    uuid_result result;
+} cli_slot;
+
+typedef struct cli_pipeline cli_pipeline;
+
+typedef struct
+{
+    cli_pipeline* pPipeline;
+    unsigned int index;
+    unsigned char* pUUIDs;
+    cli_slot slots[2];
+    uuid_event event;           /* Signaled when the main thread frees a slot. */
+    uuid_thread thread;
+} cli_worker;
+
+struct cli_pipeline
+{
+    cli* pCLI;
+    size_t chunkCount;
+    volatile uuid_uint64 isAborting;
+    uuid_event event;           /* Signaled when a worker fills a slot. */
+    cli_worker* pWorkers;
+};
+
+static cli_slot* cli_pipeline_get_slot(cli_pipeline* pPipeline, size_t chunkIndex)
+{
+    unsigned int threadCount = pPipeline->pCLI->threadCount;
+    return &pPipeline->pWorkers[chunkIndex % threadCount].slots[(chunkIndex / threadCount) % 2];
+}
+
+static void cli_worker_entry(void* pUserData)
+{
+    cli_worker* pWorker = (cli_worker*)pUserData;
+    cli_pipeline* pPipeline = pWorker->pPipeline;
+    cli* pCLI = pPipeline->pCLI;
+    size_t chunkIndex;
+
+    for (chunkIndex = pWorker->index; chunkIndex < pPipeline->chunkCount; chunkIndex += pCLI->threadCount) {
+        cli_slot* pSlot = cli_pipeline_get_slot(pPipeline, chunkIndex);
+        size_t offset = chunkIndex * CLI_CHUNK_SIZE;
+        size_t count = (pCLI->count - offset < CLI_CHUNK_SIZE) ? (pCLI->count - offset) : CLI_CHUNK_SIZE;
+
+        while (uuid_atomic_load_64(&pSlot->state) != CLI_SLOT_FREE) {
+            if (uuid_atomic_load_64(&pPipeline->isAborting)) {
+                goto done;
+            }
+
+            uuid_event_wait(&pWorker->event, 1);
+        }
+
+        pSlot->result = cli_generate(pCLI, pWorker->index, pWorker->pUUIDs, offset, count);
+        if (pSlot->result == UUID_SUCCESS) {
+            pSlot->size = cli_format_uuids(pSlot->pData, pWorker->pUUIDs, count, pCLI->format);
+        }
+
+        uuid_atomic_store_64(&pSlot->state, CLI_SLOT_READY);
+        uuid_event_signal(&pPipeline->event);
+    }
+
+done:
+    uuid_default_rng_shutdown();
+}
+
+static uuid_result cli_run_pipelined(cli* pCLI)
+{
+    cli_pipeline pipeline;
+    uuid_result result = UUID_SUCCESS;
+    size_t bufferSize = CLI_CHUNK_SIZE * cli_format_size(pCLI->format);
+    size_t chunkIndex;
+    unsigned int workerCount = 0;
+    unsigned int iWorker;
+
+    UUID_ZERO_OBJECT(&pipeline);
+    pipeline.pCLI       = pCLI;
+    pipeline.chunkCount = (pCLI->count + CLI_CHUNK_SIZE - 1) / CLI_CHUNK_SIZE;
+
+    pipeline.pWorkers = (cli_worker*)calloc(pCLI->threadCount, sizeof(*pipeline.pWorkers));
+    if (pipeline.pWorkers == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    if (uuid_event_init(&pipeline.event) != UUID_SUCCESS) {
+        free(pipeline.pWorkers);
+        return UUID_ERROR;
+    }
+
+    for (iWorker = 0; iWorker < pCLI->threadCount; iWorker += 1) {
+        cli_worker* pWorker = &pipeline.pWorkers[iWorker];
+
+        pWorker->pPipeline      = &pipeline;
+        pWorker->index          = iWorker;
+        pWorker->pUUIDs         = (unsigned char*)malloc(CLI_CHUNK_SIZE * UUID_SIZE);
+        pWorker->slots[0].pData = (char*)cli_aligned_malloc(bufferSize);
+        pWorker->slots[1].pData = (char*)cli_aligned_malloc(bufferSize);
+        if (pWorker->pUUIDs == NULL || pWorker->slots[0].pData == NULL || pWorker->slots[1].pData == NULL) {
+            result = UUID_OUT_OF_MEMORY;
+            break;
+        }
+
+        if (uuid_event_init(&pWorker->event) != UUID_SUCCESS) {
+            result = UUID_ERROR;
+            break;
+        }
+
+        if (uuid_thread_create(&pWorker->thread, cli_worker_entry, pWorker) != UUID_SUCCESS) {
+            uuid_event_uninit(&pWorker->event);
+            result = UUID_ERROR;
+            break;
+        }
+
+        workerCount += 1;
+    }
+
+    /* If not every worker could be started some chunks will never be generated. */
+    if (result != UUID_SUCCESS) {
+        uuid_atomic_exchange_64(&pipeline.isAborting, 1);
+    }
+
+    for (chunkIndex = 0; chunkIndex < pipeline.chunkCount && result == UUID_SUCCESS; chunkIndex += 1) {
+        cli_slot* pSlot = cli_pipeline_get_slot(&pipeline, chunkIndex);
+
+        while (uuid_atomic_load_64(&pSlot->state) != CLI_SLOT_READY) {
+            uuid_event_wait(&pipeline.event, 1);
+        }
+
+        result = pSlot->result;
+        if (result == UUID_SUCCESS) {
+            result = cli_write(pCLI, pSlot->pData, pSlot->size);
+        }
+
+        if (result != UUID_SUCCESS) {
+            uuid_atomic_exchange_64(&pipeline.isAborting, 1);
+        }
+
+        uuid_atomic_store_64(&pSlot->state, CLI_SLOT_FREE);
+        uuid_event_signal(&pipeline.pWorkers[chunkIndex % pCLI->threadCount].event);
+    }
+
+    for (iWorker = 0; iWorker < workerCount; iWorker += 1) {
+        uuid_thread_join(&pipeline.pWorkers[iWorker].thread);
+        uuid_event_uninit(&pipeline.pWorkers[iWorker].event);
+    }
+
+    for (iWorker = 0; iWorker < pCLI->threadCount; iWorker += 1) {
+        free(pipeline.pWorkers[iWorker].pUUIDs);
+        cli_aligned_free(pipeline.pWorkers[iWorker].slots[0].pData);
+        cli_aligned_free(pipeline.pWorkers[iWorker].slots[1].pData);
+    }
+
+    uuid_event_uninit(&pipeline.event);
+    free(pipeline.pWorkers);
+
+    return result;
+}
+#endif
+
+static uuid_result cli_run(cli* pCLI)
+{
+    unsigned char* pUUIDs;
+    char* pBuffer;
+    uuid_result result = UUID_SUCCESS;
+    size_t offset;
+
+    if (pCLI->count == 0) {
+        return UUID_SUCCESS;
+    }
+
+    if (pCLI->sort) {
+        return cli_run_sorted(pCLI);
+    }
+
+#if defined(UUID_SUPPORT_THREADS)
+    if (pCLI->threadCount > 1) {
+        return cli_run_pipelined(pCLI);
+    }
+#endif
+
+    pUUIDs  = (unsigned char*)malloc(CLI_CHUNK_SIZE * UUID_SIZE);
+    pBuffer = (char*)cli_aligned_malloc(CLI_CHUNK_SIZE * cli_format_size(pCLI->format));
+    if (pUUIDs == NULL || pBuffer == NULL) {
+        free(pUUIDs);
+        cli_aligned_free(pBuffer);
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    for (offset = 0; offset < pCLI->count && result == UUID_SUCCESS; offset += CLI_CHUNK_SIZE) {
+        size_t count = (pCLI->count - offset < CLI_CHUNK_SIZE) ? (pCLI->count - offset) : CLI_CHUNK_SIZE;
+
+        result = cli_generate(pCLI, 0, pUUIDs, offset, count);
+        if (result == UUID_SUCCESS) {
+            result = cli_write(pCLI, pBuffer, cli_format_uuids(pBuffer, pUUIDs, count, pCLI->format));
+        }
+    }
+
+    cli_aligned_free(pBuffer);
+    free(pUUIDs);
+
+    return result;
+}
+
+
+/* Reads the whole file and splits it into lines. An empty last line is not counted as a name. */
+static uuid_result cli_read_names(cli* pCLI, FILE* pFile)
+{
+    size_t dataSize = 0;
+    size_t dataCap = 1024*1024;
+    size_t nameCount = 0;
+    size_t lineBeg;
+    size_t i;
+
+    pCLI->pNameData = (char*)malloc(dataCap);
+    if (pCLI->pNameData == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    for (;;) {
+        size_t bytesRead;
+
+        if (dataSize == dataCap) {
+            char* pNewData = (char*)realloc(pCLI->pNameData, dataCap * 2);
+            if (pNewData == NULL) {
+                return UUID_OUT_OF_MEMORY;
+            }
+
+            pCLI->pNameData = pNewData;
+            dataCap *= 2;
+        }
+
+        bytesRead = fread(pCLI->pNameData + dataSize, 1, dataCap - dataSize, pFile);
+        if (bytesRead == 0) {
+            break;
+        }
+
+        dataSize += bytesRead;
+    }
+
+    for (i = 0; i < dataSize; i += 1) {
+        if (pCLI->pNameData[i] == '\n') {
+            nameCount += 1;
+        }
+    }
+
+    if (dataSize > 0 && pCLI->pNameData[dataSize - 1] != '\n') {
+        nameCount += 1;
+    }
+
+    pCLI->ppNames      = (const char**)malloc(sizeof(*pCLI->ppNames) * (nameCount + 1));
+    pCLI->pNameLengths = (size_t*)malloc(sizeof(*pCLI->pNameLengths) * (nameCount + 1));
+    if (pCLI->ppNames == NULL || pCLI->pNameLengths == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    pCLI->count = 0;
+    lineBeg = 0;
+    for (i = 0; i <= dataSize; i += 1) {
+        if (i == dataSize ? (i > lineBeg) : (pCLI->pNameData[i] == '\n')) {
+            size_t lineEnd = i;
+            if (lineEnd > lineBeg && pCLI->pNameData[lineEnd - 1] == '\r') {
+                lineEnd -= 1;
+            }
+
+            pCLI->ppNames[pCLI->count]      = pCLI->pNameData + lineBeg;
+            pCLI->pNameLengths[pCLI->count] = lineEnd - lineBeg;
+            pCLI->count += 1;
+
+            lineBeg = i + 1;
+        }
+    }
+
+    return UUID_SUCCESS;
+}
+
+static int cli_parse_namespace(const char* pArg, unsigned char* pNamespaceUUID)
+{
+    const char* pUUID = pArg;
+
+    if (strcmp(pArg, "dns") == 0) {
+        pUUID = "6ba7b810-9dad-11d1-80b4-00c04fd430c8";
+    } else if (strcmp(pArg, "url") == 0) {
+        pUUID = "6ba7b811-9dad-11d1-80b4-00c04fd430c8";
+    } else if (strcmp(pArg, "oid") == 0) {
+        pUUID = "6ba7b812-9dad-11d1-80b4-00c04fd430c8";
+    } else if (strcmp(pArg, "x500") == 0) {
+        pUUID = "6ba7b814-9dad-11d1-80b4-00c04fd430c8";
+    }
+
+    return uuid_parse(pNamespaceUUID, pUUID, strlen(pUUID)) == UUID_SUCCESS;
+}
+
+static int cli_parse_count(const char* pArg, size_t* pCount)
+{
+    size_t count = 0;
+
+    if (*pArg == '\0') {
+        return 0;
+    }
+
+    for (; *pArg != '\0'; pArg += 1) {
+        if (*pArg < '0' || *pArg > '9' || count > ((size_t)-1 - 9) / 10) {
+            return 0;
+        }
+
+        count = count*10 + (size_t)(*pArg - '0');
+    }
+
+    *pCount = count;
+    return 1;
+}
+
+static void cli_print_usage(void)
+{
+    fprintf(stderr, "Usage: uuid [options]\n");
+    fprintf(stderr, "  -v, --version <v>     1, 3, 4, 5, 6, 7 or ordered. Defaults to 4.\n");
+    fprintf(stderr, "  -n, --count <n>       Number of UUIDs to generate. Defaults to 1.\n");
+    fprintf(stderr, "  -f, --format <f>      canonical, dashless or binary. Defaults to canonical.\n");
+    fprintf(stderr, "  -t, --threads <n>     Number of threads to generate with. Defaults to 1.\n");
+    fprintf(stderr, "  -s, --sort            Sort the output.\n");
+    fprintf(stderr, "      --namespace <ns>  dns, url, oid, x500 or a UUID. Required for versions 3 and 5.\n");
+    fprintf(stderr, "  -o, --output <file>   Write to a file instead of stdout.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Versions 3 and 5 read names from stdin, one per line.\n");
+}
+
+int main(int argc, char** argv)
+{
+    cli c;
+    uuid_sharded_generator_config generatorConfig;
+    uuid_result result;
+    const char* pOutputPath = NULL;
+    int hasNamespace = 0;
+    int iArg;
+
+    UUID_ZERO_OBJECT(&c);
+    c.version     = CLI_UUID4;
+    c.format      = CLI_FORMAT_CANONICAL;
+    c.count       = 1;
+    c.threadCount = 1;
+
+    for (iArg = 1; iArg < argc; iArg += 1) {
+        const char* pArg = argv[iArg];
+        const char* pValue = (iArg + 1 < argc) ? argv[iArg + 1] : NULL;
+
+        if (strcmp(pArg, "-h") == 0 || strcmp(pArg, "--help") == 0) {
+            cli_print_usage();
+            return 0;
+        } else if (strcmp(pArg, "-s") == 0 || strcmp(pArg, "--sort") == 0) {
+            c.sort = 1;
+            continue;
+        }
+
+        if (pValue == NULL) {
+            cli_print_usage();
+            return 1;
+        }
+
+        if (strcmp(pArg, "-v") == 0 || strcmp(pArg, "--version") == 0) {
+            if      (strcmp(pValue, "1") == 0)       c.version = CLI_UUID1;
+            else if (strcmp(pValue, "3") == 0)       c.version = CLI_UUID3;
+            else if (strcmp(pValue, "4") == 0)       c.version = CLI_UUID4;
+            else if (strcmp(pValue, "5") == 0)       c.version = CLI_UUID5;
+            else if (strcmp(pValue, "6") == 0)       c.version = CLI_UUID6;
+            else if (strcmp(pValue, "7") == 0)       c.version = CLI_UUID7;
+            else if (strcmp(pValue, "ordered") == 0) c.version = CLI_UUID_ORDERED;
+            else {
+                fprintf(stderr, "Unsupported version: %s\n", pValue);
+                return 1;
+            }
+        } else if (strcmp(pArg, "-n") == 0 || strcmp(pArg, "--count") == 0) {
+            if (!cli_parse_count(pValue, &c.count)) {
+                fprintf(stderr, "Invalid count: %s\n", pValue);
+                return 1;
+            }
+        } else if (strcmp(pArg, "-f") == 0 || strcmp(pArg, "--format") == 0) {
+            if      (strcmp(pValue, "canonical") == 0) c.format = CLI_FORMAT_CANONICAL;
+            else if (strcmp(pValue, "dashless")  == 0) c.format = CLI_FORMAT_DASHLESS;
+            else if (strcmp(pValue, "binary")    == 0) c.format = CLI_FORMAT_BINARY;
+            else {
+                fprintf(stderr, "Unsupported format: %s\n", pValue);
+                return 1;
+            }
+        } else if (strcmp(pArg, "-t") == 0 || strcmp(pArg, "--threads") == 0) {
+            c.threadCount = (unsigned int)atoi(pValue);
+            if (c.threadCount < 1 || c.threadCount > CLI_MAX_THREAD_COUNT) {
+                fprintf(stderr, "Thread count must be between 1 and %d.\n", CLI_MAX_THREAD_COUNT);
+                return 1;
+            }
+        #if !defined(UUID_SUPPORT_THREADS)
+            if (c.threadCount > 1) {
+                fprintf(stderr, "This build does not support threads.\n");
+                return 1;
+            }
+        #endif
+        } else if (strcmp(pArg, "--namespace") == 0) {
+            if (!cli_parse_namespace(pValue, c.namespaceUUID)) {
+                fprintf(stderr, "Invalid namespace: %s\n", pValue);
+                return 1;
+            }
+            hasNamespace = 1;
+        } else if (strcmp(pArg, "-o") == 0 || strcmp(pArg, "--output") == 0) {
+            pOutputPath = pValue;
+        } else {
+            cli_print_usage();
+            return 1;
+        }
+
+        iArg += 1;
+    }
+
+    if (c.version == CLI_UUID3 || c.version == CLI_UUID5) {
+        if (!hasNamespace) {
+            fprintf(stderr, "Versions 3 and 5 need a namespace.\n");
+            return 1;
+        }
+
+        if (cli_read_names(&c, stdin) != UUID_SUCCESS) {
+            fprintf(stderr, "Failed to read names.\n");
+            return 1;
+        }
+    }
+
+    /* Sorting keeps everything in memory, which needs two copies of each UUID. */
+    if (c.sort && c.count > ((size_t)-1) / (UUID_SIZE * 2)) {
+        fprintf(stderr, "Too many UUIDs to sort. Sorting needs %d bytes of memory per UUID.\n", UUID_SIZE * 2);
+        return 1;
+    }
+
+    /* The shards are only used for the time-based versions. */
+    if (cli_is_time_based(c.version)) {
+        generatorConfig = uuid_sharded_generator_config_init(c.threadCount);
+        if (uuid_sharded_generator_init(&generatorConfig, &c.generator) != UUID_SUCCESS) {
+            fprintf(stderr, "Failed to initialize the generator.\n");
+            return 1;
+        }
+    }
+
+    if (pOutputPath != NULL) {
+        c.pOutput = fopen(pOutputPath, "wb");
+        if (c.pOutput == NULL) {
+            fprintf(stderr, "Failed to open %s.\n", pOutputPath);
+            return 1;
+        }
+    } else {
+        c.pOutput = stdout;
+    #if defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+    }
+
+    /* Everything is written in whole chunks so the stream doesn't need its own buffer. */
+    setvbuf(c.pOutput, NULL, _IONBF, 0);
+
+    result = cli_run(&c);
+    if (result == UUID_OUT_OF_MEMORY) {
+        fprintf(stderr, "Out of memory.\n");
+    } else if (result != UUID_SUCCESS) {
+        fprintf(stderr, "Failed to generate UUIDs.\n");
+    }
+
+    if (pOutputPath != NULL && fclose(c.pOutput) != 0 && result == UUID_SUCCESS) {
+        fprintf(stderr, "Failed to write %s.\n", pOutputPath);
+        result = UUID_ERROR;
+    }
+
+    if (cli_is_time_based(c.version)) {
+        uuid_sharded_generator_uninit(&c.generator);
+    }
+
+    free(c.ppNames);
+    free(c.pNameLengths);
+    free(c.pNameData);
+
+    return (result == UUID_SUCCESS) ? 0 : 1;
+}
@@ -5,9 +5,9 @@ David Reid - mackron@gmail.com
 */
 
 /*
-This supports all UUID versions defined in RFC 4122 except version 2. For version 3 and 5 you will
-need to provide your own MD5 and SHA-1 hashing implementation by defining the some macros before
-the implementation of this library. Below is an example:
+This supports all UUID versions defined in RFC 4122 except version 2, plus versions 6, 7 and 8 from
+RFC 9562. For version 3 and 5 you will need to provide your own MD5 and SHA-1 hashing implementation
+by defining the some macros before the implementation of this library. Below is an example:
 
     #define UUID_MD5_CTX_TYPE               md5_context
     #define UUID_MD5_INIT(ctx)              md5_init(ctx)
@@ -35,8 +35,19 @@ automatically be detected:
     #define UUID_IMPLEMENTATION
     #include "uuid.h"
 
-There is no need to link to anything with this library. You can use UUID_IMPLEMENTATION to define
-the implementation section, or you can use uuid.c if you prefer a traditional header/source pair.
+On Windows there is no need to link to anything. On POSIX platforms the implementation uses
+pthreads for fork detection, for releasing the default random number generator when a thread exits
+and for the threads used by `uuid_sort_mt()` and `uuid_pool`, so you may need to link with
+`-lpthread`. Define `UUID_NO_FORK_DETECTION`, `UUID_NO_THREAD_EXIT_CALLBACK` and `UUID_NO_THREADS`
+to remove the dependency. You can use UUID_IMPLEMENTATION to define the implementation section, or
+you can use uuid.c if you prefer a traditional header/source pair.
+
+For C++20 there is a header-only wrapper in uuid.hpp. It has a `uuids::uuid` value type which can be
+compared, hashed, formatted with `std::format()` and used as a key in standard containers, as well as
+RAII wrappers for the random number generators and `uuid_generator`. See the top of uuid.hpp.
+
+There is also a command line tool in tools/uuid_cli.c for generating UUIDs in bulk, such as for test
+fixtures and database loads. See the top of that file for usage.
 
 Use the following APIs to generate a UUID:
 
@@ -44,10 +55,163 @@ Use the following APIs to generate a UUID:
     uuid3(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
     uuid4(unsigned char* pUUID, uuid_rand* pRNG);
     uuid5(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
+    uuid6(unsigned char* pUUID, uuid_rand* pRNG);
+    uuid7(unsigned char* pUUID, uuid_rand* pRNG);
+    uuid8(unsigned char* pUUID, const unsigned char* pCustomData);
     uuid_ordered(unsigned char* pUUID, uuid_rand* pRNG);
 
-If you want to use a time-based ordered UUID you can use `uuid_ordered()`. Note that this is not
-officially allowed by RFC 4122. This does not encode a version as it would break ordering.
+If you want a time-based UUID that is sorted by time, use `uuid7()` or `uuid6()`. Version 7 is the
+Unix time in milliseconds followed by random data, with the 12 bits after the version used for the
+sub-millisecond part of the time so that UUIDs within the same millisecond are also sorted. Version 6
+is the same as version 1, but with the timestamp stored most significant bits first. For version 8
+you provide 16 bytes of your own data and only the version and variant bits will be overwritten.
+
+Before version 6 and 7 were standardized, `uuid_ordered()` was the way to get time-ordered UUIDs. It
+is similar to version 6 but does not encode a version as it would break ordering. This is not
+officially allowed by RFC 4122 and is kept for compatibility. Prefer version 7 for new code.
+
+If you are generating a lot of version 3 or 5 UUIDs under the same namespace, you can use a
+`uuid_namespace` to hash the namespace once up front. The name is passed in with an explicit length,
+or `(size_t)-1` if it's null terminated:
+
+    uuid_namespace ns;
+    uuid_namespace_init(pNamespaceUUID, &ns);
+
+    uuid5_ns(uuid, &ns, pName, nameLen);
+    uuid3_ns(uuid, &ns, pName, nameLen);
+
+The hashing context is copied for each UUID so the namespace can be shared between threads. This
+requires that the context can be copied with a plain memory copy which is the case for the default
+MD5 and SHA-1 implementations. The context is stored inside the `uuid_namespace` object and must fit
+within `UUID_NAMESPACE_CTX_SIZE` bytes, which defaults to 256. If your context type is bigger you'll
+need to define this before including this file, in both the header and implementation.
+
+For hashing a large number of names under the same namespace, use the batch versions:
+
+    uuid3_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths);
+    uuid5_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths);
+
+These use their own MD5 and SHA-1 implementation which hashes several names in parallel, 4 at a time
+with SSE2 or 8 at a time with AVX2, and therefore work even when the hashing macros above are not
+defined. The output is identical to `uuid3()` and `uuid5()`. Set `pNameLengths` to NULL if the names
+are null terminated. If the CPU supports the SHA extensions, `uuid5()` and `uuid5_ns()` will also use
+them instead of the hashing macros. If the SHA-1 macros are not defined, `uuid5()` and `uuid5_ns()`
+use the built-in SHA-1 rather than failing, so only version 3 strictly needs a hashing implementation
+to be provided. See below for how the implementation is selected.
+
+Two time-based UUIDs generated in the same clock tick have no defined order relative to each other,
+and neither do UUIDs generated either side of the clock going backwards. If you need strictly
+increasing UUIDs, use a `uuid_generator`:
+
+    uuid_generator generator;
+    uuid_generator_init(NULL, NULL, &generator);   // NULL = default random number generator and clock.
+
+    uuid_generator_uuid7(&generator, uuid);
+    uuid_generator_uuid6(&generator, uuid);
+    uuid_generator_uuid1(&generator, uuid);
+    uuid_generator_ordered(&generator, uuid);
+
+    uuid_generator_uninit(&generator);
+
+Each UUID from a generator will have a timestamp greater than the previous one, even when called from
+multiple threads at the same time. If more than one UUID is requested in the same tick, the timestamp
+is advanced by one tick as if it were a counter. The clock sequence and node ID are generated once
+when the generator is initialized, so no random numbers are needed for versions 1 and 6 and ordered
+UUIDs. If the clock goes backwards the clock sequence is incremented as described in RFC 4122. For
+version 7 the 12 bits after the version are used as a counter within each millisecond, carrying over
+into the millisecond if it overflows, and the last 62 bits are random for each UUID. The random number
+generator passed to `uuid_generator_init()` is kept for this, so it must outlive the generator.
+
+The second parameter of `uuid_generator_init()` is the clock. Like random number generators, you can
+implement your own clock by inheriting from `uuid_clock_callbacks`, which returns the time in
+nanoseconds since the Unix epoch. The functions that don't take a generator, such as `uuid7()`,
+always use the default clock. There are some built-in clocks:
+
+    uuid_clock_coarse    Uses CLOCK_REALTIME_COARSE on Linux. Much cheaper, but lower resolution.
+    uuid_clock_tsc       Uses the CPU's time stamp counter, anchored to the default clock. Requires
+                         an invariant TSC. Use `uuid_clock_tsc_anchor()` periodically to fix drift.
+    uuid_clock_cached    Only changes when you call `uuid_clock_cached_update()`, which is useful for
+                         using one timestamp for a whole batch. You can also use this as a fake clock
+                         for testing with `uuid_clock_cached_set()` and `uuid_clock_cached_advance()`.
+
+Example:
+
+    uuid_clock_cached clock;
+    uuid_clock_cached_init(NULL, &clock);   // NULL = the source is the default clock.
+
+    uuid_generator generator;
+    uuid_generator_init(NULL, &clock, &generator);
+
+    for (;;) {
+        uuid_clock_cached_update(&clock);   // <-- Read the clock once per batch.
+
+        for (i = 0; i < batchSize; i += 1) {
+            uuid_generator_uuid7(&generator, uuid);
+        }
+    }
+
+The generator still guarantees ordering when the clock doesn't change between UUIDs.
+
+A `uuid_generator` is shared between threads with atomics, which becomes a bottleneck when many
+threads are generating UUIDs at the same time. In this case you can use a `uuid_sharded_generator`
+which has a separate shard for each thread:
+
+    uuid_sharded_generator_config config = uuid_sharded_generator_config_init(threadCount);
+    uuid_sharded_generator generator;
+    uuid_sharded_generator_init(&config, &generator);
+
+    // On each thread.
+    uuid_shard* pShard = uuid_sharded_generator_get_shard(&generator, threadIndex);
+    uuid_shard_uuid7(pShard, uuid);
+
+Each shard is aligned to a cache line and has its own timestamp and ChaCha20 random number generator
+so there is no shared state between threads. A shard must only be used by one thread at a time. The
+shard index is stored in the bits after the variant, which for versions 1 and 6 and ordered UUIDs is
+the clock sequence. This means UUIDs from different shards are never the same. UUIDs from the same
+shard are strictly increasing, but UUIDs from different shards are only ordered by their time. Unlike
+`uuid_generator`, version 7 UUIDs from a shard have random data after the shard index. Up to
+`UUID_SHARD_MAX_COUNT` (4096) shards are supported.
+
+If you need to generate a lot of UUIDs at once you can use the batch versions which take the number
+of UUIDs to generate. The output buffer must be at least `count * UUID_SIZE` bytes:
+
+    uuid1_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+    uuid4_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+    uuid6_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+    uuid7_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+    uuid_ordered_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+
+These make a single request to the random number generator for the whole batch rather than one per
+UUID. For the time-based versions the clock is read once and the timestamp is then incremented by
+one tick for each UUID, carrying on from the previous batch, so the UUIDs from the batch functions
+are strictly increasing within the process. For version 7 the 12 bits after the version are used as
+the counter. If you generate more than one UUID per tick on average, the timestamps will run ahead of
+the clock until it catches up.
+
+If you need UUIDs with low and predictable latency you can use a `uuid_pool`. This starts one or
+more producer threads which generate UUIDs in batches and store them in a lock-free ring buffer:
+
+    uuid_pool_config config = uuid_pool_config_init();
+    config.onGenerate = uuid7_batch;    // <-- Defaults to uuid4_batch().
+
+    uuid_pool pool;
+    uuid_pool_init(&config, &pool);
+
+    uuid_pool_pop(&pool, uuid);         // <-- Can be called from any thread.
+
+    uuid_pool_uninit(&pool);
+
+`uuid_pool_pop()` never waits. If the ring buffer is empty the UUID is generated on the calling
+thread instead. The producers refill the ring buffer when it drops below `lowWatermark`, which
+defaults to half of `capacity`. The capacity must be a power of two. For time-based UUIDs you can
+set `maxAgeInMilliseconds` to stop UUIDs with an old timestamp from being returned. Note that this
+relies on the producer threads being scheduled regularly. If you set a random number generator in
+the config, each producer thread seeds its own ChaCha20 generator from it, and `uuid_pool_pop()`
+uses it directly when the ring buffer is empty. It is only ever called by one thread at a time, so
+it doesn't need to be thread-safe. Leave it as NULL to use the default generator, which is
+thread-local. UUIDs are not guaranteed to be popped in the order they were generated. This is not
+available when threads are disabled with `UUID_NO_THREADS`, in which case `uuid_pool_init()` will
+return `UUID_NOT_IMPLEMENTED`.
 
 Use the following APIs to format the UUID as a string:
 
@@ -56,6 +220,143 @@ Use the following APIs to format the UUID as a string:
 The size of the UUID buffer must be at least `UUID_SIZE` (16 bytes). For formatted strings the
 destination buffer should be at least `UUID_SIZE_FORMATTED`.
 
+Use the following APIs to parse a UUID string:
+
+    uuid_parse(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+    uuid_validate(const char* pSrc, size_t srcLen);
+
+The following formats are accepted, in upper or lower case:
+
+    xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+    {xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx}
+    urn:uuid:xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+    xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+
+Set `srcLen` to `(size_t)-1` if the string is null terminated. Malformed input will return
+`UUID_INVALID_DATA`. To parse many UUIDs at once, use `uuid_parse_batch()`. With a stride of 0 the
+input is parsed line by line, otherwise each UUID is expected to be exactly `stride` bytes apart, with
+any trailing null terminators or new lines ignored. This is the inverse of `uuid_format_batch()`.
+
+To format an array of UUIDs in one go, use `uuid_format_batch()`:
+
+    uuid_format_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count);
+
+Each string is written `stride` bytes after the previous one. The stride must be at least 36. If
+it's at least `UUID_SIZE_FORMATTED` each string will be null terminated, otherwise they will be
+packed together without a null terminator which is useful for writing directly into an output
+buffer. Formatting uses SSE2, SSSE3 or AVX2 when available.
+
+For shorter strings, such as in URLs, there are three compact encodings:
+
+    uuid_format_base32(char* dst, size_t dstCap, const unsigned char* pUUID);
+    uuid_format_base58(char* dst, size_t dstCap, const unsigned char* pUUID);
+    uuid_format_base64url(char* dst, size_t dstCap, const unsigned char* pUUID);
+
+Base32 uses the Crockford alphabet and is 26 characters. It's the same encoding as ULID so a version 7
+UUID can be used in place of a ULID. Base58 uses the Bitcoin alphabet and is 22 characters, padded with
+leading '1' characters. Both of these sort in the same order as the UUID so they work well for version
+6, 7 and ordered UUIDs. Base64url is 22 characters and is not padded with '='. It does not sort in the
+same order as the UUID. Use `UUID_SIZE_BASE32`, `UUID_SIZE_BASE58` and `UUID_SIZE_BASE64URL` for the
+size of the buffer, which includes the null terminator. Each has a parse function, such as
+`uuid_parse_base32()`, as well as batch versions which work the same way as `uuid_format_batch()` and
+`uuid_parse_batch()`. Parsing is strict: the string must be the exact length and anything that would
+not be output by the format function is rejected with `UUID_INVALID_DATA`. The only exception is that
+base32 is case-insensitive.
+
+Use the following APIs to compare and hash UUIDs:
+
+    uuid_equal(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+    uuid_compare(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+    uuid_is_nil(const unsigned char* pUUID)
+    uuid_hash(const unsigned char* pUUID, uuid_uint64 seed)
+
+`uuid_compare()` orders UUIDs by their bytes, the same as `memcmp()`. For version 6, 7 and ordered
+UUIDs this is the order in which they were generated. `uuid_hash()` returns a 64-bit hash that is
+suitable for hash tables, including those that only use the low bits. Use a random seed if the UUIDs
+can come from an untrusted source. There are also batch versions which work on arrays of UUIDs:
+`uuid_equal_batch()`, `uuid_compare_batch()` and `uuid_hash_batch()`. These are not cryptographic.
+
+The functions above are compiled with the implementation, so each call is a real function call. For
+hot loops such as sort comparators there are `uuid_equal_inline()`, `uuid_compare_inline()` and
+`uuid_hash_inline()` which give the same results but are defined in the header so they can be
+inlined anywhere.
+
+For storing large numbers of UUIDs there is a hash set and a hash map, `uuid_set` and `uuid_map`.
+Keys are stored inline in the table and looked up 16 at a time using SIMD. Example:
+
+    uuid_set_config setConfig = uuid_set_config_init();
+    setConfig.initialCapacity = 1000000;
+
+    uuid_set set;
+    uuid_set_init(&setConfig, &set);
+
+    uuid_set_insert(&set, uuid);            // Returns UUID_ALREADY_EXISTS if it's already in the set.
+    if (uuid_set_contains(&set, uuid)) {
+        ...
+    }
+
+    uuid_set_uninit(&set);
+
+A map is the same, except values of a fixed size are stored alongside the keys. The size is passed
+into `uuid_map_config_init()`. `uuid_map_insert()` and `uuid_map_find()` output a pointer to the value
+inside the table which can be modified in place. This pointer is invalidated when the map grows. For
+large tables, use `uuid_set_insert_batch()`, `uuid_set_contains_batch()`, `uuid_map_insert_batch()` and
+`uuid_map_find_batch()` which prefetch ahead to hide cache misses. These are much faster than a loop.
+
+The table grows by doubling when it becomes 7/8 full. Use `uuid_set_reserve()` or `uuid_map_reserve()`,
+or the `initialCapacity` config option, to avoid rehashing when the number of items is known in
+advance. If all keys are version 4 or 7 UUIDs from a trusted source, set the `flags` config option to
+`UUID_MAP_FLAG_RANDOM_KEYS` to skip the hash function and use the random bits of the UUID directly.
+Memory is allocated with `malloc()` unless `allocationCallbacks` is set.
+
+Arrays of UUIDs can be sorted with `uuid_sort()`, which orders them the same as `uuid_compare()`:
+
+    uuid_sort(uuids, count, NULL);
+
+This is a radix sort which skips any bytes that are the same in every UUID, such as the version and
+variant bits, and falls back to an insertion sort for small buckets. It needs a scratch buffer of
+`count * UUID_SIZE` bytes which can be passed in as the last parameter. If it's NULL, it'll be allocated
+with `malloc()`. Arrays which are already sorted, or which start with a long sorted run such as a set of
+version 7 UUIDs with some new ones appended, are detected and only the unsorted part is sorted before
+being merged in. Use `uuid_sort_mt()` to split the work across multiple threads. Threads are created
+with Win32 or pthread. Use `UUID_NO_THREADS` to disable them, in which case `uuid_sort_mt()` runs on the
+calling thread. To combine multiple arrays that are already sorted, use `uuid_merge()`.
+
+Time-ordered UUIDs can be compressed for storage with `uuid_column_encode()`:
+
+    size_t encodedSize;
+    size_t encodedCap = uuid_column_encode_bound(count, UUID_COLUMN_DEFAULT_BLOCK_SIZE);
+    void* pEncoded = malloc(encodedCap);
+    uuid_column_encode(pEncoded, encodedCap, uuids, count, UUID_COLUMN_DEFAULT_BLOCK_SIZE, &encodedSize);
+    ...
+    uuid_column_decode(uuids, count, pEncoded, encodedSize, &count);
+
+The first 8 bytes of each UUID contain the timestamp for versions 1, 6 and 7 and ordered UUIDs. These
+are stored as the difference from the previous UUID, which for UUIDs that were generated one after the
+other is usually a single byte. The remaining 8 bytes are random and are stored as-is, so a run of
+time-ordered UUIDs will compress to a little over 9 bytes each. Version 4 UUIDs will not compress. The
+UUIDs are split into blocks so that any UUID can be found without decoding everything before it. Use
+`uuid_column_decoder` to decode a piece at a time, seek with `uuid_column_decoder_seek()`, or decode
+only the first 8 bytes of each UUID with `uuid_column_decoder_read_heads()` which is faster when only
+the time is needed. The data is the same on all platforms.
+
+The SIMD implementations of hashing, formatting and batch generation are selected at runtime. The
+first time one is needed the CPU is queried with CPUID and the best implementation for each job is
+picked from SSE2, SSSE3, AVX2 and the SHA extensions. This works without needing to compile with
+`-mavx2` or similar on GCC 4.9+, Clang 3.8+ and MSVC 2015+. On other compilers, or with
+`UUID_NO_RUNTIME_DISPATCH`, only what the compiler is targeting will be used. Individual instruction
+sets can be excluded at compile time with `UUID_NO_SSE2`, `UUID_NO_SSSE3`, `UUID_NO_AVX2` and
+`UUID_NO_SHA`. Use the following APIs to query or restrict the implementation at runtime:
+
+    uuid_get_cpu_features()
+    uuid_set_cpu_features(uuid_uint32 features)
+
+The features are a combination of `UUID_CPU_FEATURE_SSE2`, `UUID_CPU_FEATURE_SSSE3`,
+`UUID_CPU_FEATURE_AVX2` and `UUID_CPU_FEATURE_SHA`. `uuid_set_cpu_features()` will only enable features
+that are supported by the CPU and returns the ones that are now active. Pass in 0 to use the portable
+implementations only, or `UUID_CPU_FEATURE_ALL` to go back to the default. This is intended for
+testing and benchmarking and is not thread-safe.
+
 Example:
 
     unsigned char uuid[UUID_SIZE];
@@ -69,6 +370,16 @@ want to use your own random number generator, you can pass in a random number ge
 
     uuid4(uuid, &myRNG);
 
+The default random number generator is initialized on first use and then reused for the lifetime of
+the thread, so passing in NULL is just as fast as passing in a long-lived generator. Each thread's
+instance is released automatically when the thread exits, using a pthread key destructor on POSIX
+and a fiber local storage callback on Windows Vista and newer. You can also release it early by
+calling `uuid_default_rng_shutdown()`. On other platforms, or if you define
+`UUID_NO_THREAD_EXIT_CALLBACK`, threads must call `uuid_default_rng_shutdown()` before they exit or
+the file descriptor or handle held by cryptorand will be leaked. If thread local storage is not
+supported by your compiler, or you define `UUID_NO_THREAD_LOCAL`, the default generator will instead
+be initialized and uninitialized with each call.
+
 The default random number generator is cryptorand: https://github.com/mackron/cryptorand. If you
 have access to the implementation section, you can make use of this easily:
 
@@ -109,9 +420,76 @@ Alternatively you can implement your own random number generator by inheritting
     // Generate your GUID.
     uuid4(uuid, &myRNG);
 
+If your random number generator is expensive to call, such as one that makes a system call each
+time, you can wrap it with `uuid_rand_buffered`. This requests random data in large chunks and then
+serves smaller requests from a pool which you provide:
+
+    unsigned char pool[16384];
+    uuid_rand_buffered bufferedRNG;
+    uuid_rand_buffered_init(&myRNG, pool, sizeof(pool), &bufferedRNG);
+
+    uuid4(uuid, &bufferedRNG);
+
+    uuid_rand_buffered_uninit(&bufferedRNG);
+
+The bigger the pool, the fewer calls to the upstream generator. Bytes are wiped from the pool as they
+are consumed. Use `uuid_rand_buffered_flush()` to discard any remaining bytes so that the next request
+pulls in fresh data. Passing in NULL for the upstream generator will use the default generator. Like
+all random number generators in this library, it is not thread-safe.
+
+For very high generation rates there is a userspace ChaCha20 generator, `uuid_chacha_rng`, which is
+seeded from another generator (the default generator if NULL) and then produces random data without
+going to the operating system:
+
+    uuid_chacha_rng_config rngConfig = uuid_chacha_rng_config_init(NULL);
+    rngConfig.reseedIntervalInBytes = 1024 * 1024;
+
+    uuid_chacha_rng rng;
+    uuid_chacha_rng_init(&rngConfig, &rng);
+
+    uuid4(uuid, &rng);
+
+    uuid_chacha_rng_uninit(&rng);
+
+It will reseed itself after `reseedIntervalInBytes` bytes or `reseedIntervalInMilliseconds`
+milliseconds, whichever comes first. Set either to 0 to disable that policy. You can also reseed
+manually with `uuid_chacha_rng_reseed()`. The key is replaced with fresh keystream after each internal
+refill so that previous output cannot be recovered from the current state.
+
+Both `uuid_chacha_rng` and `uuid_rand_buffered` keep random data in memory. On POSIX platforms they
+detect when the process has been forked with `pthread_atfork()` and will reseed or flush in the child
+so that it never returns the same data as the parent. You may need to link with `-lpthread` for this.
+You can disable this with `UUID_NO_FORK_DETECTION`, in which case you must do this yourself.
+
+On Linux the default random number generator will use `getrandom()` directly rather than going
+through cryptorand. This avoids the need for a file descriptor, and with glibc 2.41+ on kernel 6.11+
+it is serviced by the vDSO without a system call. If the running kernel does not support it, it will
+fall back to cryptorand. You can disable this with `UUID_NO_GETRANDOM`. Use
+`uuid_default_rng_backend()` to find out which backend is being used by the default generator.
+
 You can disable cryptorand and compile time with `UUID_NO_CRYPTORAND`, but by doing so you will be
-required to specify your own random number generator. This is useful if you already have a good
-quality random number generator in your code base and want to save a little bit of space.
+required to specify your own random number generator, unless `getrandom()` is available. This is
+useful if you already have a good quality random number generator in your code base and want to save
+a little bit of space.
+
+To see what the library is doing at run time, define `UUID_ENABLE_STATS`. This counts calls to the
+random number generator and the bytes requested, clock reads, cryptorand initializations, and
+time-based UUIDs that got the same clock reading as the one before:
+
+    uuid_stats stats;
+    uuid_get_stats(&stats);
+    printf("%llu RNG calls\n", stats.rngCallCount);
+
+    uuid_reset_stats();
+
+Each thread has its own counters which are only added together by `uuid_get_stats()`, so there's no
+contention between threads. When a thread calls `uuid_default_rng_shutdown()` before it exits, its
+counters are taken over by the next new thread instead of allocating new ones. You can also install a
+hook with `uuid_set_stats_hook()`, which is called with the time taken by every call to the random
+number generator and every clock read. This is useful for sending to your metrics system. The hook
+should be set before any UUIDs are generated because it's not thread-safe. The time is only measured
+when a hook is installed. When `UUID_ENABLE_STATS` is not defined, none of this is compiled in,
+`uuid_get_stats()` returns `UUID_NOT_IMPLEMENTED`, and the other two functions do nothing.
 */
 #ifndef uuid_h
 #define uuid_h
@@ -126,8 +504,19 @@ extern "C" {
     #define UUID_API
 #endif
 
+typedef unsigned short         uuid_uint16;
+typedef unsigned int           uuid_uint32;
+#if defined(_MSC_VER)
+    typedef unsigned __int64   uuid_uint64;
+#else
+    typedef unsigned long long uuid_uint64;
+#endif
+
 #define UUID_SIZE           16
 #define UUID_SIZE_FORMATTED 37
+#define UUID_SIZE_BASE32    27
+#define UUID_SIZE_BASE58    23
+#define UUID_SIZE_BASE64URL 23
 
 typedef enum
 {
@@ -135,7 +524,11 @@ typedef enum
     UUID_ERROR             = -1,
     UUID_INVALID_ARGS      = -2,
     UUID_INVALID_OPERATION = -3,
-    UUID_NOT_IMPLEMENTED   = -29
+    UUID_OUT_OF_MEMORY     = -4,
+    UUID_DOES_NOT_EXIST    = -7,
+    UUID_ALREADY_EXISTS    = -8,
+    UUID_NOT_IMPLEMENTED   = -29,
+    UUID_INVALID_DATA      = -33
 } uuid_result;
 
 typedef void uuid_rand;
@@ -146,622 +539,8178 @@ typedef struct
 
 UUID_API uuid_result uuid_rand_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount);
 
+/*
+Clocks. Time is in nanoseconds since the Unix epoch. Pass NULL into uuid_clock_get_time() for the
+default clock which uses timespec_get(), clock_gettime() or gettimeofday() depending on the platform.
+*/
+typedef void uuid_clock;
+typedef struct
+{
+    uuid_result (* onGetTime)(uuid_clock* pClock, uuid_uint64* pTime);
+} uuid_clock_callbacks;
+
+UUID_API uuid_result uuid_clock_get_time(uuid_clock* pClock, uuid_uint64* pTime);
 
-/* Generation. */
-UUID_API uuid_result uuid1(unsigned char* pUUID, uuid_rand* pRNG);
-UUID_API uuid_result uuid3(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
-UUID_API uuid_result uuid4(unsigned char* pUUID, uuid_rand* pRNG);
-UUID_API uuid_result uuid5(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
-UUID_API uuid_result uuid_ordered(unsigned char* pUUID, uuid_rand* pRNG);
+/* A low resolution clock that is cheaper to read. Uses CLOCK_REALTIME_COARSE on Linux and falls back to the default clock elsewhere. */
+typedef struct
+{
+    uuid_clock_callbacks base;
+} uuid_clock_coarse;
 
-/* Formatting. */
-UUID_API uuid_result uuid_format(char* dst, size_t dstCap, const unsigned char* pUUID);
+UUID_API uuid_result uuid_clock_coarse_init(uuid_clock_coarse* pClock);
 
-#ifdef __cplusplus
-}
-#endif
-#endif  /* uuid_h */
+/*
+A clock based on the CPU's time stamp counter, anchored to the default clock. Only available on x86
+with an invariant TSC. Call uuid_clock_tsc_anchor() periodically to correct for drift. This can be
+done while other threads are reading the clock. uuid_clock_tsc_init() measures the rate of the TSC
+by spinning on the default clock for 10 milliseconds, so initialize it once up front rather than on
+a hot path.
+*/
+typedef struct
+{
+    uuid_clock_callbacks base;
+    volatile uuid_uint64 sequence;      /* Odd while uuid_clock_tsc_anchor() is updating the fields below. */
+    volatile uuid_uint64 anchorTime;
+    volatile uuid_uint64 anchorTicks;
+    volatile uuid_uint64 nanosecondsPerTick;    /* 32.32 fixed point. */
+} uuid_clock_tsc;
 
-#if defined(UUID_IMPLEMENTATION)
-#ifndef uuid_c
-#define uuid_c
+UUID_API uuid_result uuid_clock_tsc_init(uuid_clock_tsc* pClock);
+UUID_API uuid_result uuid_clock_tsc_anchor(uuid_clock_tsc* pClock);
 
-typedef unsigned short         uuid_uint16;
-typedef unsigned int           uuid_uint32;
-#if defined(_MSC_VER)
-    typedef unsigned __int64   uuid_uint64;
-#else
-    typedef unsigned long long uuid_uint64;
-#endif
+/*
+A clock that only changes when told to. Use uuid_clock_cached_update() to refresh it from its source
+clock, such as once per batch, or uuid_clock_cached_set() and uuid_clock_cached_advance() to use it as
+a deterministic clock for testing.
+*/
+typedef struct
+{
+    uuid_clock_callbacks base;
+    uuid_clock* pSource;
+    volatile uuid_uint64 time;
+} uuid_clock_cached;
 
-#include <string.h>
-#define UUID_COPY_MEMORY(dst, src, sz)  memcpy((dst), (src), (sz))
-#define UUID_ZERO_MEMORY(p, sz)         memset((p), 0, (sz))
-#define UUID_ZERO_OBJECT(o)             UUID_ZERO_MEMORY((o), sizeof(*o))
+UUID_API uuid_result uuid_clock_cached_init(uuid_clock* pSource, uuid_clock_cached* pClock);
+UUID_API uuid_result uuid_clock_cached_update(uuid_clock_cached* pClock);
+UUID_API void uuid_clock_cached_set(uuid_clock_cached* pClock, uuid_uint64 time);
+UUID_API void uuid_clock_cached_advance(uuid_clock_cached* pClock, uuid_uint64 nanoseconds);
 
-#ifndef UUID_ASSERT
-    #include <assert.h>
-    #define UUID_ASSERT(condition)  assert(condition)
-#endif
 
-#include <time.h>   /* For timespec. */
+typedef enum
+{
+    UUID_RNG_BACKEND_NONE       = 0,
+    UUID_RNG_BACKEND_CRYPTORAND = 1,
+    UUID_RNG_BACKEND_GETRANDOM  = 2     /* Linux only. Serviced by the vDSO with glibc 2.41+ and kernel 6.11+. */
+} uuid_rng_backend;
+
+UUID_API void uuid_default_rng_shutdown(void);
+UUID_API uuid_rng_backend uuid_default_rng_backend(void);
 
-#ifndef TIME_UTC
-#define TIME_UTC    1
-#endif
 
 /*
-We use `timespec` as the bridge for the cross-platform part of time retrieval. The annoying thing
-about this is that support varies depending on the age of the compiler. Since we're not exposing
-any of our timing functions publicly, the easiest way is to just define our own timespec-compatible
-struct and convert between the standard version and our version, depending on the compiler.
+Statistics. These are only collected when UUID_ENABLE_STATS is defined. Otherwise uuid_get_stats()
+returns UUID_NOT_IMPLEMENTED and nothing is added to the generation path. Counters are kept per
+thread and added together in uuid_get_stats().
 */
-#if 1
-    struct uuid_timespec
-    {
-        time_t tv_sec;
-        long tv_nsec;
-    };
-#else
-    #if (defined(_MSC_VER) && _MSC_VER < 1900) || defined(__DMC__) || (defined(_XOPEN_SOURCE) && _XOPEN_SOURCE < 500) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE < 199309L) || defined(__STRICT_ANSI__)  /* 1900 = Visual Studio 2015 */
-    struct uuid_timespec
-    {
-        time_t tv_sec;
-        long tv_nsec;
-    };
-    #else
-    #define uuid_timespec timespec
-    #endif
-#endif
+typedef struct
+{
+    uuid_uint64 rngCallCount;           /* Calls to uuid_rand_generate(). A generator that wraps another one, such as uuid_rand_buffered, counts both. */
+    uuid_uint64 rngByteCount;
+    uuid_uint64 clockReadCount;         /* Clock reads by the library. Mostly for time-based UUIDs, but also for time-based reseeding. */
+    uuid_uint64 cryptorandInitCount;
+    uuid_uint64 cryptorandUninitCount;
+    uuid_uint64 sameTickCount;          /* Time-based UUIDs that got the same clock reading as the previous one and had to rely on the counter or random data. */
+} uuid_stats;
 
+typedef enum
+{
+    UUID_STATS_EVENT_RNG,               /* uuid_rand_generate(). */
+    UUID_STATS_EVENT_CLOCK              /* Reading the clock for a time-based UUID. */
+} uuid_stats_event;
 
-/* Define default MD5 and SHA-1 implementations if available. */
-#if !defined(UUID_MD5_CTX_TYPE)
-    #if defined(md5_h) && defined(MD5_SIZE) && defined(MD5_SIZE_FORMATTED)  /* <-- Is this enough to detect our default MD5 implementation reliably? */
-        #define UUID_MD5_CTX_TYPE               md5_context
-        #define UUID_MD5_INIT(ctx)              md5_init(ctx)
-        #define UUID_MD5_FINAL(ctx, digest)     md5_finalize(ctx, (unsigned char*)(digest))
-        #define UUID_MD5_UPDATE(ctx, src, sz)   md5_update(ctx, src, (size_t)(sz))
-    #endif
-#endif
+typedef void (* uuid_stats_hook_proc)(void* pUserData, uuid_stats_event event, uuid_uint64 durationInNanoseconds, size_t byteCount);
 
-#if !defined(UUID_SHA1_CTX_TYPE)
-    #if defined(sha1_h) && defined(SHA1_SIZE) && defined(SHA1_SIZE_FORMATTED) /* <-- Is this enough to detect our default SHA-1 implementation reliably? */
-        #define UUID_SHA1_CTX_TYPE              sha1_context
-        #define UUID_SHA1_INIT(ctx)             sha1_init(ctx)
-        #define UUID_SHA1_FINAL(ctx, digest)    sha1_finalize(ctx, (unsigned char*)(digest))
-        #define UUID_SHA1_UPDATE(ctx, src, sz)  sha1_update(ctx, src, (size_t)(sz));
-    #endif
-#endif
+UUID_API uuid_result uuid_get_stats(uuid_stats* pStats);
+UUID_API void uuid_reset_stats(void);
+UUID_API void uuid_set_stats_hook(uuid_stats_hook_proc onEvent, void* pUserData);
 
 
-UUID_API uuid_result uuid_rand_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+/*
+Buffered random number generator. This wraps another random number generator and requests random
+data from it in large chunks, serving smaller requests out of the pool. Bytes are wiped from the pool
+as they are consumed. The pool memory is owned by the caller and must remain valid until the buffered
+generator is uninitialized. If pUpstream is NULL the default random number generator is used.
+*/
+typedef struct
 {
-    uuid_rand_callbacks* pCallbacks = (uuid_rand_callbacks*)pRNG;
-
-    if (pBufferOut == NULL) {
-        return UUID_INVALID_ARGS;
-    }
-
-    UUID_ZERO_MEMORY(pBufferOut, byteCount);
-
-    if (pCallbacks == NULL || pCallbacks->onGenerate == NULL) {
-        return UUID_INVALID_ARGS;
-    }
+    uuid_rand_callbacks base;
+    uuid_rand* pUpstream;
+    unsigned char* pPool;
+    size_t poolSize;
+    size_t cursor;      /* The number of bytes in the pool that have already been consumed. */
+    uuid_uint32 forkGeneration;
+} uuid_rand_buffered;
 
-    return pCallbacks->onGenerate(pRNG, pBufferOut, byteCount);
-}
+UUID_API uuid_result uuid_rand_buffered_init(uuid_rand* pUpstream, void* pPool, size_t poolSize, uuid_rand_buffered* pRNG);
+UUID_API void uuid_rand_buffered_uninit(uuid_rand_buffered* pRNG);
+UUID_API uuid_result uuid_rand_buffered_flush(uuid_rand_buffered* pRNG);
 
 
-#if !defined(UUID_NO_CRYPTORAND)
-#define CRYPTORAND_IMPLEMENTATION
-#include "external/cryptorand/cryptorand.h"
+/*
+ChaCha20 random number generator. This is a userspace generator which is seeded from another random
+number generator (the default generator if NULL) and then produces a ChaCha20 keystream. The key is
+replaced after every refill of the internal buffer ("fast key erasure") so that a compromise of the
+state does not reveal previous output. It will reseed automatically after a configurable number of
+bytes or amount of time, and when it detects that the process has been forked.
+*/
+#define UUID_CHACHA_RNG_BUFFER_SIZE 1024    /* 16 ChaCha20 blocks. The first 32 bytes of each refill become the next key. */
 
-static uuid_result uuid_result_from_cryptorand(cryptorand_result result)
+typedef struct
 {
-    return (uuid_result)result;
-}
+    uuid_rand* pSeedRNG;            /* The generator to seed from. Set to NULL to use the default generator. */
+    uuid_uint64 reseedIntervalInBytes;
+    uuid_uint32 reseedIntervalInMilliseconds;
+} uuid_chacha_rng_config;
+
+UUID_API uuid_chacha_rng_config uuid_chacha_rng_config_init(uuid_rand* pSeedRNG);
 
 typedef struct
 {
     uuid_rand_callbacks base;
-    cryptorand rng;
-} uuid_cryptorand;
+    uuid_chacha_rng_config config;
+    uuid_uint32 key[8];
+    unsigned char buffer[UUID_CHACHA_RNG_BUFFER_SIZE];
+    size_t cursor;                  /* The number of bytes in the buffer that have already been consumed. */
+    uuid_uint64 bytesSinceReseed;
+    uuid_uint64 timeOfLastReseed;   /* In 100-nanosecond resolution. */
+    uuid_uint32 forkGeneration;
+} uuid_chacha_rng;
 
-static uuid_result uuid_cryptorand_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
-{
-    uuid_result result;
+UUID_API uuid_result uuid_chacha_rng_init(const uuid_chacha_rng_config* pConfig, uuid_chacha_rng* pRNG);
+UUID_API void uuid_chacha_rng_uninit(uuid_chacha_rng* pRNG);
+UUID_API uuid_result uuid_chacha_rng_reseed(uuid_chacha_rng* pRNG);
 
-    if (pRNG == NULL) {
-        return UUID_INVALID_ARGS;
-    }
 
-    result = uuid_result_from_cryptorand(cryptorand_generate(&((uuid_cryptorand*)pRNG)->rng, pBufferOut, byteCount));
-    if (result != UUID_SUCCESS) {
-        return result;
-    }
+/* Generation. */
+UUID_API uuid_result uuid1(unsigned char* pUUID, uuid_rand* pRNG);
+UUID_API uuid_result uuid3(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
+UUID_API uuid_result uuid4(unsigned char* pUUID, uuid_rand* pRNG);
+UUID_API uuid_result uuid5(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName);
+UUID_API uuid_result uuid6(unsigned char* pUUID, uuid_rand* pRNG);
+UUID_API uuid_result uuid7(unsigned char* pUUID, uuid_rand* pRNG);
+UUID_API uuid_result uuid8(unsigned char* pUUID, const unsigned char* pCustomData);
+UUID_API uuid_result uuid_ordered(unsigned char* pUUID, uuid_rand* pRNG);
 
-    return UUID_SUCCESS;
-}
+/*
+Namespaces for version 3 and 5 UUIDs. This stores the hashing state after the namespace has been
+absorbed so it doesn't need to be done for every UUID. The storage for the hashing contexts is
+opaque because the context types are only known by the implementation.
+*/
+#ifndef UUID_NAMESPACE_CTX_SIZE
+#define UUID_NAMESPACE_CTX_SIZE 256
+#endif
 
-static uuid_result uuid_cryptorand_init(uuid_cryptorand* pRNG)
+typedef union
 {
-    uuid_result result;
-
-    if (pRNG == NULL) {
-        return UUID_INVALID_ARGS;
-    }
+    unsigned char data[UUID_NAMESPACE_CTX_SIZE];
+    uuid_uint64 _alignment64;   /* Just for alignment. */
+    void* _alignmentPtr;
+    double _alignmentDouble;
+} uuid_namespace_ctx;
 
-    UUID_ZERO_OBJECT(pRNG);
+typedef struct
+{
+    unsigned char uuid[UUID_SIZE];
+    uuid_namespace_ctx md5;
+    uuid_namespace_ctx sha1;
+} uuid_namespace;
 
-    result = uuid_result_from_cryptorand(cryptorand_init(&pRNG->rng));
-    if (result != UUID_SUCCESS) {
-        return result;  /* Failed to initialize RNG. */
-    }
+UUID_API uuid_result uuid_namespace_init(const unsigned char* pNamespaceUUID, uuid_namespace* pNamespace);
+UUID_API uuid_result uuid3_ns(unsigned char* pUUID, const uuid_namespace* pNamespace, const char* pName, size_t nameLen);
+UUID_API uuid_result uuid5_ns(unsigned char* pUUID, const uuid_namespace* pNamespace, const char* pName, size_t nameLen);
 
-    pRNG->base.onGenerate = uuid_cryptorand_generate;
+/*
+Batch versions of uuid3() and uuid5(). These use a built-in multi-buffer MD5 and SHA-1 implementation
+and do not require the UUID_MD5_* and UUID_SHA1_* macros. pNameLengths can be NULL in which case each
+name must be null terminated.
+*/
+UUID_API uuid_result uuid3_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths);
+UUID_API uuid_result uuid5_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths);
 
-    return UUID_SUCCESS;
-}
+/* Batch generation. pUUIDs must be at least `count * UUID_SIZE` bytes. */
+UUID_API uuid_result uuid1_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+UUID_API uuid_result uuid4_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+UUID_API uuid_result uuid6_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+UUID_API uuid_result uuid7_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+UUID_API uuid_result uuid_ordered_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
 
-static void uuid_cryptorand_uninit(uuid_cryptorand* pRNG)
+/*
+Generator for strictly increasing time-based UUIDs. This can be shared between threads. The clock
+sequence and node ID are generated randomly when the generator is initialized and are then reused,
+which means no random number generation is required for each version 1 and 6 UUID. Version 7 UUIDs
+get fresh random data from pRNG each time, so pRNG must outlive the generator, and if the generator
+is shared between threads, pRNG must be thread-safe (the default generator is).
+*/
+typedef struct
 {
-    if (pRNG == NULL) {
-        return;
-    }
+    uuid_rand* pRNG;                        /* Only used for version 7 after initialization. NULL for the default. */
+    uuid_clock* pClock;
+    volatile uuid_uint64 lastTime;          /* The timestamp of the most recent UUID in 100-nanosecond resolution. */
+    volatile uuid_uint64 lastTime7;         /* The most recent version 7 timestamp. Milliseconds in the upper bits and a 12-bit counter in the lower bits. */
+    volatile uuid_uint64 lastClockReading;  /* Used for detecting when the clock goes backwards. */
+    volatile uuid_uint32 clockSequence;
+    unsigned char node[6];
+} uuid_generator;
+
+UUID_API uuid_result uuid_generator_init(uuid_rand* pRNG, uuid_clock* pClock, uuid_generator* pGenerator);
+UUID_API void uuid_generator_uninit(uuid_generator* pGenerator);
+UUID_API uuid_result uuid_generator_uuid1(uuid_generator* pGenerator, unsigned char* pUUID);
+UUID_API uuid_result uuid_generator_uuid6(uuid_generator* pGenerator, unsigned char* pUUID);
+UUID_API uuid_result uuid_generator_uuid7(uuid_generator* pGenerator, unsigned char* pUUID);
+UUID_API uuid_result uuid_generator_ordered(uuid_generator* pGenerator, unsigned char* pUUID);
 
-    cryptorand_uninit(&pRNG->rng);
-    UUID_ZERO_OBJECT(pRNG);
-}
-#endif /* UUID_NO_CRYPTORAND */
+/* Formatting. */
+UUID_API uuid_result uuid_format(char* dst, size_t dstCap, const unsigned char* pUUID);
+UUID_API uuid_result uuid_format_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count);
 
+/* Parsing. Set srcLen to (size_t)-1 if the string is null terminated. */
+UUID_API uuid_result uuid_parse(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+UUID_API uuid_result uuid_parse_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount);
+UUID_API uuid_result uuid_validate(const char* pSrc, size_t srcLen);
 
-#if defined(_WIN32)
-#include <windows.h>
+/*
+Compact encodings. These work the same as uuid_format() and uuid_parse(). Base32 uses the Crockford
+alphabet and is 26 characters long. Base58 uses the Bitcoin alphabet and is always 22 characters long.
+Base64url is 22 characters long and is not padded. Base32 and base58 sort the same as the UUID.
+*/
+UUID_API uuid_result uuid_format_base32(char* dst, size_t dstCap, const unsigned char* pUUID);
+UUID_API uuid_result uuid_format_base32_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count);
+UUID_API uuid_result uuid_parse_base32(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+UUID_API uuid_result uuid_parse_base32_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount);
+UUID_API uuid_result uuid_format_base58(char* dst, size_t dstCap, const unsigned char* pUUID);
+UUID_API uuid_result uuid_format_base58_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count);
+UUID_API uuid_result uuid_parse_base58(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+UUID_API uuid_result uuid_parse_base58_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount);
+UUID_API uuid_result uuid_format_base64url(char* dst, size_t dstCap, const unsigned char* pUUID);
+UUID_API uuid_result uuid_format_base64url_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count);
+UUID_API uuid_result uuid_parse_base64url(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+UUID_API uuid_result uuid_parse_base64url_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount);
 
-static int uuid_timespec_get(struct uuid_timespec* ts, int base)
-{
-    FILETIME ft;
-    LONGLONG current100Nanoseconds;
+/*
+Comparison and hashing. UUIDs are ordered by their bytes, which for version 6, 7 and ordered UUIDs is
+the order they were generated in. uuid_compare() returns a negative number if A comes before B, 0 if
+they are equal and a positive number otherwise. The pointers must not be NULL.
+*/
+UUID_API int uuid_equal(const unsigned char* pUUIDA, const unsigned char* pUUIDB);
+UUID_API int uuid_compare(const unsigned char* pUUIDA, const unsigned char* pUUIDB);
+UUID_API int uuid_is_nil(const unsigned char* pUUID);
+UUID_API uuid_uint64 uuid_hash(const unsigned char* pUUID, uuid_uint64 seed);
+UUID_API uuid_result uuid_equal_batch(int* pResults, const unsigned char* pUUIDsA, const unsigned char* pUUIDsB, size_t count);
+UUID_API uuid_result uuid_compare_batch(int* pResults, const unsigned char* pUUIDsA, const unsigned char* pUUIDsB, size_t count);
+UUID_API uuid_result uuid_hash_batch(uuid_uint64* pHashes, const unsigned char* pUUIDs, size_t count, uuid_uint64 seed);
+
+/* Only used for small functions on hot paths. C89 has no inline keyword so this uses extensions. */
+#if defined(_MSC_VER)
+    #define UUID_INLINE __forceinline
+#elif defined(__GNUC__)
+    #define UUID_INLINE __inline__ __attribute__((always_inline))
+#else
+    #define UUID_INLINE
+#endif
 
-    if (ts == NULL) {
-        return 0;   /* 0 = error. */
-    }
+#define UUID_UINT64_CONSTANT(hi, lo)    (((uuid_uint64)(hi) << 32) | (uuid_uint64)(lo))    /* VC6 doesn't like 64-bit constants. */
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h> /* For _umul128(). */
+#endif
+
+/* The 64-bit loads are recognized by compilers and turned into a single load, plus a byte swap where necessary. */
+static UUID_INLINE uuid_uint64 uuid_load_le64(const unsigned char* p)
+{
+    return
+        ((uuid_uint64)p[0] <<  0) | ((uuid_uint64)p[1] <<  8) | ((uuid_uint64)p[2] << 16) | ((uuid_uint64)p[3] << 24) |
+        ((uuid_uint64)p[4] << 32) | ((uuid_uint64)p[5] << 40) | ((uuid_uint64)p[6] << 48) | ((uuid_uint64)p[7] << 56);
+}
+
+static UUID_INLINE uuid_uint64 uuid_load_be64(const unsigned char* p)
+{
+    return
+        ((uuid_uint64)p[0] << 56) | ((uuid_uint64)p[1] << 48) | ((uuid_uint64)p[2] << 40) | ((uuid_uint64)p[3] << 32) |
+        ((uuid_uint64)p[4] << 24) | ((uuid_uint64)p[5] << 16) | ((uuid_uint64)p[6] <<  8) | ((uuid_uint64)p[7] <<  0);
+}
+
+/* The 128-bit product of a and b with the high and low halves XOR'd together. */
+static UUID_INLINE uuid_uint64 uuid_mul128_fold64(uuid_uint64 a, uuid_uint64 b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uuid_uint128;
+    uuid_uint128 product = (uuid_uint128)a * b;
+    return (uuid_uint64)product ^ (uuid_uint64)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uuid_uint64 hi;
+    uuid_uint64 lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#else
+    uuid_uint64 aLo = a & 0xFFFFFFFF;
+    uuid_uint64 aHi = a >> 32;
+    uuid_uint64 bLo = b & 0xFFFFFFFF;
+    uuid_uint64 bHi = b >> 32;
+    uuid_uint64 ll  = aLo * bLo;
+    uuid_uint64 lh  = aLo * bHi;
+    uuid_uint64 hl  = aHi * bLo;
+    uuid_uint64 hh  = aHi * bHi;
+    uuid_uint64 cross = (ll >> 32) + (lh & 0xFFFFFFFF) + hl;
+    uuid_uint64 hi  = hh + (lh >> 32) + (cross >> 32);
+    uuid_uint64 lo  = (cross << 32) | (ll & 0xFFFFFFFF);
+    return lo ^ hi;
+#endif
+}
+
+static UUID_INLINE uuid_uint64 uuid_bswap64(uuid_uint64 x)
+{
+    return
+        ((x >> 56) & 0x00000000000000FF) | ((x >> 40) & 0x000000000000FF00) |
+        ((x >> 24) & 0x0000000000FF0000) | ((x >>  8) & 0x00000000FF000000) |
+        ((x & 0x00000000FF000000) <<  8) | ((x & 0x0000000000FF0000) << 24) |
+        ((x & 0x000000000000FF00) << 40) | ((x & 0x00000000000000FF) << 56);
+}
+
+/*
+Inline versions of uuid_equal(), uuid_compare() and uuid_hash(). These give the same results but are
+defined here so they can be inlined into sort comparators, hash table probes and other hot loops in
+any translation unit, not just the one with the implementation. The pointers must not be NULL.
+*/
+static UUID_INLINE int uuid_equal_inline(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+{
+    return ((uuid_load_le64(pUUIDA + 0) ^ uuid_load_le64(pUUIDB + 0)) | (uuid_load_le64(pUUIDA + 8) ^ uuid_load_le64(pUUIDB + 8))) == 0;
+}
+
+static UUID_INLINE int uuid_compare_inline(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+{
+    uuid_uint64 a = uuid_load_be64(pUUIDA);
+    uuid_uint64 b = uuid_load_be64(pUUIDB);
+
+    if (a == b) {
+        a = uuid_load_be64(pUUIDA + 8);
+        b = uuid_load_be64(pUUIDB + 8);
+    }
+
+    return (a > b) - (a < b);
+}
+
+/*
+The hash is the same construction as the 9 to 16 byte path of XXH3. The words are mixed with a 64x64
+to 128-bit multiply and then finalized so that every bit of the input affects every bit of the
+output. This matters for hash tables which use the low bits for the bucket, because for version 1, 6
+and 7 UUIDs most of the entropy is in the second half and the first half is mostly time.
+*/
+static UUID_INLINE uuid_uint64 uuid_hash_inline(const unsigned char* pUUID, uuid_uint64 seed)
+{
+    uuid_uint64 lo = uuid_load_le64(pUUID + 0) ^ (UUID_UINT64_CONSTANT(0x9E3779B9, 0x7F4A7C15) + seed);
+    uuid_uint64 hi = uuid_load_le64(pUUID + 8) ^ (UUID_UINT64_CONSTANT(0xC2B2AE3D, 0x27D4EB4F) - seed);
+    uuid_uint64 h;
+
+    h = UUID_SIZE + uuid_bswap64(lo) + hi + uuid_mul128_fold64(lo, hi);
+
+    /* Avalanche. */
+    h ^= h >> 37;
+    h *= UUID_UINT64_CONSTANT(0x16566791, 0x9E3779F9);
+    h ^= h >> 32;
+
+    return h;
+}
+
+
+/*
+Memory allocation. Set all callbacks to NULL to use the standard library, which can be replaced at
+compile time with UUID_MALLOC, UUID_REALLOC and UUID_FREE.
+*/
+typedef struct
+{
+    void* pUserData;
+    void* (* onMalloc)(size_t sz, void* pUserData);
+    void* (* onRealloc)(void* p, size_t sz, void* pUserData);
+    void  (* onFree)(void* p, void* pUserData);
+} uuid_allocation_callbacks;
+
+
+/*
+Hash map with UUID keys. This is an open addressing table in the style of Swiss tables. Each slot has
+a control byte holding 7 bits of the hash, and the control bytes are checked 16 at a time. Keys and
+values are stored inline in the slots. Values are copied in and out as raw bytes of size valueSize.
+
+UUID_MAP_FLAG_RANDOM_KEYS skips the hash function and uses the random bits of the key directly. Only
+use this when all keys are version 4 or 7 UUIDs that were generated by a trusted source, otherwise
+keys can be crafted to collide.
+*/
+#define UUID_MAP_FLAG_RANDOM_KEYS   0x00000001
+
+typedef struct
+{
+    size_t valueSize;               /* Set to 0 for a set. */
+    size_t initialCapacity;         /* The number of items to reserve space for. */
+    uuid_uint32 flags;
+    uuid_uint64 seed;               /* Seed for uuid_hash(). Ignored with UUID_MAP_FLAG_RANDOM_KEYS. */
+    uuid_allocation_callbacks allocationCallbacks;
+} uuid_map_config;
+
+UUID_API uuid_map_config uuid_map_config_init(size_t valueSize);
+
+typedef struct
+{
+    unsigned char* pControl;        /* One byte per slot, in groups of 16. */
+    unsigned char* pSlots;          /* The key followed by the value. */
+    size_t capacity;                /* The number of slots. A power of two and at least 16, or 0. */
+    size_t count;
+    size_t growthLeft;              /* The number of empty slots that can be used before the table needs to grow. */
+    size_t slotSize;
+    uuid_map_config config;
+} uuid_map;
+
+UUID_API uuid_result uuid_map_init(const uuid_map_config* pConfig, uuid_map* pMap);
+UUID_API void uuid_map_uninit(uuid_map* pMap);
+UUID_API uuid_result uuid_map_reserve(uuid_map* pMap, size_t count);
+UUID_API void uuid_map_clear(uuid_map* pMap);
+UUID_API size_t uuid_map_count(const uuid_map* pMap);
+UUID_API uuid_result uuid_map_insert(uuid_map* pMap, const unsigned char* pKey, const void* pValue, void** ppValue);
+UUID_API uuid_result uuid_map_find(const uuid_map* pMap, const unsigned char* pKey, void** ppValue);
+UUID_API uuid_result uuid_map_remove(uuid_map* pMap, const unsigned char* pKey);
+UUID_API uuid_result uuid_map_insert_batch(uuid_map* pMap, const unsigned char* pKeys, const void* pValues, size_t count, size_t* pInsertedCount);
+UUID_API uuid_result uuid_map_find_batch(const uuid_map* pMap, const unsigned char* pKeys, size_t count, void** ppValues, size_t* pFoundCount);
+UUID_API uuid_result uuid_map_next(const uuid_map* pMap, size_t* pIterator, const unsigned char** ppKey, void** ppValue);
+
+/* Set of UUIDs. This is a uuid_map without values. */
+typedef uuid_map_config uuid_set_config;
+
+UUID_API uuid_set_config uuid_set_config_init(void);
+
+typedef struct
+{
+    uuid_map map;
+} uuid_set;
+
+UUID_API uuid_result uuid_set_init(const uuid_set_config* pConfig, uuid_set* pSet);
+UUID_API void uuid_set_uninit(uuid_set* pSet);
+UUID_API uuid_result uuid_set_reserve(uuid_set* pSet, size_t count);
+UUID_API void uuid_set_clear(uuid_set* pSet);
+UUID_API size_t uuid_set_count(const uuid_set* pSet);
+UUID_API uuid_result uuid_set_insert(uuid_set* pSet, const unsigned char* pKey);
+UUID_API int uuid_set_contains(const uuid_set* pSet, const unsigned char* pKey);
+UUID_API uuid_result uuid_set_remove(uuid_set* pSet, const unsigned char* pKey);
+UUID_API uuid_result uuid_set_insert_batch(uuid_set* pSet, const unsigned char* pKeys, size_t count, size_t* pInsertedCount);
+UUID_API uuid_result uuid_set_contains_batch(const uuid_set* pSet, const unsigned char* pKeys, size_t count, int* pResults, size_t* pFoundCount);
+UUID_API uuid_result uuid_set_next(const uuid_set* pSet, size_t* pIterator, const unsigned char** ppKey);
+
+
+/*
+Sorting. UUIDs are sorted by their bytes, the same as uuid_compare(). The scratch buffer must be at
+least count * UUID_SIZE bytes. If it's NULL it'll be allocated with malloc(). uuid_sort_mt() splits the
+work across threadCount threads. uuid_merge() merges runs that are already sorted into pOut which must
+not overlap any of the runs.
+*/
+UUID_API uuid_result uuid_sort(unsigned char* pUUIDs, size_t count, void* pScratch);
+UUID_API uuid_result uuid_sort_mt(unsigned char* pUUIDs, size_t count, void* pScratch, unsigned int threadCount);
+UUID_API uuid_result uuid_merge(unsigned char* pOut, const unsigned char* const* ppRuns, const size_t* pRunCounts, size_t runCount);
+
+
+/*
+Column encoding. Compresses an array of time-ordered UUIDs for storage. The UUIDs are split into blocks
+of blockSize UUIDs. Within a block the first 8 bytes of each UUID, which is where the timestamp lives,
+are stored as the difference from the previous UUID and the last 8 bytes are stored as-is. Use a
+blockSize of 0 for the default. Set pDst to NULL to retrieve the size of the encoded data without
+encoding anything. uuid_column_encode_bound() returns the largest size the encoded data can be.
+
+The decoder can seek to any UUID and can decode only the first 8 bytes of each UUID, which is faster
+when only the time is needed. Malformed data will return UUID_INVALID_DATA.
+*/
+#define UUID_COLUMN_DEFAULT_BLOCK_SIZE  4096
+
+typedef struct
+{
+    const unsigned char* pData;
+    size_t dataSize;
+    size_t count;
+    size_t blockSize;
+    size_t blockCount;
+    size_t cursor;                      /* The index of the next UUID to be decoded. */
+    size_t blockIndex;
+    size_t blockUUIDCount;
+    size_t blockCursor;                 /* The index of the next UUID relative to the start of the block. */
+    unsigned int blockFlags;
+    const unsigned char* pHeads;
+    const unsigned char* pHeadsEnd;
+    const unsigned char* pTails;
+    uuid_uint64 prevHead;
+} uuid_column_decoder;
+
+UUID_API size_t uuid_column_encode_bound(size_t count, size_t blockSize);
+UUID_API uuid_result uuid_column_encode(void* pDst, size_t dstCap, const unsigned char* pUUIDs, size_t count, size_t blockSize, size_t* pDstSize);
+UUID_API uuid_result uuid_column_decode(unsigned char* pUUIDs, size_t uuidCap, const void* pSrc, size_t srcSize, size_t* pUUIDCount);
+UUID_API uuid_result uuid_column_decoder_init(const void* pSrc, size_t srcSize, uuid_column_decoder* pDecoder);
+UUID_API size_t uuid_column_decoder_count(const uuid_column_decoder* pDecoder);
+UUID_API uuid_result uuid_column_decoder_seek(uuid_column_decoder* pDecoder, size_t index);
+UUID_API uuid_result uuid_column_decoder_read(uuid_column_decoder* pDecoder, unsigned char* pUUIDs, size_t uuidCap, size_t* pUUIDCount);
+UUID_API uuid_result uuid_column_decoder_read_heads(uuid_column_decoder* pDecoder, unsigned char* pHeads, size_t headCap, size_t* pHeadCount);
+
+
+/*
+Sharded generator. This is an alternative to uuid_generator for when many threads are generating
+time-based UUIDs at the same time. Each thread uses its own shard which has its own timestamp and its
+own ChaCha20 random number generator, so nothing is shared between threads. A shard must only be
+used by one thread at a time. The shard index is stored in the bits after the variant so UUIDs from
+different shards can never be the same. Within a shard, UUIDs are strictly increasing like
+uuid_generator. Between shards they are only ordered by time.
+*/
+#define UUID_SHARD_MAX_COUNT    4096
+
+typedef struct
+{
+    uuid_rand* pSeedRNG;        /* Used for seeding the random number generator of each shard. Set to NULL to use the default generator. */
+    uuid_clock* pClock;         /* Set to NULL to use the default clock. */
+    uuid_uint32 shardCount;     /* Usually the number of threads. Cannot be more than UUID_SHARD_MAX_COUNT. */
+    uuid_allocation_callbacks allocationCallbacks;
+} uuid_sharded_generator_config;
+
+UUID_API uuid_sharded_generator_config uuid_sharded_generator_config_init(uuid_uint32 shardCount);
+
+typedef struct
+{
+    uuid_clock* pClock;
+    uuid_uint64 lastTime;           /* The timestamp of the most recent UUID in 100-nanosecond resolution. */
+    uuid_uint64 lastTime7;          /* The most recent version 7 timestamp. Milliseconds in the upper bits and a 12-bit counter in the lower bits. */
+    uuid_uint64 lastClockReading;
+    uuid_uint32 clockSequence;      /* The shard index is stored in the upper bits. */
+    uuid_uint32 shardIndex;
+    uuid_uint32 shardBits;
+    unsigned char node[6];
+    uuid_chacha_rng rng;
+} uuid_shard;
+
+typedef struct
+{
+    uuid_sharded_generator_config config;
+    void* pAllocation;
+    unsigned char* pShards;         /* Aligned to a cache line. */
+    size_t shardStride;             /* The size of each shard rounded up to a cache line. */
+} uuid_sharded_generator;
+
+UUID_API uuid_result uuid_sharded_generator_init(const uuid_sharded_generator_config* pConfig, uuid_sharded_generator* pGenerator);
+UUID_API void uuid_sharded_generator_uninit(uuid_sharded_generator* pGenerator);
+UUID_API uuid_shard* uuid_sharded_generator_get_shard(uuid_sharded_generator* pGenerator, uuid_uint32 shardIndex);
+UUID_API uuid_result uuid_shard_uuid1(uuid_shard* pShard, unsigned char* pUUID);
+UUID_API uuid_result uuid_shard_uuid6(uuid_shard* pShard, unsigned char* pUUID);
+UUID_API uuid_result uuid_shard_uuid7(uuid_shard* pShard, unsigned char* pUUID);
+UUID_API uuid_result uuid_shard_ordered(uuid_shard* pShard, unsigned char* pUUID);
+
+/*
+UUID pool. Producer threads generate UUIDs in the background and store them in a lock-free ring
+buffer so that uuid_pool_pop() only needs to copy 16 bytes. If the ring is empty, uuid_pool_pop()
+generates the UUID on the calling thread instead of waiting. The producers refill the ring whenever
+it drops below the low watermark. For time-based UUIDs, maxAgeInMilliseconds puts a limit on how old
+the timestamp of a popped UUID can be. UUIDs are not guaranteed to be popped in order.
+*/
+typedef uuid_result (* uuid_pool_generate_proc)(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG);
+
+typedef struct
+{
+    uuid_uint32 capacity;               /* Must be a power of two. */
+    uuid_uint32 lowWatermark;           /* The producers start refilling when the number of UUIDs drops below this. Set to 0 to use half of the capacity. */
+    uuid_uint32 producerCount;          /* The number of producer threads. */
+    uuid_uint32 maxAgeInMilliseconds;   /* UUIDs older than this are discarded. Set to 0 for no limit. */
+    uuid_rand* pRNG;                    /* Seeds a ChaCha20 generator for each producer and is used by uuid_pool_pop() when the ring is empty. Only called by one thread at a time. Set to NULL to use the default generator. */
+    uuid_pool_generate_proc onGenerate; /* Set to NULL to use uuid4_batch(). */
+    uuid_allocation_callbacks allocationCallbacks;
+} uuid_pool_config;
+
+UUID_API uuid_pool_config uuid_pool_config_init(void);
+
+typedef struct
+{
+    volatile uuid_uint64 sequence;
+    volatile uuid_uint64 time;          /* When the UUID was generated, in milliseconds. */
+    unsigned char uuid[16];
+} uuid_pool_cell;
+
+/* Forwards to the pool's random number generator while holding a lock, so it doesn't need to be thread-safe. */
+typedef struct
+{
+    uuid_rand_callbacks base;
+    uuid_rand* pRNG;
+    volatile uuid_uint64 lock;
+} uuid_pool_locked_rng;
+
+typedef struct
+{
+    volatile uuid_uint64 enqueuePos;
+    unsigned char pad0[56];             /* Keeps the producer and consumer positions on separate cache lines. */
+    volatile uuid_uint64 dequeuePos;
+    unsigned char pad1[56];
+    volatile uuid_uint64 time;          /* The time as last seen by a producer, in milliseconds. */
+    volatile uuid_uint64 isShuttingDown;
+    volatile uuid_uint64 isRefillRequested;
+    uuid_pool_config config;
+    uuid_pool_locked_rng lockedRNG;     /* Wraps config.pRNG. Only used when config.pRNG is not NULL. */
+    uuid_pool_cell* pCells;
+    uuid_uint64 mask;
+    void* pProducers;                   /* The producer threads and the events used to wake them up. */
+} uuid_pool;
+
+UUID_API uuid_result uuid_pool_init(const uuid_pool_config* pConfig, uuid_pool* pPool);
+UUID_API void uuid_pool_uninit(uuid_pool* pPool);
+UUID_API uuid_result uuid_pool_pop(uuid_pool* pPool, unsigned char* pUUID);
+
+/*
+CPU features. The best implementation for the CPU is selected automatically. uuid_set_cpu_features()
+restricts it to a subset of what's detected, which is useful for testing and benchmarking. It is not
+thread-safe and returns the features that are now active.
+*/
+#define UUID_CPU_FEATURE_SSE2   0x00000001
+#define UUID_CPU_FEATURE_SSSE3  0x00000002
+#define UUID_CPU_FEATURE_AVX2   0x00000004
+#define UUID_CPU_FEATURE_SHA    0x00000008
+#define UUID_CPU_FEATURE_ALL    0xFFFFFFFF
+
+UUID_API uuid_uint32 uuid_get_cpu_features(void);
+UUID_API uuid_uint32 uuid_set_cpu_features(uuid_uint32 features);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /* uuid_h */
+
+#if defined(UUID_IMPLEMENTATION)
+#ifndef uuid_c
+#define uuid_c
+
+#include <string.h>
+#define UUID_COPY_MEMORY(dst, src, sz)  memcpy((dst), (src), (sz))
+#define UUID_MOVE_MEMORY(dst, src, sz)  memmove((dst), (src), (sz))
+#define UUID_ZERO_MEMORY(p, sz)         memset((p), 0, (sz))
+#define UUID_ZERO_OBJECT(o)             UUID_ZERO_MEMORY((o), sizeof(*o))
+
+#ifndef UUID_MALLOC
+    #include <stdlib.h>
+    #define UUID_MALLOC(sz)             malloc((sz))
+    #define UUID_REALLOC(p, sz)         realloc((p), (sz))
+    #define UUID_FREE(p)                free((p))
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define UUID_X86
+#endif
+
+/* SIMD. Disable with UUID_NO_SSE2, UUID_NO_SSSE3, UUID_NO_AVX2 or UUID_NO_SHA. */
+#if !defined(UUID_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define UUID_SUPPORT_SSE2
+    #include <emmintrin.h>
+#endif
+
+/*
+Runtime dispatch. If the compiler supports compiling individual functions for a different target,
+the SSSE3, AVX2 and SHA kernels are always compiled and then selected at runtime based on CPUID. If
+not, or if UUID_NO_RUNTIME_DISPATCH is defined, only what the compiler is targeting will be used.
+*/
+#if defined(UUID_X86) && defined(UUID_SUPPORT_SSE2) && !defined(UUID_NO_RUNTIME_DISPATCH)
+    #if defined(_MSC_VER) && _MSC_VER >= 1900
+        #define UUID_SUPPORT_RUNTIME_DISPATCH
+    #elif defined(__clang__)
+        #if __clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8)
+            #define UUID_SUPPORT_RUNTIME_DISPATCH
+        #endif
+    #elif defined(__GNUC__)
+        #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+            #define UUID_SUPPORT_RUNTIME_DISPATCH
+        #endif
+    #endif
+#endif
+
+#if defined(UUID_SUPPORT_RUNTIME_DISPATCH) && defined(__GNUC__)
+    #define UUID_TARGET_SSSE3   __attribute__((target("ssse3")))
+    #define UUID_TARGET_AVX2    __attribute__((target("avx2")))
+    #define UUID_TARGET_SHA     __attribute__((target("sha,ssse3")))
+#else
+    #define UUID_TARGET_SSSE3
+    #define UUID_TARGET_AVX2
+    #define UUID_TARGET_SHA
+#endif
+
+#if !defined(UUID_NO_SSSE3) && defined(UUID_SUPPORT_SSE2) && (defined(__SSSE3__) || defined(UUID_SUPPORT_RUNTIME_DISPATCH))
+    #define UUID_SUPPORT_SSSE3
+    #include <tmmintrin.h>
+#endif
+
+#if !defined(UUID_NO_AVX2) && defined(UUID_SUPPORT_SSE2) && (defined(__AVX2__) || defined(UUID_SUPPORT_RUNTIME_DISPATCH))
+    #define UUID_SUPPORT_AVX2
+    #include <immintrin.h>
+#endif
+
+#if !defined(UUID_NO_SHA) && defined(UUID_SUPPORT_SSSE3) && (defined(__SHA__) || defined(UUID_SUPPORT_RUNTIME_DISPATCH))
+    #define UUID_SUPPORT_SHA
+    #include <immintrin.h>
+#endif
+
+/* CPUID. Used for runtime dispatch and for checking for an invariant TSC. */
+#if defined(UUID_X86) && (defined(__GNUC__) || defined(_MSC_VER)) && (defined(UUID_SUPPORT_RUNTIME_DISPATCH) || !defined(UUID_NO_TSC))
+    #define UUID_SUPPORT_CPUID
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+
+static void uuid_cpuid(int info[4], int function)
+{
+#if defined(_MSC_VER)
+    __cpuidex(info, function, 0);
+#else
+    unsigned int a, b, c, d;
+    __cpuid_count(function, 0, a, b, c, d);
+    info[0] = (int)a;
+    info[1] = (int)b;
+    info[2] = (int)c;
+    info[3] = (int)d;
+#endif
+}
+
+#if defined(UUID_SUPPORT_RUNTIME_DISPATCH)
+static uuid_uint64 uuid_xgetbv(int index)
+{
+#if defined(_MSC_VER)
+    return (uuid_uint64)_xgetbv(index);
+#else
+    unsigned int lo, hi;
+    __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(index));   /* xgetbv. Not all assemblers know the mnemonic. */
+    return ((uuid_uint64)hi << 32) | (uuid_uint64)lo;
+#endif
+}
+#endif
+#endif
+
+/*
+Kernels that are selected at runtime. These are chosen once based on the CPU's features the first
+time they're needed. See uuid_get_dispatch().
+*/
+typedef void (* uuid_format_hex_proc)(char* pHex, const unsigned char* pUUID);
+typedef void (* uuid_stamp_proc)(unsigned char* pUUIDs, size_t count, unsigned char version);
+typedef void (* uuid_hash_compress_proc)(uuid_uint32* pState, const unsigned char* pBlocks);
+
+typedef struct
+{
+    uuid_uint32 cpuFeatures;
+    uuid_format_hex_proc onFormatHex;
+    uuid_stamp_proc onStamp;
+    uuid_hash_compress_proc onMD5Compress;              /* The widest multi-buffer MD5 kernel. */
+    size_t md5LaneCount;
+    uuid_hash_compress_proc onSHA1Compress;             /* The widest multi-buffer SHA-1 kernel. */
+    size_t sha1LaneCount;
+    uuid_hash_compress_proc onSHA1CompressSingle;       /* Single buffer. */
+    uuid_hash_compress_proc onSHA1CompressAccelerated;  /* Single buffer, hardware accelerated. NULL if not available. */
+} uuid_dispatch;
+
+static const uuid_dispatch* uuid_get_dispatch(void);
+
+/*
+Atomics. These are only used for generator state that is shared between threads. If your compiler
+is not supported the generator will not be thread-safe.
+*/
+#if defined(_MSC_VER) && !defined(UUID_NO_ATOMICS)
+    #include <intrin.h>
+
+    static uuid_uint64 uuid_atomic_load_64(volatile uuid_uint64* p)
+    {
+        return (uuid_uint64)_InterlockedCompareExchange64((volatile __int64*)p, 0, 0);
+    }
+
+    static int uuid_atomic_compare_exchange_64(volatile uuid_uint64* p, uuid_uint64 expected, uuid_uint64 desired)
+    {
+        return (uuid_uint64)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)expected) == expected;
+    }
+
+    static uuid_uint64 uuid_atomic_exchange_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        uuid_uint64 prev;
+        do {
+            prev = uuid_atomic_load_64(p);
+        } while (!uuid_atomic_compare_exchange_64(p, prev, value));
+
+        return prev;
+    }
+
+    static void uuid_atomic_store_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        uuid_atomic_exchange_64(p, value);
+    }
+
+    static uuid_uint32 uuid_atomic_load_32(volatile uuid_uint32* p)
+    {
+        return (uuid_uint32)_InterlockedCompareExchange((volatile long*)p, 0, 0);
+    }
+
+    static uuid_uint32 uuid_atomic_fetch_add_32(volatile uuid_uint32* p, uuid_uint32 value)
+    {
+        return (uuid_uint32)_InterlockedExchangeAdd((volatile long*)p, (long)value);
+    }
+#elif (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))) && !defined(UUID_NO_ATOMICS)
+    static uuid_uint64 uuid_atomic_load_64(volatile uuid_uint64* p)
+    {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    static int uuid_atomic_compare_exchange_64(volatile uuid_uint64* p, uuid_uint64 expected, uuid_uint64 desired)
+    {
+        return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    static uuid_uint64 uuid_atomic_exchange_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        return __atomic_exchange_n(p, value, __ATOMIC_ACQ_REL);
+    }
+
+    static void uuid_atomic_store_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        __atomic_store_n(p, value, __ATOMIC_RELEASE);
+    }
+
+    static uuid_uint32 uuid_atomic_load_32(volatile uuid_uint32* p)
+    {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    static uuid_uint32 uuid_atomic_fetch_add_32(volatile uuid_uint32* p, uuid_uint32 value)
+    {
+        return __atomic_fetch_add(p, value, __ATOMIC_ACQ_REL);
+    }
+#else
+    #if !defined(UUID_NO_ATOMICS)
+        #define UUID_NO_ATOMICS
+    #endif
+
+    static uuid_uint64 uuid_atomic_load_64(volatile uuid_uint64* p)
+    {
+        return *p;
+    }
+
+    static int uuid_atomic_compare_exchange_64(volatile uuid_uint64* p, uuid_uint64 expected, uuid_uint64 desired)
+    {
+        if (*p != expected) {
+            return 0;
+        }
+
+        *p = desired;
+        return 1;
+    }
+
+    static uuid_uint64 uuid_atomic_exchange_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        uuid_uint64 prev = *p;
+        *p = value;
+        return prev;
+    }
+
+    static void uuid_atomic_store_64(volatile uuid_uint64* p, uuid_uint64 value)
+    {
+        *p = value;
+    }
+
+    static uuid_uint32 uuid_atomic_load_32(volatile uuid_uint32* p)
+    {
+        return *p;
+    }
+
+    static uuid_uint32 uuid_atomic_fetch_add_32(volatile uuid_uint32* p, uuid_uint32 value)
+    {
+        uuid_uint32 prev = *p;
+        *p += value;
+        return prev;
+    }
+#endif
+
+#ifndef UUID_ASSERT
+    #include <assert.h>
+    #define UUID_ASSERT(condition)  assert(condition)
+#endif
+
+/*
+The default random number generator is stored in thread local storage so it can be initialized once
+per thread and then reused. If thread local storage is not available, or UUID_NO_THREAD_LOCAL is
+defined, the default random number generator will be initialized and uninitialized for each call.
+*/
+#if !defined(UUID_NO_THREAD_LOCAL)
+    #if defined(_MSC_VER)
+        #define UUID_THREAD_LOCAL __declspec(thread)
+    #elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+        #define UUID_THREAD_LOCAL _Thread_local
+    #elif defined(__GNUC__)
+        #define UUID_THREAD_LOCAL __thread
+    #endif
+#endif
+
+/*
+Fork detection. Any generator that keeps random data around in memory must not keep using it after a
+fork() because the child would produce exactly the same output as the parent. On POSIX platforms we
+use pthread_atfork() to bump a generation counter in the child which generators compare against on
+each call. There is no fork() on Windows so there's nothing to do there. Define
+UUID_NO_FORK_DETECTION to disable this, in which case you will need to reseed manually after forking.
+*/
+#if defined(_WIN32) && !defined(UUID_NO_FORK_DETECTION)
+    #define UUID_NO_FORK_DETECTION
+#endif
+
+#if !defined(UUID_NO_FORK_DETECTION)
+#include <pthread.h>
+
+static volatile uuid_uint32 uuid_g_forkGeneration = 0;
+static pthread_once_t uuid_g_forkHandlerOnce = PTHREAD_ONCE_INIT;
+
+static void uuid_on_fork_child(void)
+{
+    uuid_g_forkGeneration = uuid_g_forkGeneration + 1;  /* Not +=, which C++20 deprecates for volatile. */
+}
+
+static void uuid_register_fork_handler(void)
+{
+    pthread_atfork(NULL, NULL, uuid_on_fork_child);
+}
+#endif
+
+/* Must be called at least once before relying on uuid_get_fork_generation(). */
+static void uuid_fork_detection_init(void)
+{
+#if !defined(UUID_NO_FORK_DETECTION)
+    pthread_once(&uuid_g_forkHandlerOnce, uuid_register_fork_handler);
+#endif
+}
+
+static uuid_uint32 uuid_get_fork_generation(void)
+{
+#if !defined(UUID_NO_FORK_DETECTION)
+    return uuid_g_forkGeneration;
+#else
+    return 0;
+#endif
+}
+
+
+/* Defined with the clocks further down, but needed by events and statistics before that. */
+static uuid_result uuid_clock_default_get_time(uuid_uint64* pTime);
+
+/*
+Threads. These are only used internally for work that is split across multiple threads, such as
+uuid_sort_mt(), and for the producer threads of uuid_pool. Define UUID_NO_THREADS to disable this,
+in which case the work will be done on the calling thread. Threads need atomics.
+*/
+#if !defined(UUID_NO_THREADS) && !defined(UUID_NO_ATOMICS)
+    #define UUID_SUPPORT_THREADS
+
+    #if defined(_WIN32)
+        #include <windows.h>
+    #else
+        #include <pthread.h>
+    #endif
+
+typedef void (* uuid_thread_entry_proc)(void* pUserData);
+
+typedef struct
+{
+    uuid_thread_entry_proc onEntry;
+    void* pUserData;
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+} uuid_thread;
+
+#if defined(_WIN32)
+static DWORD WINAPI uuid_thread_entry_win32(LPVOID pUserData)
+{
+    uuid_thread* pThread = (uuid_thread*)pUserData;
+    pThread->onEntry(pThread->pUserData);
+    return 0;
+}
+#else
+static void* uuid_thread_entry_posix(void* pUserData)
+{
+    uuid_thread* pThread = (uuid_thread*)pUserData;
+    pThread->onEntry(pThread->pUserData);
+    return NULL;
+}
+#endif
+
+/* The thread object must stay at the same address until uuid_thread_join() has returned. */
+static uuid_result uuid_thread_create(uuid_thread* pThread, uuid_thread_entry_proc onEntry, void* pUserData)
+{
+    UUID_ASSERT(pThread != NULL);
+    UUID_ASSERT(onEntry != NULL);
+
+    pThread->onEntry   = onEntry;
+    pThread->pUserData = pUserData;
+
+#if defined(_WIN32)
+    pThread->handle = CreateThread(NULL, 0, uuid_thread_entry_win32, pThread, 0, NULL);
+    if (pThread->handle == NULL) {
+        return UUID_ERROR;
+    }
+#else
+    if (pthread_create(&pThread->handle, NULL, uuid_thread_entry_posix, pThread) != 0) {
+        return UUID_ERROR;
+    }
+#endif
+
+    return UUID_SUCCESS;
+}
+
+static void uuid_thread_join(uuid_thread* pThread)
+{
+    UUID_ASSERT(pThread != NULL);
+
+#if defined(_WIN32)
+    WaitForSingleObject(pThread->handle, INFINITE);
+    CloseHandle(pThread->handle);
+#else
+    pthread_join(pThread->handle, NULL);
+#endif
+}
+
+
+/*
+An auto-reset event for waking up a sleeping thread. Signaling never blocks and never waits for the
+mutex so it's safe to call on a hot path. The downside is that a wakeup can be missed if it happens
+just before the other thread starts waiting, so waits should always have a timeout.
+*/
+typedef struct
+{
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    volatile uuid_uint64 signaled;
+#endif
+} uuid_event;
+
+static uuid_result uuid_event_init(uuid_event* pEvent)
+{
+    UUID_ASSERT(pEvent != NULL);
+
+#if defined(_WIN32)
+    pEvent->handle = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (pEvent->handle == NULL) {
+        return UUID_ERROR;
+    }
+#else
+    if (pthread_mutex_init(&pEvent->mutex, NULL) != 0) {
+        return UUID_ERROR;
+    }
+
+    if (pthread_cond_init(&pEvent->cond, NULL) != 0) {
+        pthread_mutex_destroy(&pEvent->mutex);
+        return UUID_ERROR;
+    }
+
+    pEvent->signaled = 0;
+#endif
+
+    return UUID_SUCCESS;
+}
+
+static void uuid_event_uninit(uuid_event* pEvent)
+{
+    UUID_ASSERT(pEvent != NULL);
+
+#if defined(_WIN32)
+    CloseHandle(pEvent->handle);
+#else
+    pthread_cond_destroy(&pEvent->cond);
+    pthread_mutex_destroy(&pEvent->mutex);
+#endif
+}
+
+static void uuid_event_signal(uuid_event* pEvent)
+{
+    UUID_ASSERT(pEvent != NULL);
+
+#if defined(_WIN32)
+    SetEvent(pEvent->handle);
+#else
+    uuid_atomic_exchange_64(&pEvent->signaled, 1);
+    pthread_cond_signal(&pEvent->cond);
+#endif
+}
+
+static void uuid_event_wait(uuid_event* pEvent, uuid_uint32 timeoutInMilliseconds)
+{
+    UUID_ASSERT(pEvent != NULL);
+
+#if defined(_WIN32)
+    WaitForSingleObject(pEvent->handle, timeoutInMilliseconds);
+#else
+    {
+        uuid_uint64 now;
+        struct timespec timeout;
+
+        if (uuid_clock_default_get_time(&now) != UUID_SUCCESS) {
+            return;
+        }
+
+        now += (uuid_uint64)timeoutInMilliseconds * 1000000;
+        timeout.tv_sec  = (time_t)(now / 1000000000);
+        timeout.tv_nsec = (long)  (now % 1000000000);
+
+        pthread_mutex_lock(&pEvent->mutex);
+        {
+            if (uuid_atomic_exchange_64(&pEvent->signaled, 0) == 0) {
+                pthread_cond_timedwait(&pEvent->cond, &pEvent->mutex, &timeout);
+                uuid_atomic_exchange_64(&pEvent->signaled, 0);
+            }
+        }
+        pthread_mutex_unlock(&pEvent->mutex);
+    }
+#endif
+}
+#endif
+
+
+/*
+Statistics. Each thread gets its own block of counters so incrementing them is just a normal add.
+Blocks are put in a lock-free list the first time a thread uses one, and uuid_get_stats() walks the
+list to add them together. Blocks are never freed. Instead, uuid_default_rng_shutdown() marks the
+thread's block as free so the next new thread can take it over, counters and all. The totals can be
+slightly out of date when other threads are generating UUIDs at the same time.
+
+Without thread local storage all threads share one block and the counts are only approximate.
+*/
+#if defined(UUID_ENABLE_STATS)
+typedef struct uuid_stats_block uuid_stats_block;
+struct uuid_stats_block
+{
+    uuid_stats counters;
+    uuid_uint64 lastClockReading;       /* For detecting same-tick UUIDs from the standalone generators. */
+    volatile uuid_uint64 isInUse;
+    uuid_stats_block* pNext;
+};
+
+static volatile uuid_uint64 uuid_g_statsBlocks = 0;     /* The head of the list. A pointer stored as an integer so it can be updated with the 64-bit atomics. */
+static uuid_stats uuid_g_statsBaseline;     /* Taken off the totals. Set by uuid_reset_stats(). */
+static uuid_stats_hook_proc uuid_g_onStatsEvent = NULL;
+static void* uuid_g_pStatsHookUserData = NULL;
+
+#if defined(UUID_THREAD_LOCAL)
+static UUID_THREAD_LOCAL uuid_stats_block* uuid_g_pThreadStatsBlock;
+#else
+static uuid_stats_block uuid_g_sharedStatsBlock;
+#endif
+
+static uuid_stats_block* uuid_stats_get_first_block(void)
+{
+    return (uuid_stats_block*)(size_t)uuid_atomic_load_64(&uuid_g_statsBlocks);
+}
+
+static uuid_stats_block* uuid_stats_get_block(void)
+{
+#if defined(UUID_THREAD_LOCAL)
+    uuid_stats_block* pBlock;
+    uuid_uint64 head;
+
+    if (uuid_g_pThreadStatsBlock != NULL) {
+        return uuid_g_pThreadStatsBlock;
+    }
+
+    /* Try taking over a block from a thread that has finished. */
+    for (pBlock = uuid_stats_get_first_block(); pBlock != NULL; pBlock = pBlock->pNext) {
+        if (uuid_atomic_load_64(&pBlock->isInUse) == 0 && uuid_atomic_compare_exchange_64(&pBlock->isInUse, 0, 1)) {
+            uuid_g_pThreadStatsBlock = pBlock;
+            return pBlock;
+        }
+    }
+
+    pBlock = (uuid_stats_block*)UUID_MALLOC(sizeof(*pBlock));
+    if (pBlock == NULL) {
+        static uuid_stats_block fallbackBlock;  /* Better to lose some accuracy than to fail generation. */
+        return &fallbackBlock;
+    }
+
+    UUID_ZERO_OBJECT(pBlock);
+    pBlock->isInUse = 1;
+
+    do {
+        head = uuid_atomic_load_64(&uuid_g_statsBlocks);
+        pBlock->pNext = (uuid_stats_block*)(size_t)head;
+    } while (!uuid_atomic_compare_exchange_64(&uuid_g_statsBlocks, head, (uuid_uint64)(size_t)pBlock));
+
+    uuid_g_pThreadStatsBlock = pBlock;
+    return pBlock;
+#else
+    if (uuid_g_statsBlocks == 0) {
+        uuid_g_statsBlocks = (uuid_uint64)(size_t)&uuid_g_sharedStatsBlock;
+    }
+
+    return &uuid_g_sharedStatsBlock;
+#endif
+}
+
+static void uuid_stats_release_block(void)
+{
+#if defined(UUID_THREAD_LOCAL)
+    if (uuid_g_pThreadStatsBlock != NULL) {
+        uuid_atomic_exchange_64(&uuid_g_pThreadStatsBlock->isInUse, 0);
+        uuid_g_pThreadStatsBlock = NULL;
+    }
+#endif
+}
+
+static void uuid_stats_check_same_tick(uuid_uint64 time)
+{
+    uuid_stats_block* pBlock = uuid_stats_get_block();
+
+    if (time <= pBlock->lastClockReading) {
+        pBlock->counters.sameTickCount += 1;
+    }
+
+    pBlock->lastClockReading = time;
+}
+
+static uuid_uint64 uuid_stats_begin_event(void)
+{
+    uuid_uint64 time = 0;
+
+    if (uuid_g_onStatsEvent != NULL) {
+        uuid_clock_default_get_time(&time);
+    }
+
+    return time;
+}
+
+static void uuid_stats_end_event(uuid_stats_event event, uuid_uint64 timeBeg, size_t byteCount)
+{
+    uuid_stats_hook_proc onEvent = uuid_g_onStatsEvent;
+    uuid_uint64 timeEnd;
+
+    if (onEvent != NULL) {
+        if (uuid_clock_default_get_time(&timeEnd) != UUID_SUCCESS || timeEnd < timeBeg) {
+            timeEnd = timeBeg;
+        }
+
+        onEvent(uuid_g_pStatsHookUserData, event, timeEnd - timeBeg, byteCount);
+    }
+}
+
+#define UUID_STATS_ADD(member, amount)      uuid_stats_get_block()->counters.member += (amount)
+#define UUID_STATS_CHECK_SAME_TICK(time)    uuid_stats_check_same_tick(time)
+#else
+#define UUID_STATS_ADD(member, amount)
+#define UUID_STATS_CHECK_SAME_TICK(time)
+#endif
+
+UUID_API uuid_result uuid_get_stats(uuid_stats* pStats)
+{
+#if defined(UUID_ENABLE_STATS)
+    uuid_stats_block* pBlock;
+#endif
+
+    if (pStats == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pStats);
+
+#if defined(UUID_ENABLE_STATS)
+    for (pBlock = uuid_stats_get_first_block(); pBlock != NULL; pBlock = pBlock->pNext) {
+        pStats->rngCallCount          += pBlock->counters.rngCallCount;
+        pStats->rngByteCount          += pBlock->counters.rngByteCount;
+        pStats->clockReadCount        += pBlock->counters.clockReadCount;
+        pStats->cryptorandInitCount   += pBlock->counters.cryptorandInitCount;
+        pStats->cryptorandUninitCount += pBlock->counters.cryptorandUninitCount;
+        pStats->sameTickCount         += pBlock->counters.sameTickCount;
+    }
+
+    pStats->rngCallCount          -= uuid_g_statsBaseline.rngCallCount;
+    pStats->rngByteCount          -= uuid_g_statsBaseline.rngByteCount;
+    pStats->clockReadCount        -= uuid_g_statsBaseline.clockReadCount;
+    pStats->cryptorandInitCount   -= uuid_g_statsBaseline.cryptorandInitCount;
+    pStats->cryptorandUninitCount -= uuid_g_statsBaseline.cryptorandUninitCount;
+    pStats->sameTickCount         -= uuid_g_statsBaseline.sameTickCount;
+
+    return UUID_SUCCESS;
+#else
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+UUID_API void uuid_reset_stats(void)
+{
+#if defined(UUID_ENABLE_STATS)
+    /* The counters belong to other threads so rather than clearing them we remember where they were. */
+    uuid_stats totals;
+
+    UUID_ZERO_OBJECT(&uuid_g_statsBaseline);
+    uuid_get_stats(&totals);
+    uuid_g_statsBaseline = totals;
+#endif
+}
+
+UUID_API void uuid_set_stats_hook(uuid_stats_hook_proc onEvent, void* pUserData)
+{
+#if defined(UUID_ENABLE_STATS)
+    uuid_g_pStatsHookUserData = pUserData;
+    uuid_g_onStatsEvent       = onEvent;
+#else
+    (void)onEvent;
+    (void)pUserData;
+#endif
+}
+
+
+#include <time.h>   /* For timespec. */
+
+#ifndef TIME_UTC
+#define TIME_UTC    1
+#endif
+
+/*
+We use `timespec` as the bridge for the cross-platform part of time retrieval. The annoying thing
+about this is that support varies depending on the age of the compiler. Since we're not exposing
+any of our timing functions publicly, the easiest way is to just define our own timespec-compatible
+struct and convert between the standard version and our version, depending on the compiler.
+*/
+#if 1
+    struct uuid_timespec
+    {
+        time_t tv_sec;
+        long tv_nsec;
+    };
+#else
+    #if (defined(_MSC_VER) && _MSC_VER < 1900) || defined(__DMC__) || (defined(_XOPEN_SOURCE) && _XOPEN_SOURCE < 500) || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE < 199309L) || defined(__STRICT_ANSI__)  /* 1900 = Visual Studio 2015 */
+    struct uuid_timespec
+    {
+        time_t tv_sec;
+        long tv_nsec;
+    };
+    #else
+    #define uuid_timespec timespec
+    #endif
+#endif
+
+
+/* Define default MD5 and SHA-1 implementations if available. */
+#if !defined(UUID_MD5_CTX_TYPE)
+    #if defined(md5_h) && defined(MD5_SIZE) && defined(MD5_SIZE_FORMATTED)  /* <-- Is this enough to detect our default MD5 implementation reliably? */
+        #define UUID_MD5_CTX_TYPE               md5_context
+        #define UUID_MD5_INIT(ctx)              md5_init(ctx)
+        #define UUID_MD5_FINAL(ctx, digest)     md5_finalize(ctx, (unsigned char*)(digest))
+        #define UUID_MD5_UPDATE(ctx, src, sz)   md5_update(ctx, src, (size_t)(sz))
+    #endif
+#endif
+
+#if !defined(UUID_SHA1_CTX_TYPE)
+    #if defined(sha1_h) && defined(SHA1_SIZE) && defined(SHA1_SIZE_FORMATTED) /* <-- Is this enough to detect our default SHA-1 implementation reliably? */
+        #define UUID_SHA1_CTX_TYPE              sha1_context
+        #define UUID_SHA1_INIT(ctx)             sha1_init(ctx)
+        #define UUID_SHA1_FINAL(ctx, digest)    sha1_finalize(ctx, (unsigned char*)(digest))
+        #define UUID_SHA1_UPDATE(ctx, src, sz)  sha1_update(ctx, src, (size_t)(sz));
+    #endif
+#endif
+
+
+UUID_API uuid_result uuid_rand_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    uuid_rand_callbacks* pCallbacks = (uuid_rand_callbacks*)pRNG;
+
+    if (pBufferOut == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_MEMORY(pBufferOut, byteCount);
+
+    if (pCallbacks == NULL || pCallbacks->onGenerate == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+#if defined(UUID_ENABLE_STATS)
+    {
+        uuid_result result;
+        uuid_uint64 timeBeg;
+
+        UUID_STATS_ADD(rngCallCount, 1);
+        UUID_STATS_ADD(rngByteCount, byteCount);
+
+        timeBeg = uuid_stats_begin_event();
+        result  = pCallbacks->onGenerate(pRNG, pBufferOut, byteCount);
+        uuid_stats_end_event(UUID_STATS_EVENT_RNG, timeBeg, byteCount);
+
+        return result;
+    }
+#else
+    return pCallbacks->onGenerate(pRNG, pBufferOut, byteCount);
+#endif
+}
+
+
+#if !defined(UUID_NO_CRYPTORAND)
+#define CRYPTORAND_IMPLEMENTATION
+#include "external/cryptorand/cryptorand.h"
+
+static uuid_result uuid_result_from_cryptorand(cryptorand_result result)
+{
+    return (uuid_result)result;
+}
+
+typedef struct
+{
+    uuid_rand_callbacks base;
+    cryptorand rng;
+} uuid_cryptorand;
+
+static uuid_result uuid_cryptorand_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    uuid_result result;
+
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_result_from_cryptorand(cryptorand_generate(&((uuid_cryptorand*)pRNG)->rng, pBufferOut, byteCount));
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_cryptorand_init(uuid_cryptorand* pRNG)
+{
+    uuid_result result;
+
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pRNG);
+
+    result = uuid_result_from_cryptorand(cryptorand_init(&pRNG->rng));
+    if (result != UUID_SUCCESS) {
+        return result;  /* Failed to initialize RNG. */
+    }
+
+    pRNG->base.onGenerate = uuid_cryptorand_generate;
+    UUID_STATS_ADD(cryptorandInitCount, 1);
+
+    return UUID_SUCCESS;
+}
+
+static void uuid_cryptorand_uninit(uuid_cryptorand* pRNG)
+{
+    if (pRNG == NULL) {
+        return;
+    }
+
+    cryptorand_uninit(&pRNG->rng);
+    UUID_ZERO_OBJECT(pRNG);
+    UUID_STATS_ADD(cryptorandUninitCount, 1);
+}
+#endif /* UUID_NO_CRYPTORAND */
+
+
+/*
+On Linux we can use getrandom() directly. This doesn't need a file descriptor and with newer versions
+of glibc (2.41+) running on newer kernels (6.11+) it will be serviced by the vDSO without a system
+call at all. If getrandom() is not supported by the running kernel we fall back to cryptorand.
+*/
+#if defined(__linux__) && !defined(UUID_NO_GETRANDOM)
+    #if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+        #define UUID_HAS_GETRANDOM
+    #elif defined(__has_include) && !defined(__ANDROID__)
+        #if __has_include(<sys/random.h>)
+            #define UUID_HAS_GETRANDOM
+        #endif
+    #endif
+#endif
+
+#if defined(UUID_HAS_GETRANDOM)
+#include <sys/random.h>
+#include <errno.h>
+
+static uuid_result uuid_getrandom_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    unsigned char* pRunningBufferOut = (unsigned char*)pBufferOut;
+
+    (void)pRNG;
+
+    /* Large requests can be interrupted by signals and return early so we need to run this in a loop. */
+    while (byteCount > 0) {
+        ssize_t bytesRead = getrandom(pRunningBufferOut, byteCount, 0);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return UUID_ERROR;
+        }
+
+        pRunningBufferOut += bytesRead;
+        byteCount         -= (size_t)bytesRead;
+    }
+
+    return UUID_SUCCESS;
+}
+
+static int uuid_getrandom_is_supported(void)
+{
+    static volatile int isSupported = -1;  /* -1 = unknown. Racing threads will just compute the same answer. */
+
+    if (isSupported == -1) {
+        unsigned char dummy;
+
+        if (getrandom(&dummy, sizeof(dummy), GRND_NONBLOCK) < 0 && errno == ENOSYS) {
+            isSupported = 0;
+        } else {
+            isSupported = 1;
+        }
+    }
+
+    return isSupported;
+}
+#endif  /* UUID_HAS_GETRANDOM */
+
+
+/*
+The default random number generator is used when NULL is passed in for the RNG. It will use the best
+backend available, which is getrandom() on Linux or cryptorand otherwise. Where possible this is
+initialized lazily on the first call and then kept around for the lifetime of the thread. Use
+uuid_default_rng_shutdown() to release it.
+*/
+#if !defined(UUID_NO_CRYPTORAND) || defined(UUID_HAS_GETRANDOM)
+#define UUID_HAS_DEFAULT_RNG
+
+typedef struct
+{
+    uuid_rand_callbacks base;
+    uuid_rng_backend backend;
+#if !defined(UUID_NO_CRYPTORAND)
+    uuid_cryptorand cryptorand;
+#endif
+} uuid_default_rng;
+
+static uuid_result uuid_default_rng_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    uuid_default_rng* pDefaultRNG = (uuid_default_rng*)pRNG;
+
+    UUID_ASSERT(pDefaultRNG != NULL);
+
+#if defined(UUID_HAS_GETRANDOM)
+    if (pDefaultRNG->backend == UUID_RNG_BACKEND_GETRANDOM) {
+        return uuid_getrandom_generate(pRNG, pBufferOut, byteCount);
+    }
+#endif
+
+#if !defined(UUID_NO_CRYPTORAND)
+    if (pDefaultRNG->backend == UUID_RNG_BACKEND_CRYPTORAND) {
+        return uuid_cryptorand_generate(&pDefaultRNG->cryptorand, pBufferOut, byteCount);
+    }
+#endif
+
+    return UUID_INVALID_OPERATION;
+}
+
+static uuid_result uuid_default_rng_init(uuid_default_rng* pRNG)
+{
+    UUID_ASSERT(pRNG != NULL);
+
+    UUID_ZERO_OBJECT(pRNG);
+    pRNG->base.onGenerate = uuid_default_rng_generate;
+
+#if defined(UUID_HAS_GETRANDOM)
+    if (uuid_getrandom_is_supported()) {
+        pRNG->backend = UUID_RNG_BACKEND_GETRANDOM;
+        return UUID_SUCCESS;
+    }
+#endif
+
+#if !defined(UUID_NO_CRYPTORAND)
+    {
+        uuid_result result;
+
+        result = uuid_cryptorand_init(&pRNG->cryptorand);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+
+        pRNG->backend = UUID_RNG_BACKEND_CRYPTORAND;
+        return UUID_SUCCESS;
+    }
+#else
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+static void uuid_default_rng_uninit(uuid_default_rng* pRNG)
+{
+    UUID_ASSERT(pRNG != NULL);
+
+#if !defined(UUID_NO_CRYPTORAND)
+    if (pRNG->backend == UUID_RNG_BACKEND_CRYPTORAND) {
+        uuid_cryptorand_uninit(&pRNG->cryptorand);
+    }
+#endif
+
+    UUID_ZERO_OBJECT(pRNG);
+}
+
+#if defined(UUID_THREAD_LOCAL)
+static UUID_THREAD_LOCAL uuid_default_rng uuid_g_defaultRNG;
+static UUID_THREAD_LOCAL int uuid_g_defaultRNGInitialized;
+
+/*
+A thread that exits without calling uuid_default_rng_shutdown() would leak its instance, which for
+cryptorand holds a file descriptor or handle. To release it automatically, a thread exit callback is
+registered the first time each thread initializes it.
+*/
+#if !defined(UUID_NO_THREAD_EXIT_CALLBACK)
+    #if defined(_WIN32)
+        #include <windows.h>
+        #if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0600   /* FlsAlloc() and InitOnceExecuteOnce() need Vista. */
+            #define UUID_SUPPORT_THREAD_EXIT_CALLBACK
+        #endif
+    #else
+        #include <pthread.h>
+        #define UUID_SUPPORT_THREAD_EXIT_CALLBACK
+    #endif
+#endif
+
+#if defined(UUID_SUPPORT_THREAD_EXIT_CALLBACK)
+#if defined(_WIN32)
+static INIT_ONCE uuid_g_threadExitOnce = INIT_ONCE_STATIC_INIT;
+static DWORD uuid_g_threadExitIndex = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI uuid_on_thread_exit(PVOID pData)
+{
+    (void)pData;
+    uuid_default_rng_shutdown();
+}
+
+static BOOL CALLBACK uuid_create_thread_exit_index(PINIT_ONCE pInitOnce, PVOID pParameter, PVOID* ppContext)
+{
+    (void)pInitOnce;
+    (void)pParameter;
+    (void)ppContext;
+
+    uuid_g_threadExitIndex = FlsAlloc(uuid_on_thread_exit);
+    return TRUE;
+}
+
+static void uuid_register_thread_exit(void)
+{
+    InitOnceExecuteOnce(&uuid_g_threadExitOnce, uuid_create_thread_exit_index, NULL, NULL);
+
+    if (uuid_g_threadExitIndex != FLS_OUT_OF_INDEXES) {
+        FlsSetValue(uuid_g_threadExitIndex, (PVOID)1);  /* The callback is only called for non-NULL values. */
+    }
+}
+#else
+static pthread_once_t uuid_g_threadExitOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t uuid_g_threadExitKey;
+static int uuid_g_threadExitKeyCreated = 0;
+
+static void uuid_on_thread_exit(void* pData)
+{
+    (void)pData;
+    uuid_default_rng_shutdown();
+}
+
+static void uuid_create_thread_exit_key(void)
+{
+    uuid_g_threadExitKeyCreated = (pthread_key_create(&uuid_g_threadExitKey, uuid_on_thread_exit) == 0);
+}
+
+static void uuid_register_thread_exit(void)
+{
+    pthread_once(&uuid_g_threadExitOnce, uuid_create_thread_exit_key);
+
+    if (uuid_g_threadExitKeyCreated) {
+        pthread_setspecific(uuid_g_threadExitKey, (void*)1);   /* The destructor is only called for non-NULL values. */
+    }
+}
+#endif
+#endif  /* UUID_SUPPORT_THREAD_EXIT_CALLBACK */
+#endif  /* UUID_THREAD_LOCAL */
+
+static uuid_result uuid_default_rng_acquire(uuid_rand** ppRNG, uuid_default_rng* pLocalRNG)
+{
+    uuid_result result;
+
+    UUID_ASSERT(ppRNG     != NULL);
+    UUID_ASSERT(pLocalRNG != NULL);
+
+    *ppRNG = NULL;
+
+#if defined(UUID_THREAD_LOCAL)
+    {
+        (void)pLocalRNG;
+
+        if (uuid_g_defaultRNGInitialized == 0) {
+            result = uuid_default_rng_init(&uuid_g_defaultRNG);
+            if (result != UUID_SUCCESS) {
+                return result;
+            }
+
+            uuid_g_defaultRNGInitialized = 1;
+
+        #if defined(UUID_SUPPORT_THREAD_EXIT_CALLBACK)
+            uuid_register_thread_exit();
+        #endif
+        }
+
+        *ppRNG = &uuid_g_defaultRNG;
+    }
+#else
+    {
+        result = uuid_default_rng_init(pLocalRNG);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+
+        *ppRNG = pLocalRNG;
+    }
+#endif
+
+    return UUID_SUCCESS;
+}
+
+static void uuid_default_rng_release(uuid_rand* pRNG, uuid_default_rng* pLocalRNG)
+{
+    /* Only the per-call fallback needs to be released. The thread local one is kept alive. */
+    if (pRNG == pLocalRNG) {
+        uuid_default_rng_uninit(pLocalRNG);
+    }
+}
+#endif  /* UUID_HAS_DEFAULT_RNG */
+
+UUID_API void uuid_default_rng_shutdown(void)
+{
+#if defined(UUID_HAS_DEFAULT_RNG) && defined(UUID_THREAD_LOCAL)
+    if (uuid_g_defaultRNGInitialized != 0) {
+        uuid_default_rng_uninit(&uuid_g_defaultRNG);
+        uuid_g_defaultRNGInitialized = 0;
+    }
+#endif
+
+#if defined(UUID_ENABLE_STATS)
+    uuid_stats_release_block();     /* Must come after uninitializing the default generator since that can update the counters. */
+#endif
+}
+
+UUID_API uuid_rng_backend uuid_default_rng_backend(void)
+{
+#if defined(UUID_HAS_DEFAULT_RNG)
+    uuid_rand* pRNG;
+    uuid_default_rng defaultRNG;
+    uuid_rng_backend backend;
+
+    if (uuid_default_rng_acquire(&pRNG, &defaultRNG) != UUID_SUCCESS) {
+        return UUID_RNG_BACKEND_NONE;
+    }
+
+    backend = ((uuid_default_rng*)pRNG)->backend;
+    uuid_default_rng_release(pRNG, &defaultRNG);
+
+    return backend;
+#else
+    return UUID_RNG_BACKEND_NONE;
+#endif
+}
+
+/* Same as uuid_rand_generate(), except NULL will use the default random number generator. */
+static uuid_result uuid_rand_generate_or_default(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+#if defined(UUID_HAS_DEFAULT_RNG)
+    if (pRNG == NULL) {
+        uuid_result result;
+        uuid_default_rng defaultRNG;
+
+        result = uuid_default_rng_acquire(&pRNG, &defaultRNG);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+
+        result = uuid_rand_generate(pRNG, pBufferOut, byteCount);
+        uuid_default_rng_release(pRNG, &defaultRNG);
+
+        return result;
+    }
+#endif
+
+    return uuid_rand_generate(pRNG, pBufferOut, byteCount);
+}
+
+
+static uuid_result uuid_rand_buffered_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    uuid_result result;
+    uuid_rand_buffered* pBufferedRNG = (uuid_rand_buffered*)pRNG;
+    unsigned char* pRunningBufferOut = (unsigned char*)pBufferOut;
+
+    if (pBufferedRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Never let a forked child hand out the same bytes as its parent. */
+    if (pBufferedRNG->forkGeneration != uuid_get_fork_generation()) {
+        uuid_rand_buffered_flush(pBufferedRNG);
+        pBufferedRNG->forkGeneration = uuid_get_fork_generation();
+    }
+
+    /* Requests that are at least as big as the pool are not worth buffering. */
+    if (byteCount >= pBufferedRNG->poolSize) {
+        return uuid_rand_generate_or_default(pBufferedRNG->pUpstream, pBufferOut, byteCount);
+    }
+
+    while (byteCount > 0) {
+        size_t bytesAvailable;
+        size_t bytesToCopy;
+
+        if (pBufferedRNG->cursor == pBufferedRNG->poolSize) {
+            result = uuid_rand_generate_or_default(pBufferedRNG->pUpstream, pBufferedRNG->pPool, pBufferedRNG->poolSize);
+            if (result != UUID_SUCCESS) {
+                return result;
+            }
+
+            pBufferedRNG->cursor = 0;
+        }
+
+        bytesAvailable = pBufferedRNG->poolSize - pBufferedRNG->cursor;
+        bytesToCopy    = byteCount;
+        if (bytesToCopy > bytesAvailable) {
+            bytesToCopy = bytesAvailable;
+        }
+
+        UUID_COPY_MEMORY(pRunningBufferOut, pBufferedRNG->pPool + pBufferedRNG->cursor, bytesToCopy);
+        UUID_ZERO_MEMORY(pBufferedRNG->pPool + pBufferedRNG->cursor, bytesToCopy);  /* Never hand out the same bytes twice. */
+
+        pBufferedRNG->cursor += bytesToCopy;
+        pRunningBufferOut    += bytesToCopy;
+        byteCount            -= bytesToCopy;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_rand_buffered_init(uuid_rand* pUpstream, void* pPool, size_t poolSize, uuid_rand_buffered* pRNG)
+{
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pRNG);
+
+    if (pPool == NULL || poolSize == 0) {
+        return UUID_INVALID_ARGS;
+    }
+
+#if !defined(UUID_HAS_DEFAULT_RNG)
+    if (pUpstream == NULL) {
+        return UUID_INVALID_ARGS;   /* No default random number generator available. */
+    }
+#endif
+
+    uuid_fork_detection_init();
+
+    pRNG->base.onGenerate  = uuid_rand_buffered_generate;
+    pRNG->pUpstream        = pUpstream;
+    pRNG->pPool            = (unsigned char*)pPool;
+    pRNG->poolSize         = poolSize;
+    pRNG->cursor           = poolSize;  /* Start empty. The first request will fill the pool. */
+    pRNG->forkGeneration   = uuid_get_fork_generation();
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_rand_buffered_uninit(uuid_rand_buffered* pRNG)
+{
+    if (pRNG == NULL) {
+        return;
+    }
+
+    if (pRNG->pPool != NULL) {
+        UUID_ZERO_MEMORY(pRNG->pPool, pRNG->poolSize);
+    }
+
+    UUID_ZERO_OBJECT(pRNG);
+}
+
+UUID_API uuid_result uuid_rand_buffered_flush(uuid_rand_buffered* pRNG)
+{
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Wipe whatever is left. The next request will pull fresh data from the upstream generator. */
+    UUID_ZERO_MEMORY(pRNG->pPool, pRNG->poolSize);
+    pRNG->cursor = pRNG->poolSize;
+
+    return UUID_SUCCESS;
+}
+
+
+#if defined(_WIN32)
+#include <windows.h>
+
+static int uuid_timespec_get(struct uuid_timespec* ts, int base)
+{
+    FILETIME ft;
+    LONGLONG current100Nanoseconds;
+
+    if (ts == NULL) {
+        return 0;   /* 0 = error. */
+    }
 
     ts->tv_sec  = 0;
     ts->tv_nsec = 0;
 
-    /* Currently only supporting UTC. */
-    if (base != TIME_UTC) {
-        return 0;   /* 0 = error. */
+    /* Currently only supporting UTC. */
+    if (base != TIME_UTC) {
+        return 0;   /* 0 = error. */
+    }
+
+    GetSystemTimeAsFileTime(&ft);
+    current100Nanoseconds = (((LONGLONG)ft.dwHighDateTime << 32) | (LONGLONG)ft.dwLowDateTime);
+    current100Nanoseconds = current100Nanoseconds - ((LONGLONG)116444736 * 1000000000); /* Windows to Unix epoch. Normal value is 116444736000000000LL, but VC6 doesn't like 64-bit constants. */
+
+    ts->tv_sec  = (time_t)(current100Nanoseconds / 10000000);
+    ts->tv_nsec =  (long)((current100Nanoseconds - (ts->tv_sec * 10000000)) * 100);
+
+    return base;
+}
+#else
+#include <sys/time.h>   /* For timeval. */
+
+static struct uuid_timespec uuid_timespec_from_timeval(struct timeval* tv)
+{
+    struct uuid_timespec ts;
+
+    ts.tv_sec  = tv->tv_sec;
+    ts.tv_nsec = tv->tv_usec * 1000;
+
+    return ts;
+}
+
+static int uuid_timespec_get(struct uuid_timespec* ts, int base)
+{
+    UUID_ZERO_OBJECT(ts);
+
+    /*
+    This is annoying to get working on all compilers. Here's the hierarchy:
+
+        * If using C11, use timespec_get(); else
+        * If _POSIX_C_SOURCE >= 199309L, use clock_gettime(CLOCK_REALTIME, ...); else
+        * Fall back to gettimeofday().
+    */
+    #if defined (__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__APPLE__)
+    {
+        int result;
+        struct timespec _ts;
+
+        result = timespec_get(&_ts, base);
+        if (result == 0) {
+            return result;  /* Failed to get the time. */
+        }
+
+        ts->tv_sec  = _ts.tv_sec;
+        ts->tv_nsec = _ts.tv_nsec;
+
+        return result;
+    }
+    #else
+    {
+        if (base != TIME_UTC) {
+            return 0;   /* Only TIME_UTC is supported. 0 = error. */
+        }
+
+        #if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+        {
+            struct timespec _ts;
+
+            if (clock_gettime(CLOCK_REALTIME, &_ts) != 0) {
+                return 0;   /* Failed to retrieve the time. 0 = error. */
+            }
+
+            ts->tv_sec  = _ts.tv_sec;
+            ts->tv_nsec = _ts.tv_nsec;
+
+            /* Getting here means we were successful. On success, need to return base (strange...) */
+            return base;
+        }
+        #else
+        {
+            struct timeval tv;
+            if (gettimeofday(&tv, NULL) != 0) {
+                return 0;   /* Failed to retrieve the time. 0 = error. */
+            }
+
+            *ts = uuid_timespec_from_timeval(&tv);
+            return base;
+        }
+        #endif  /* _POSIX_C_SOURCE >= 199309L */
+    }
+    #endif  /* C11 */
+}
+#endif
+
+static uuid_result uuid_clock_default_get_time(uuid_uint64* pTime)
+{
+    struct uuid_timespec ts;
+
+    UUID_ASSERT(pTime != NULL);
+
+    if (uuid_timespec_get(&ts, TIME_UTC) == 0) {
+        return UUID_ERROR;  /* Failed to retrieve time. */
+    }
+
+    *pTime = ((uuid_uint64)ts.tv_sec * 1000000000) + (uuid_uint64)ts.tv_nsec;
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_clock_get_time(uuid_clock* pClock, uuid_uint64* pTime)
+{
+    uuid_clock_callbacks* pCallbacks = (uuid_clock_callbacks*)pClock;
+
+    if (pTime == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    *pTime = 0;
+
+    if (pCallbacks == NULL) {
+        return uuid_clock_default_get_time(pTime);
+    }
+
+    if (pCallbacks->onGetTime == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return pCallbacks->onGetTime(pClock, pTime);
+}
+
+static uuid_result uuid_get_time_from_clock(uuid_clock* pClock, uuid_uint64* pTime)
+{
+    uuid_result result;
+    uuid_uint64 time;
+
+    if (pTime == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    *pTime = 0;
+
+#if defined(UUID_ENABLE_STATS)
+    {
+        uuid_uint64 timeBeg;
+
+        UUID_STATS_ADD(clockReadCount, 1);
+
+        timeBeg = uuid_stats_begin_event();
+        result  = uuid_clock_get_time(pClock, &time);
+        uuid_stats_end_event(UUID_STATS_EVENT_CLOCK, timeBeg, 0);
+    }
+#else
+    result = uuid_clock_get_time(pClock, &time);
+#endif
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    *pTime  = time / 100;                                       /* In 100-nanoseconds resolution. */
+    *pTime += (((uuid_uint64)0x01B21DD2 << 32) | 0x13814000);   /* Conversion from Unix Epoch to UUID Epoch. Weird format here is for compatibility with VC6 because it doesn't like 64-bit constants. */
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_get_time(uuid_uint64* pTime)
+{
+    return uuid_get_time_from_clock(NULL, pTime);
+}
+
+
+/* Coarse Clock */
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE) && defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+    #define UUID_SUPPORT_CLOCK_REALTIME_COARSE
+#endif
+
+static uuid_result uuid_clock_coarse_get_time(uuid_clock* pClock, uuid_uint64* pTime)
+{
+    (void)pClock;
+
+#if defined(UUID_SUPPORT_CLOCK_REALTIME_COARSE)
+    {
+        struct timespec ts;
+
+        if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) != 0) {
+            return UUID_ERROR;
+        }
+
+        *pTime = ((uuid_uint64)ts.tv_sec * 1000000000) + (uuid_uint64)ts.tv_nsec;
+        return UUID_SUCCESS;
+    }
+#else
+    {
+        return uuid_clock_default_get_time(pTime);
+    }
+#endif
+}
+
+UUID_API uuid_result uuid_clock_coarse_init(uuid_clock_coarse* pClock)
+{
+    if (pClock == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pClock);
+    pClock->base.onGetTime = uuid_clock_coarse_get_time;
+
+    return UUID_SUCCESS;
+}
+
+
+/* TSC Clock */
+#if !defined(UUID_NO_TSC) && defined(UUID_SUPPORT_CPUID)
+    #define UUID_SUPPORT_TSC
+
+    #if !defined(_MSC_VER)
+        #include <x86intrin.h>
+    #endif
+
+static int uuid_has_invariant_tsc(void)
+{
+    int info[4];
+
+    uuid_cpuid(info, 0x80000000);
+    if ((unsigned int)info[0] < 0x80000007) {
+        return 0;
+    }
+
+    uuid_cpuid(info, 0x80000007);
+    return (info[3] & (1 << 8)) != 0;
+}
+
+static uuid_uint64 uuid_tsc_ticks_to_nanoseconds(uuid_uint64 ticks, uuid_uint64 nanosecondsPerTick)
+{
+    /* 32.32 fixed point. Split to avoid overflowing for large tick counts. */
+    return ((ticks >> 32) * nanosecondsPerTick) + (((ticks & 0xFFFFFFFF) * nanosecondsPerTick) >> 32);
+}
+#endif
+
+static uuid_result uuid_clock_tsc_get_time(uuid_clock* pClock, uuid_uint64* pTime)
+{
+#if defined(UUID_SUPPORT_TSC)
+    uuid_clock_tsc* pTSCClock = (uuid_clock_tsc*)pClock;
+    uuid_uint64 sequence;
+    uuid_uint64 anchorTime;
+    uuid_uint64 anchorTicks;
+    uuid_uint64 nanosecondsPerTick;
+    uuid_uint64 ticks;
+
+    /* The calibration can be updated by uuid_clock_tsc_anchor() at any time. Retry until we get a consistent copy. */
+    for (;;) {
+        sequence = uuid_atomic_load_64(&pTSCClock->sequence);
+        if ((sequence & 1) != 0) {
+            continue;   /* An update is in progress. */
+        }
+
+        anchorTime         = uuid_atomic_load_64(&pTSCClock->anchorTime);
+        anchorTicks        = uuid_atomic_load_64(&pTSCClock->anchorTicks);
+        nanosecondsPerTick = uuid_atomic_load_64(&pTSCClock->nanosecondsPerTick);
+
+        if (uuid_atomic_load_64(&pTSCClock->sequence) == sequence) {
+            break;
+        }
+    }
+
+    ticks = (uuid_uint64)__rdtsc();
+
+    /*
+    The TSC can be slightly behind the anchor if this thread is on a different core to the one that
+    anchored, or if the anchor was published after rdtsc executed. Without this the difference would
+    wrap around and put the time centuries in the future.
+    */
+    if (ticks < anchorTicks) {
+        ticks = anchorTicks;
+    }
+
+    *pTime = anchorTime + uuid_tsc_ticks_to_nanoseconds(ticks - anchorTicks, nanosecondsPerTick);
+
+    return UUID_SUCCESS;
+#else
+    (void)pClock;
+    (void)pTime;
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+UUID_API uuid_result uuid_clock_tsc_init(uuid_clock_tsc* pClock)
+{
+#if defined(UUID_SUPPORT_TSC)
+    uuid_result result;
+    uuid_uint64 startTime;
+    uuid_uint64 startTicks;
+    uuid_uint64 endTime;
+    uuid_uint64 endTicks;
+
+    if (pClock == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pClock);
+
+    if (!uuid_has_invariant_tsc()) {
+        return UUID_NOT_IMPLEMENTED;    /* The TSC rate may change with the CPU frequency which makes it useless as a clock. */
+    }
+
+    /* Calibrate by spinning for a short time and comparing against the default clock. */
+    result = uuid_clock_default_get_time(&startTime);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    startTicks = (uuid_uint64)__rdtsc();
+
+    do {
+        result = uuid_clock_default_get_time(&endTime);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+    } while ((endTime - startTime) < 10000000); /* 10 milliseconds. */
+
+    endTicks = (uuid_uint64)__rdtsc();
+
+    if (endTicks <= startTicks) {
+        return UUID_ERROR;
+    }
+
+    pClock->base.onGetTime         = uuid_clock_tsc_get_time;
+    pClock->nanosecondsPerTick     = ((endTime - startTime) << 32) / (endTicks - startTicks);
+    pClock->anchorTime             = endTime;
+    pClock->anchorTicks            = endTicks;
+
+    return UUID_SUCCESS;
+#else
+    if (pClock == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pClock);
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+UUID_API uuid_result uuid_clock_tsc_anchor(uuid_clock_tsc* pClock)
+{
+#if defined(UUID_SUPPORT_TSC)
+    uuid_result result;
+    uuid_uint64 sequence;
+    uuid_uint64 time;
+    uuid_uint64 ticks;
+
+    if (pClock == NULL || pClock->base.onGetTime == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Make the sequence odd so readers know to wait. This also stops two threads anchoring at the same time. */
+    for (;;) {
+        sequence = uuid_atomic_load_64(&pClock->sequence);
+        if ((sequence & 1) == 0 && uuid_atomic_compare_exchange_64(&pClock->sequence, sequence, sequence + 1)) {
+            break;
+        }
+    }
+
+    result = uuid_clock_default_get_time(&time);
+    if (result == UUID_SUCCESS) {
+        ticks = (uuid_uint64)__rdtsc();
+
+        /* The longer the interval, the more accurate the rate. Only update it if the interval is reasonable. */
+        if (time > pClock->anchorTime + 1000000000 && ticks > pClock->anchorTicks) {
+            uuid_uint64 elapsedTime  = time  - pClock->anchorTime;
+            uuid_uint64 elapsedTicks = ticks - pClock->anchorTicks;
+
+            /* Don't overflow the fixed point conversion. Just keep the old rate if the interval is too long. */
+            if (elapsedTime < ((uuid_uint64)1 << 32)) {
+                uuid_atomic_store_64(&pClock->nanosecondsPerTick, (elapsedTime << 32) / elapsedTicks);
+            }
+        }
+
+        uuid_atomic_store_64(&pClock->anchorTime,  time);
+        uuid_atomic_store_64(&pClock->anchorTicks, ticks);
+    }
+
+    uuid_atomic_store_64(&pClock->sequence, sequence + 2);
+
+    return result;
+#else
+    (void)pClock;
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/* Cached Clock */
+static uuid_result uuid_clock_cached_get_time(uuid_clock* pClock, uuid_uint64* pTime)
+{
+    *pTime = uuid_atomic_load_64(&((uuid_clock_cached*)pClock)->time);
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_clock_cached_init(uuid_clock* pSource, uuid_clock_cached* pClock)
+{
+    if (pClock == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pClock);
+    pClock->base.onGetTime = uuid_clock_cached_get_time;
+    pClock->pSource        = pSource;
+
+    return uuid_clock_cached_update(pClock);
+}
+
+UUID_API uuid_result uuid_clock_cached_update(uuid_clock_cached* pClock)
+{
+    uuid_result result;
+    uuid_uint64 time;
+
+    if (pClock == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_clock_get_time(pClock->pSource, &time);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    uuid_clock_cached_set(pClock, time);
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_clock_cached_set(uuid_clock_cached* pClock, uuid_uint64 time)
+{
+    if (pClock == NULL) {
+        return;
+    }
+
+    uuid_atomic_exchange_64(&pClock->time, time);
+}
+
+UUID_API void uuid_clock_cached_advance(uuid_clock_cached* pClock, uuid_uint64 nanoseconds)
+{
+    uuid_uint64 time;
+
+    if (pClock == NULL) {
+        return;
+    }
+
+    do {
+        time = uuid_atomic_load_64(&pClock->time);
+    } while (!uuid_atomic_compare_exchange_64(&pClock->time, time, time + nanoseconds));
+}
+
+
+/* ChaCha20 */
+#define UUID_CHACHA_ROTL32(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+#define UUID_CHACHA_QR(a, b, c, d) \
+    a += b; d ^= a; d = UUID_CHACHA_ROTL32(d, 16); \
+    c += d; b ^= c; b = UUID_CHACHA_ROTL32(b, 12); \
+    a += b; d ^= a; d = UUID_CHACHA_ROTL32(d,  8); \
+    c += d; b ^= c; b = UUID_CHACHA_ROTL32(b,  7)
+
+static void uuid_chacha20_block(const uuid_uint32* pKey, uuid_uint32 counter, unsigned char* pOut)
+{
+    uuid_uint32 input[16];
+    uuid_uint32 x[16];
+    int i;
+
+    /* "expand 32-byte k" */
+    input[ 0] = 0x61707865;
+    input[ 1] = 0x3320646e;
+    input[ 2] = 0x79622d32;
+    input[ 3] = 0x6b206574;
+    input[ 4] = pKey[0];
+    input[ 5] = pKey[1];
+    input[ 6] = pKey[2];
+    input[ 7] = pKey[3];
+    input[ 8] = pKey[4];
+    input[ 9] = pKey[5];
+    input[10] = pKey[6];
+    input[11] = pKey[7];
+    input[12] = counter;
+    input[13] = 0;  /* Nonce. A new key is used for every buffer so the nonce can always be zero. */
+    input[14] = 0;
+    input[15] = 0;
+
+    for (i = 0; i < 16; i += 1) {
+        x[i] = input[i];
+    }
+
+    for (i = 0; i < 10; i += 1) {
+        UUID_CHACHA_QR(x[0], x[4], x[ 8], x[12]);
+        UUID_CHACHA_QR(x[1], x[5], x[ 9], x[13]);
+        UUID_CHACHA_QR(x[2], x[6], x[10], x[14]);
+        UUID_CHACHA_QR(x[3], x[7], x[11], x[15]);
+        UUID_CHACHA_QR(x[0], x[5], x[10], x[15]);
+        UUID_CHACHA_QR(x[1], x[6], x[11], x[12]);
+        UUID_CHACHA_QR(x[2], x[7], x[ 8], x[13]);
+        UUID_CHACHA_QR(x[3], x[4], x[ 9], x[14]);
+    }
+
+    for (i = 0; i < 16; i += 1) {
+        uuid_uint32 v = x[i] + input[i];
+        pOut[i*4 + 0] = (unsigned char)((v >>  0) & 0xFF);
+        pOut[i*4 + 1] = (unsigned char)((v >>  8) & 0xFF);
+        pOut[i*4 + 2] = (unsigned char)((v >> 16) & 0xFF);
+        pOut[i*4 + 3] = (unsigned char)((v >> 24) & 0xFF);
+    }
+
+    UUID_ZERO_MEMORY(x, sizeof(x));
+}
+
+static void uuid_chacha_rng_set_key(uuid_chacha_rng* pRNG, const unsigned char* pKeyBytes, int mix)
+{
+    int i;
+
+    for (i = 0; i < 8; i += 1) {
+        uuid_uint32 k =
+            ((uuid_uint32)pKeyBytes[i*4 + 0] <<  0) |
+            ((uuid_uint32)pKeyBytes[i*4 + 1] <<  8) |
+            ((uuid_uint32)pKeyBytes[i*4 + 2] << 16) |
+            ((uuid_uint32)pKeyBytes[i*4 + 3] << 24);
+
+        if (mix) {
+            pRNG->key[i] ^= k;
+        } else {
+            pRNG->key[i]  = k;
+        }
+    }
+}
+
+static void uuid_chacha_rng_refill(uuid_chacha_rng* pRNG)
+{
+    uuid_uint32 iBlock;
+
+    for (iBlock = 0; iBlock < UUID_CHACHA_RNG_BUFFER_SIZE / 64; iBlock += 1) {
+        uuid_chacha20_block(pRNG->key, iBlock, pRNG->buffer + (iBlock * 64));
+    }
+
+    /* Fast key erasure. The first 32 bytes become the new key and are never handed out. */
+    uuid_chacha_rng_set_key(pRNG, pRNG->buffer, 0);
+    UUID_ZERO_MEMORY(pRNG->buffer, 32);
+    pRNG->cursor = 32;
+}
+
+static int uuid_chacha_rng_needs_reseed(uuid_chacha_rng* pRNG)
+{
+    if (pRNG->forkGeneration != uuid_get_fork_generation()) {
+        return 1;
+    }
+
+    if (pRNG->config.reseedIntervalInBytes > 0 && pRNG->bytesSinceReseed >= pRNG->config.reseedIntervalInBytes) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int uuid_chacha_rng_needs_timed_reseed(uuid_chacha_rng* pRNG)
+{
+    uuid_uint64 time;
+
+    if (pRNG->config.reseedIntervalInMilliseconds == 0) {
+        return 0;
+    }
+
+    if (uuid_get_time(&time) != UUID_SUCCESS) {
+        return 0;   /* Can't get the time. Just keep going with the byte based policy. */
+    }
+
+    return (time - pRNG->timeOfLastReseed) >= ((uuid_uint64)pRNG->config.reseedIntervalInMilliseconds * 10000);
+}
+
+static uuid_result uuid_chacha_rng_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
+{
+    uuid_result result;
+    uuid_chacha_rng* pChaChaRNG = (uuid_chacha_rng*)pRNG;
+    unsigned char* pRunningBufferOut = (unsigned char*)pBufferOut;
+
+    if (pChaChaRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (uuid_chacha_rng_needs_reseed(pChaChaRNG)) {
+        result = uuid_chacha_rng_reseed(pChaChaRNG);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+    }
+
+    while (byteCount > 0) {
+        size_t bytesAvailable;
+        size_t bytesToCopy;
+
+        if (pChaChaRNG->cursor == UUID_CHACHA_RNG_BUFFER_SIZE) {
+            /* The clock is only checked when refilling so we're not reading the time on every call. */
+            if (uuid_chacha_rng_needs_timed_reseed(pChaChaRNG)) {
+                result = uuid_chacha_rng_reseed(pChaChaRNG);
+                if (result != UUID_SUCCESS) {
+                    return result;
+                }
+            } else {
+                uuid_chacha_rng_refill(pChaChaRNG);
+            }
+        }
+
+        bytesAvailable = UUID_CHACHA_RNG_BUFFER_SIZE - pChaChaRNG->cursor;
+        bytesToCopy    = byteCount;
+        if (bytesToCopy > bytesAvailable) {
+            bytesToCopy = bytesAvailable;
+        }
+
+        UUID_COPY_MEMORY(pRunningBufferOut, pChaChaRNG->buffer + pChaChaRNG->cursor, bytesToCopy);
+        UUID_ZERO_MEMORY(pChaChaRNG->buffer + pChaChaRNG->cursor, bytesToCopy);
+
+        pChaChaRNG->cursor           += bytesToCopy;
+        pChaChaRNG->bytesSinceReseed += bytesToCopy;
+        pRunningBufferOut            += bytesToCopy;
+        byteCount                    -= bytesToCopy;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_chacha_rng_config uuid_chacha_rng_config_init(uuid_rand* pSeedRNG)
+{
+    uuid_chacha_rng_config config;
+
+    UUID_ZERO_OBJECT(&config);
+    config.pSeedRNG                     = pSeedRNG;
+    config.reseedIntervalInBytes        = 1024 * 1024 * 64;
+    config.reseedIntervalInMilliseconds = 1000 * 60 * 5;
+
+    return config;
+}
+
+UUID_API uuid_result uuid_chacha_rng_init(const uuid_chacha_rng_config* pConfig, uuid_chacha_rng* pRNG)
+{
+    uuid_result result;
+
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pRNG);
+
+    if (pConfig == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+#if !defined(UUID_HAS_DEFAULT_RNG)
+    if (pConfig->pSeedRNG == NULL) {
+        return UUID_INVALID_ARGS;   /* No default random number generator available. */
+    }
+#endif
+
+    uuid_fork_detection_init();
+
+    pRNG->base.onGenerate = uuid_chacha_rng_generate;
+    pRNG->config          = *pConfig;
+
+    result = uuid_chacha_rng_reseed(pRNG);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_OBJECT(pRNG);
+        return result;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_chacha_rng_uninit(uuid_chacha_rng* pRNG)
+{
+    if (pRNG == NULL) {
+        return;
+    }
+
+    UUID_ZERO_OBJECT(pRNG);
+}
+
+UUID_API uuid_result uuid_chacha_rng_reseed(uuid_chacha_rng* pRNG)
+{
+    uuid_result result;
+    unsigned char seed[32];
+
+    if (pRNG == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_rand_generate_or_default(pRNG->config.pSeedRNG, seed, sizeof(seed));
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    /* The seed is mixed into the existing key rather than replacing it. */
+    uuid_chacha_rng_set_key(pRNG, seed, 1);
+    UUID_ZERO_MEMORY(seed, sizeof(seed));
+
+    /* Anything left in the buffer was derived from the old key and needs to be thrown away. */
+    uuid_chacha_rng_refill(pRNG);
+
+    pRNG->bytesSinceReseed = 0;
+    pRNG->forkGeneration   = uuid_get_fork_generation();
+
+    if (uuid_get_time(&pRNG->timeOfLastReseed) != UUID_SUCCESS) {
+        pRNG->timeOfLastReseed = 0;
+    }
+
+    return UUID_SUCCESS;
+}
+
+
+static void uuid1_set_time(unsigned char* pUUID, uuid_uint64 time)
+{
+    uuid_uint32 timeLow;
+    uuid_uint16 timeMid;
+    uuid_uint16 timeHiAndVersion;
+
+    timeLow          = (uuid_uint32) ((time >>  0) & 0xFFFFFFFF);
+    timeMid          = (uuid_uint16) ((time >> 32) & 0x0000FFFF);
+    timeHiAndVersion = (uuid_uint16)(((time >> 48) & 0x00000FFF) | 0x1000);
+
+    /* Time Low */
+    pUUID[0] = (unsigned char)((timeLow >> 24) & 0xFF);
+    pUUID[1] = (unsigned char)((timeLow >> 16) & 0xFF);
+    pUUID[2] = (unsigned char)((timeLow >>  8) & 0xFF);
+    pUUID[3] = (unsigned char)((timeLow >>  0) & 0xFF);
+
+    /* Time Mid */
+    pUUID[4] = (unsigned char)((timeMid >> 8) & 0xFF);
+    pUUID[5] = (unsigned char)((timeMid >> 0) & 0xFF);
+
+    /* Time High and Version */
+    pUUID[6] = (unsigned char)((timeHiAndVersion >> 8) & 0xFF);
+    pUUID[7] = (unsigned char)((timeHiAndVersion >> 0) & 0xFF);
+}
+
+static uuid_result uuid1_internal(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    uuid_result result;
+    uuid_uint64 time;
+
+    UUID_ASSERT(pUUID != NULL);
+    UUID_ASSERT(pRNG  != NULL);
+
+    result = uuid_get_time(&time);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    UUID_STATS_CHECK_SAME_TICK(time);
+    uuid1_set_time(pUUID, time);
+
+    /* For the clock sequence and node ID we're always using a random number. */
+    result = uuid_rand_generate(pRNG, pUUID + 8, UUID_SIZE - 8);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return result;
+    }
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+    return UUID_SUCCESS;
+}
+
+/*
+Multi-buffer MD5 and SHA-1 for uuid3_batch() and uuid5_batch(). These are built in rather than using
+the UUID_MD5_* and UUID_SHA1_* macros because hashing several names in parallel requires access to
+the compression function. Each lane hashes a different name.
+
+Each lane's block is stored contiguously, one after the other, and the SIMD kernels transpose them
+on load. The state is stored word-major with the lanes interleaved, so word `w` of lane `l` is at
+index `w*laneCount + l`, which allows it to be loaded for every lane with a single load. The
+compression functions are written once in terms of the UUID_HV_* macros which are defined for each
+vector type before instantiating the kernel. The scalar kernel is just a single lane.
+*/
+#define UUID_HASH_BLOCK_SIZE    64
+#define UUID_HASH_MAX_LANES     8
+
+static const uuid_uint32 uuid_g_md5K[64] =
+{
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const unsigned char uuid_g_md5Index[64] =
+{
+    0, 1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+    1, 6, 11,  0,  5, 10, 15,  4,  9, 14,  3,  8, 13,  2,  7, 12,
+    5, 8, 11, 14,  1,  4,  7, 10, 13,  0,  3,  6,  9, 12, 15,  2,
+    0, 7, 14,  5, 12,  3, 10,  1,  8, 15,  6, 13,  4, 11,  2,  9
+};
+
+static const uuid_uint32 uuid_g_md5Init[5]  = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0};
+static const uuid_uint32 uuid_g_sha1Init[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+static uuid_uint32 uuid_load_le32(const unsigned char* p)
+{
+    return ((uuid_uint32)p[0] << 0) | ((uuid_uint32)p[1] << 8) | ((uuid_uint32)p[2] << 16) | ((uuid_uint32)p[3] << 24);
+}
+
+static uuid_uint32 uuid_load_be32(const unsigned char* p)
+{
+    return ((uuid_uint32)p[0] << 24) | ((uuid_uint32)p[1] << 16) | ((uuid_uint32)p[2] << 8) | ((uuid_uint32)p[3] << 0);
+}
+
+static void uuid_store_le32(unsigned char* p, uuid_uint32 x)
+{
+    p[0] = (unsigned char)((x >>  0) & 0xFF);
+    p[1] = (unsigned char)((x >>  8) & 0xFF);
+    p[2] = (unsigned char)((x >> 16) & 0xFF);
+    p[3] = (unsigned char)((x >> 24) & 0xFF);
+}
+
+static void uuid_store_be32(unsigned char* p, uuid_uint32 x)
+{
+    p[0] = (unsigned char)((x >> 24) & 0xFF);
+    p[1] = (unsigned char)((x >> 16) & 0xFF);
+    p[2] = (unsigned char)((x >>  8) & 0xFF);
+    p[3] = (unsigned char)((x >>  0) & 0xFF);
+}
+
+static void uuid_store_le64(unsigned char* p, uuid_uint64 x)
+{
+    uuid_store_le32(p + 0, (uuid_uint32)(x >>  0));
+    uuid_store_le32(p + 4, (uuid_uint32)(x >> 32));
+}
+
+static void uuid_store_be64(unsigned char* p, uuid_uint64 x)
+{
+    uuid_store_be32(p + 0, (uuid_uint32)(x >> 32));
+    uuid_store_be32(p + 4, (uuid_uint32)(x >>  0));
+}
+
+
+#define UUID_MD5_F(b, c, d) UUID_HV_XOR(d, UUID_HV_AND(b, UUID_HV_XOR(c, d)))
+#define UUID_MD5_G(b, c, d) UUID_HV_XOR(c, UUID_HV_AND(d, UUID_HV_XOR(b, c)))
+#define UUID_MD5_H(b, c, d) UUID_HV_XOR(UUID_HV_XOR(b, c), d)
+#define UUID_MD5_I(b, c, d) UUID_HV_XOR(c, UUID_HV_OR(b, UUID_HV_NOT(d)))
+#define UUID_MD5_STEP(a, b, c, d, F, i, s) \
+    a = UUID_HV_ADD(b, UUID_HV_ROTL(UUID_HV_ADD(UUID_HV_ADD(a, F(b, c, d)), UUID_HV_ADD(UUID_HV_SET1(uuid_g_md5K[i]), x[uuid_g_md5Index[i]])), s))
+#define UUID_MD5_STEP4(F, i, s0, s1, s2, s3) \
+    UUID_MD5_STEP(a, b, c, d, F, (i) + 0, s0); \
+    UUID_MD5_STEP(d, a, b, c, F, (i) + 1, s1); \
+    UUID_MD5_STEP(c, d, a, b, F, (i) + 2, s2); \
+    UUID_MD5_STEP(b, c, d, a, F, (i) + 3, s3)
+
+#define UUID_MD5_COMPRESS_BODY \
+{ \
+    UUID_HV x[16]; \
+    UUID_HV a, b, c, d; \
+    \
+    UUID_HV_LOAD_BLOCKS_LE(x, pBlocks); \
+    \
+    a = UUID_HV_LOAD(pState + 0*UUID_HV_LANES); \
+    b = UUID_HV_LOAD(pState + 1*UUID_HV_LANES); \
+    c = UUID_HV_LOAD(pState + 2*UUID_HV_LANES); \
+    d = UUID_HV_LOAD(pState + 3*UUID_HV_LANES); \
+    \
+    UUID_MD5_STEP4(UUID_MD5_F,  0, 7, 12, 17, 22); \
+    UUID_MD5_STEP4(UUID_MD5_F,  4, 7, 12, 17, 22); \
+    UUID_MD5_STEP4(UUID_MD5_F,  8, 7, 12, 17, 22); \
+    UUID_MD5_STEP4(UUID_MD5_F, 12, 7, 12, 17, 22); \
+    UUID_MD5_STEP4(UUID_MD5_G, 16, 5,  9, 14, 20); \
+    UUID_MD5_STEP4(UUID_MD5_G, 20, 5,  9, 14, 20); \
+    UUID_MD5_STEP4(UUID_MD5_G, 24, 5,  9, 14, 20); \
+    UUID_MD5_STEP4(UUID_MD5_G, 28, 5,  9, 14, 20); \
+    UUID_MD5_STEP4(UUID_MD5_H, 32, 4, 11, 16, 23); \
+    UUID_MD5_STEP4(UUID_MD5_H, 36, 4, 11, 16, 23); \
+    UUID_MD5_STEP4(UUID_MD5_H, 40, 4, 11, 16, 23); \
+    UUID_MD5_STEP4(UUID_MD5_H, 44, 4, 11, 16, 23); \
+    UUID_MD5_STEP4(UUID_MD5_I, 48, 6, 10, 15, 21); \
+    UUID_MD5_STEP4(UUID_MD5_I, 52, 6, 10, 15, 21); \
+    UUID_MD5_STEP4(UUID_MD5_I, 56, 6, 10, 15, 21); \
+    UUID_MD5_STEP4(UUID_MD5_I, 60, 6, 10, 15, 21); \
+    \
+    UUID_HV_STORE(pState + 0*UUID_HV_LANES, UUID_HV_ADD(a, UUID_HV_LOAD(pState + 0*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 1*UUID_HV_LANES, UUID_HV_ADD(b, UUID_HV_LOAD(pState + 1*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 2*UUID_HV_LANES, UUID_HV_ADD(c, UUID_HV_LOAD(pState + 2*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 3*UUID_HV_LANES, UUID_HV_ADD(d, UUID_HV_LOAD(pState + 3*UUID_HV_LANES))); \
+}
+
+#define UUID_SHA1_F1(b, c, d)   UUID_HV_XOR(d, UUID_HV_AND(b, UUID_HV_XOR(c, d)))
+#define UUID_SHA1_F2(b, c, d)   UUID_HV_XOR(UUID_HV_XOR(b, c), d)
+#define UUID_SHA1_F3(b, c, d)   UUID_HV_OR(UUID_HV_AND(b, c), UUID_HV_AND(d, UUID_HV_OR(b, c)))
+#define UUID_SHA1_W0(i)         w[i]
+#define UUID_SHA1_W(i)          (w[(i) & 15] = UUID_HV_ROTL(UUID_HV_XOR(UUID_HV_XOR(w[((i) - 3) & 15], w[((i) - 8) & 15]), UUID_HV_XOR(w[((i) - 14) & 15], w[(i) & 15])), 1))
+#define UUID_SHA1_STEP(a, b, c, d, e, F, k, x) \
+    e = UUID_HV_ADD(UUID_HV_ADD(e, UUID_HV_ROTL(a, 5)), UUID_HV_ADD(F(b, c, d), UUID_HV_ADD(k, x))); \
+    b = UUID_HV_ROTL(b, 30)
+#define UUID_SHA1_STEP5(F, k, i, W) \
+    UUID_SHA1_STEP(a, b, c, d, e, F, k, W((i) + 0)); \
+    UUID_SHA1_STEP(e, a, b, c, d, F, k, W((i) + 1)); \
+    UUID_SHA1_STEP(d, e, a, b, c, F, k, W((i) + 2)); \
+    UUID_SHA1_STEP(c, d, e, a, b, F, k, W((i) + 3)); \
+    UUID_SHA1_STEP(b, c, d, e, a, F, k, W((i) + 4))
+
+#define UUID_SHA1_COMPRESS_BODY \
+{ \
+    UUID_HV w[16]; \
+    UUID_HV a, b, c, d, e, k; \
+    \
+    UUID_HV_LOAD_BLOCKS_BE(w, pBlocks); \
+    \
+    a = UUID_HV_LOAD(pState + 0*UUID_HV_LANES); \
+    b = UUID_HV_LOAD(pState + 1*UUID_HV_LANES); \
+    c = UUID_HV_LOAD(pState + 2*UUID_HV_LANES); \
+    d = UUID_HV_LOAD(pState + 3*UUID_HV_LANES); \
+    e = UUID_HV_LOAD(pState + 4*UUID_HV_LANES); \
+    \
+    k = UUID_HV_SET1(0x5a827999); \
+    UUID_SHA1_STEP5(UUID_SHA1_F1, k,  0, UUID_SHA1_W0); \
+    UUID_SHA1_STEP5(UUID_SHA1_F1, k,  5, UUID_SHA1_W0); \
+    UUID_SHA1_STEP5(UUID_SHA1_F1, k, 10, UUID_SHA1_W0); \
+    UUID_SHA1_STEP(a, b, c, d, e, UUID_SHA1_F1, k, w[15]); \
+    UUID_SHA1_STEP(e, a, b, c, d, UUID_SHA1_F1, k, UUID_SHA1_W(16)); \
+    UUID_SHA1_STEP(d, e, a, b, c, UUID_SHA1_F1, k, UUID_SHA1_W(17)); \
+    UUID_SHA1_STEP(c, d, e, a, b, UUID_SHA1_F1, k, UUID_SHA1_W(18)); \
+    UUID_SHA1_STEP(b, c, d, e, a, UUID_SHA1_F1, k, UUID_SHA1_W(19)); \
+    k = UUID_HV_SET1(0x6ed9eba1); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 20, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 25, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 30, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 35, UUID_SHA1_W); \
+    k = UUID_HV_SET1(0x8f1bbcdc); \
+    UUID_SHA1_STEP5(UUID_SHA1_F3, k, 40, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F3, k, 45, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F3, k, 50, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F3, k, 55, UUID_SHA1_W); \
+    k = UUID_HV_SET1(0xca62c1d6); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 60, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 65, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 70, UUID_SHA1_W); \
+    UUID_SHA1_STEP5(UUID_SHA1_F2, k, 75, UUID_SHA1_W); \
+    \
+    UUID_HV_STORE(pState + 0*UUID_HV_LANES, UUID_HV_ADD(a, UUID_HV_LOAD(pState + 0*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 1*UUID_HV_LANES, UUID_HV_ADD(b, UUID_HV_LOAD(pState + 1*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 2*UUID_HV_LANES, UUID_HV_ADD(c, UUID_HV_LOAD(pState + 2*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 3*UUID_HV_LANES, UUID_HV_ADD(d, UUID_HV_LOAD(pState + 3*UUID_HV_LANES))); \
+    UUID_HV_STORE(pState + 4*UUID_HV_LANES, UUID_HV_ADD(e, UUID_HV_LOAD(pState + 4*UUID_HV_LANES))); \
+}
+
+
+/* Scalar. */
+#define UUID_HV                 uuid_uint32
+#define UUID_HV_LANES           1
+#define UUID_HV_LOAD(p)         (*(p))
+#define UUID_HV_STORE(p, x)     (*(p) = (x))
+#define UUID_HV_SET1(x)         ((uuid_uint32)(x))
+#define UUID_HV_ADD(a, b)       ((uuid_uint32)((a) + (b)))
+#define UUID_HV_XOR(a, b)       ((a) ^ (b))
+#define UUID_HV_AND(a, b)       ((a) & (b))
+#define UUID_HV_OR(a, b)        ((a) | (b))
+#define UUID_HV_NOT(a)          (~(a))
+#define UUID_HV_ROTL(x, n)      (((x) << (n)) | ((x) >> (32 - (n))))
+#define UUID_HV_LOAD_BLOCKS_LE(x, pBlocks) { int iWord; for (iWord = 0; iWord < 16; iWord += 1) { x[iWord] = uuid_load_le32(pBlocks + iWord*4); } }
+#define UUID_HV_LOAD_BLOCKS_BE(x, pBlocks) { int iWord; for (iWord = 0; iWord < 16; iWord += 1) { x[iWord] = uuid_load_be32(pBlocks + iWord*4); } }
+
+static void uuid_md5_compress(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_MD5_COMPRESS_BODY
+
+static void uuid_sha1_compress(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_SHA1_COMPRESS_BODY
+
+#undef UUID_HV
+#undef UUID_HV_LANES
+#undef UUID_HV_LOAD
+#undef UUID_HV_STORE
+#undef UUID_HV_SET1
+#undef UUID_HV_ADD
+#undef UUID_HV_XOR
+#undef UUID_HV_AND
+#undef UUID_HV_OR
+#undef UUID_HV_NOT
+#undef UUID_HV_ROTL
+#undef UUID_HV_LOAD_BLOCKS_LE
+#undef UUID_HV_LOAD_BLOCKS_BE
+
+
+/* SSE2. 4 lanes. */
+#if defined(UUID_SUPPORT_SSE2)
+#define UUID_HV                 __m128i
+#define UUID_HV_LANES           4
+#define UUID_HV_LOAD(p)         _mm_loadu_si128((const __m128i*)(p))
+#define UUID_HV_STORE(p, x)     _mm_storeu_si128((__m128i*)(p), (x))
+#define UUID_HV_SET1(x)         _mm_set1_epi32((int)(x))
+#define UUID_HV_ADD(a, b)       _mm_add_epi32((a), (b))
+#define UUID_HV_XOR(a, b)       _mm_xor_si128((a), (b))
+#define UUID_HV_AND(a, b)       _mm_and_si128((a), (b))
+#define UUID_HV_OR(a, b)        _mm_or_si128((a), (b))
+#define UUID_HV_NOT(a)          _mm_xor_si128((a), _mm_set1_epi32(-1))
+#define UUID_HV_ROTL(x, n)      _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+#define UUID_HV_LOAD_BLOCKS_LE(x, pBlocks) uuid_hash_load_blocks_x4_sse2(x, pBlocks, 0)
+#define UUID_HV_LOAD_BLOCKS_BE(x, pBlocks) uuid_hash_load_blocks_x4_sse2(x, pBlocks, 1)
+
+static void uuid_hash_load_blocks_x4_sse2(__m128i* x, const unsigned char* pBlocks, int isBigEndian)
+{
+    int i;
+
+    /* 4x4 transposes of each group of 4 words. */
+    for (i = 0; i < 16; i += 4) {
+        __m128i r0 = _mm_loadu_si128((const __m128i*)(pBlocks + 0*UUID_HASH_BLOCK_SIZE + i*4));
+        __m128i r1 = _mm_loadu_si128((const __m128i*)(pBlocks + 1*UUID_HASH_BLOCK_SIZE + i*4));
+        __m128i r2 = _mm_loadu_si128((const __m128i*)(pBlocks + 2*UUID_HASH_BLOCK_SIZE + i*4));
+        __m128i r3 = _mm_loadu_si128((const __m128i*)(pBlocks + 3*UUID_HASH_BLOCK_SIZE + i*4));
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+        x[i + 0] = _mm_unpacklo_epi64(t0, t1);
+        x[i + 1] = _mm_unpackhi_epi64(t0, t1);
+        x[i + 2] = _mm_unpacklo_epi64(t2, t3);
+        x[i + 3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    if (isBigEndian) {
+        for (i = 0; i < 16; i += 1) {
+            __m128i v = _mm_or_si128(_mm_slli_epi16(x[i], 8), _mm_srli_epi16(x[i], 8));
+            x[i] = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+        }
+    }
+}
+
+static void uuid_md5_compress_x4_sse2(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_MD5_COMPRESS_BODY
+
+static void uuid_sha1_compress_x4_sse2(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_SHA1_COMPRESS_BODY
+
+#undef UUID_HV
+#undef UUID_HV_LANES
+#undef UUID_HV_LOAD
+#undef UUID_HV_STORE
+#undef UUID_HV_SET1
+#undef UUID_HV_ADD
+#undef UUID_HV_XOR
+#undef UUID_HV_AND
+#undef UUID_HV_OR
+#undef UUID_HV_NOT
+#undef UUID_HV_ROTL
+#undef UUID_HV_LOAD_BLOCKS_LE
+#undef UUID_HV_LOAD_BLOCKS_BE
+#endif
+
+
+/* AVX2. 8 lanes. */
+#if defined(UUID_SUPPORT_AVX2)
+#define UUID_HV                 __m256i
+#define UUID_HV_LANES           8
+#define UUID_HV_LOAD(p)         _mm256_loadu_si256((const __m256i*)(p))
+#define UUID_HV_STORE(p, x)     _mm256_storeu_si256((__m256i*)(p), (x))
+#define UUID_HV_SET1(x)         _mm256_set1_epi32((int)(x))
+#define UUID_HV_ADD(a, b)       _mm256_add_epi32((a), (b))
+#define UUID_HV_XOR(a, b)       _mm256_xor_si256((a), (b))
+#define UUID_HV_AND(a, b)       _mm256_and_si256((a), (b))
+#define UUID_HV_OR(a, b)        _mm256_or_si256((a), (b))
+#define UUID_HV_NOT(a)          _mm256_xor_si256((a), _mm256_set1_epi32(-1))
+#define UUID_HV_ROTL(x, n)      _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+#define UUID_HV_LOAD_BLOCKS_LE(x, pBlocks) uuid_hash_load_blocks_x8_avx2(x, pBlocks, 0)
+#define UUID_HV_LOAD_BLOCKS_BE(x, pBlocks) uuid_hash_load_blocks_x8_avx2(x, pBlocks, 1)
+
+static UUID_TARGET_AVX2 void uuid_hash_load_blocks_x8_avx2(__m256i* x, const unsigned char* pBlocks, int isBigEndian)
+{
+    int i;
+
+    /* 8x8 transposes of each group of 8 words. */
+    for (i = 0; i < 16; i += 8) {
+        __m256i r0 = _mm256_loadu_si256((const __m256i*)(pBlocks + 0*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r1 = _mm256_loadu_si256((const __m256i*)(pBlocks + 1*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r2 = _mm256_loadu_si256((const __m256i*)(pBlocks + 2*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r3 = _mm256_loadu_si256((const __m256i*)(pBlocks + 3*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r4 = _mm256_loadu_si256((const __m256i*)(pBlocks + 4*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r5 = _mm256_loadu_si256((const __m256i*)(pBlocks + 5*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r6 = _mm256_loadu_si256((const __m256i*)(pBlocks + 6*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i r7 = _mm256_loadu_si256((const __m256i*)(pBlocks + 7*UUID_HASH_BLOCK_SIZE + i*4));
+        __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+        __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+        __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+        __m256i t4 = _mm256_unpacklo_epi32(r4, r5);
+        __m256i t5 = _mm256_unpackhi_epi32(r4, r5);
+        __m256i t6 = _mm256_unpacklo_epi32(r6, r7);
+        __m256i t7 = _mm256_unpackhi_epi32(r6, r7);
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+        x[i + 0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        x[i + 1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        x[i + 2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        x[i + 3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        x[i + 4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        x[i + 5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        x[i + 6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        x[i + 7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+
+    if (isBigEndian) {
+        __m256i mask = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+        for (i = 0; i < 16; i += 1) {
+            x[i] = _mm256_shuffle_epi8(x[i], mask);
+        }
+    }
+}
+
+static UUID_TARGET_AVX2 void uuid_md5_compress_x8_avx2(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_MD5_COMPRESS_BODY
+
+static UUID_TARGET_AVX2 void uuid_sha1_compress_x8_avx2(uuid_uint32* pState, const unsigned char* pBlocks)
+UUID_SHA1_COMPRESS_BODY
+
+#undef UUID_HV
+#undef UUID_HV_LANES
+#undef UUID_HV_LOAD
+#undef UUID_HV_STORE
+#undef UUID_HV_SET1
+#undef UUID_HV_ADD
+#undef UUID_HV_XOR
+#undef UUID_HV_AND
+#undef UUID_HV_OR
+#undef UUID_HV_NOT
+#undef UUID_HV_ROTL
+#undef UUID_HV_LOAD_BLOCKS_LE
+#undef UUID_HV_LOAD_BLOCKS_BE
+#endif
+
+/*
+SHA-1 using the SHA extensions. This is a single buffer, but is faster than the multi-buffer kernels.
+Each step does 4 rounds. The message schedule is interleaved with the rounds.
+*/
+#if defined(UUID_SUPPORT_SHA)
+#define UUID_SHA1_SHANI_STEP(e0, e1, msg, f) \
+    e0   = _mm_sha1nexte_epu32(e0, msg); \
+    e1   = abcd; \
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, f)
+
+#define UUID_SHA1_SHANI_SCHEDULE(m0, m1, m2, m3) \
+    m1 = _mm_sha1msg2_epu32(m1, m0); \
+    m3 = _mm_sha1msg1_epu32(m3, m0); \
+    m2 = _mm_xor_si128(m2, m0)
+
+static UUID_TARGET_SHA void uuid_sha1_compress_shani(uuid_uint32* pState, const unsigned char* pBlocks)
+{
+    __m128i mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i abcd;
+    __m128i abcdSaved;
+    __m128i e0;
+    __m128i e0Saved;
+    __m128i e1;
+    __m128i msg0;
+    __m128i msg1;
+    __m128i msg2;
+    __m128i msg3;
+
+    abcd      = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)pState), 0x1B);
+    e0        = _mm_set_epi32((int)pState[4], 0, 0, 0);
+    abcdSaved = abcd;
+    e0Saved   = e0;
+
+    msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pBlocks +  0)), mask);
+    msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pBlocks + 16)), mask);
+    msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pBlocks + 32)), mask);
+    msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pBlocks + 48)), mask);
+
+    /* Rounds 0-15. */
+    e0   = _mm_add_epi32(e0, msg0);
+    e1   = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    UUID_SHA1_SHANI_STEP(e1, e0, msg1, 0);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+    UUID_SHA1_SHANI_STEP(e0, e1, msg2, 0);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    UUID_SHA1_SHANI_STEP(e1, e0, msg3, 0);
+    msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+    msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+    msg1 = _mm_xor_si128(msg1, msg3);
+
+    /* Rounds 16-67. The message schedule rotates through the 4 registers. */
+    UUID_SHA1_SHANI_STEP(e0, e1, msg0, 0); UUID_SHA1_SHANI_SCHEDULE(msg0, msg1, msg2, msg3);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg1, 1); UUID_SHA1_SHANI_SCHEDULE(msg1, msg2, msg3, msg0);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg2, 1); UUID_SHA1_SHANI_SCHEDULE(msg2, msg3, msg0, msg1);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg3, 1); UUID_SHA1_SHANI_SCHEDULE(msg3, msg0, msg1, msg2);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg0, 1); UUID_SHA1_SHANI_SCHEDULE(msg0, msg1, msg2, msg3);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg1, 1); UUID_SHA1_SHANI_SCHEDULE(msg1, msg2, msg3, msg0);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg2, 2); UUID_SHA1_SHANI_SCHEDULE(msg2, msg3, msg0, msg1);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg3, 2); UUID_SHA1_SHANI_SCHEDULE(msg3, msg0, msg1, msg2);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg0, 2); UUID_SHA1_SHANI_SCHEDULE(msg0, msg1, msg2, msg3);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg1, 2); UUID_SHA1_SHANI_SCHEDULE(msg1, msg2, msg3, msg0);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg2, 2); UUID_SHA1_SHANI_SCHEDULE(msg2, msg3, msg0, msg1);
+    UUID_SHA1_SHANI_STEP(e1, e0, msg3, 3); UUID_SHA1_SHANI_SCHEDULE(msg3, msg0, msg1, msg2);
+    UUID_SHA1_SHANI_STEP(e0, e1, msg0, 3); UUID_SHA1_SHANI_SCHEDULE(msg0, msg1, msg2, msg3);
+
+    /* Rounds 68-79. */
+    UUID_SHA1_SHANI_STEP(e1, e0, msg1, 3);
+    msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+    msg3 = _mm_xor_si128(msg3, msg1);
+
+    UUID_SHA1_SHANI_STEP(e0, e1, msg2, 3);
+    msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+
+    UUID_SHA1_SHANI_STEP(e1, e0, msg3, 3);
+
+    /* Add to the previous state. */
+    e0   = _mm_sha1nexte_epu32(e0, e0Saved);
+    abcd = _mm_add_epi32(abcd, abcdSaved);
+
+    _mm_storeu_si128((__m128i*)pState, _mm_shuffle_epi32(abcd, 0x1B));
+    pState[4] = (uuid_uint32)_mm_cvtsi128_si32(_mm_shuffle_epi32(e0, 0xFF));
+}
+#endif
+
+
+/*
+Builds block `blockIndex` of the padded message made up of the namespace followed by the name. The
+length is appended in big-endian for SHA-1 and little-endian for MD5.
+*/
+static void uuid_hash_build_block(unsigned char* pBlock, const unsigned char* pNamespaceUUID, const unsigned char* pName, size_t nameLen, size_t blockIndex, size_t blockCount, int isBigEndian)
+{
+    size_t messageLen = UUID_SIZE + nameLen;
+    size_t offset = blockIndex * UUID_HASH_BLOCK_SIZE;
+    size_t i = 0;
+
+    UUID_ZERO_MEMORY(pBlock, UUID_HASH_BLOCK_SIZE);
+
+    if (blockIndex == 0) {
+        UUID_COPY_MEMORY(pBlock, pNamespaceUUID, UUID_SIZE);
+        i = UUID_SIZE;
+    }
+
+    if (offset + i < messageLen) {
+        size_t bytesToCopy = messageLen - (offset + i);
+        if (bytesToCopy > UUID_HASH_BLOCK_SIZE - i) {
+            bytesToCopy = UUID_HASH_BLOCK_SIZE - i;
+        }
+
+        UUID_COPY_MEMORY(pBlock + i, pName + (offset + i - UUID_SIZE), bytesToCopy);
+        i += bytesToCopy;
+    }
+
+    if (i < UUID_HASH_BLOCK_SIZE && offset + i == messageLen) {
+        pBlock[i] = 0x80;
+    }
+
+    /* The length in bits goes into the last 8 bytes of the last block. */
+    if (blockIndex == blockCount - 1) {
+        uuid_uint64 bitCount = (uuid_uint64)messageLen * 8;
+
+        if (isBigEndian) {
+            uuid_store_be32(pBlock + 56, (uuid_uint32)(bitCount >> 32));
+            uuid_store_be32(pBlock + 60, (uuid_uint32)(bitCount & 0xFFFFFFFF));
+        } else {
+            uuid_store_le32(pBlock + 56, (uuid_uint32)(bitCount & 0xFFFFFFFF));
+            uuid_store_le32(pBlock + 60, (uuid_uint32)(bitCount >> 32));
+        }
+    }
+}
+
+/*
+The lane scheduler. Each lane works through the blocks of its own name, and as soon as a lane is
+finished it writes out its UUID and picks up the next name. This keeps every lane busy when names
+are of different lengths. Idle lanes at the end of the batch are still compressed, but their results
+are ignored.
+*/
+static uuid_result uuid_hash_batch_internal(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths, int isSHA1, uuid_hash_compress_proc onCompress, size_t laneCount)
+{
+    uuid_uint32 blocksStorage[(UUID_HASH_BLOCK_SIZE/4 * UUID_HASH_MAX_LANES) + 8];
+    uuid_uint32 stateStorage[(5 * UUID_HASH_MAX_LANES) + 8];
+    unsigned char* blocks;
+    uuid_uint32* state;
+    size_t laneJob[UUID_HASH_MAX_LANES];
+    size_t laneNameLen[UUID_HASH_MAX_LANES];
+    size_t laneBlock[UUID_HASH_MAX_LANES];
+    size_t laneBlockCount[UUID_HASH_MAX_LANES];
+    const uuid_uint32* pInitialState = isSHA1 ? uuid_g_sha1Init : uuid_g_md5Init;
+    size_t nextJob = 0;
+    size_t activeLaneCount = 0;
+    size_t iLane;
+
+    UUID_ASSERT(laneCount <= UUID_HASH_MAX_LANES);
+
+    /*
+    Align to 32 bytes. The kernels store the state with vector stores and then it's read back per lane. If
+    a vector store straddles a cache line the store can't be forwarded to the following loads which is slow.
+    */
+    blocks = (unsigned char*)(((size_t)blocksStorage + 31) & ~(size_t)31);
+    state  = (uuid_uint32*  )(((size_t)stateStorage  + 31) & ~(size_t)31);
+
+    UUID_ZERO_MEMORY(blocks, UUID_HASH_BLOCK_SIZE * laneCount);   /* Idle lanes are still compressed. Keep the data defined. */
+    UUID_ZERO_MEMORY(state,  sizeof(uuid_uint32) * 5 * laneCount);
+
+    for (iLane = 0; iLane < laneCount; iLane += 1) {
+        laneJob[iLane] = count;                 /* count = idle. */
+    }
+
+    for (;;) {
+        /* Give any idle lanes a new name. */
+        for (iLane = 0; iLane < laneCount && nextJob < count; iLane += 1) {
+            if (laneJob[iLane] == count) {
+                if (ppNames[nextJob] == NULL) {
+                    return UUID_INVALID_ARGS;
+                }
+
+                laneJob[iLane]        = nextJob;
+                laneNameLen[iLane]    = (pNameLengths != NULL) ? pNameLengths[nextJob] : strlen(ppNames[nextJob]);
+                laneBlock[iLane]      = 0;
+                laneBlockCount[iLane] = (UUID_SIZE + laneNameLen[iLane] + 8) / UUID_HASH_BLOCK_SIZE + 1;
+
+                state[0*laneCount + iLane] = pInitialState[0];
+                state[1*laneCount + iLane] = pInitialState[1];
+                state[2*laneCount + iLane] = pInitialState[2];
+                state[3*laneCount + iLane] = pInitialState[3];
+                state[4*laneCount + iLane] = pInitialState[4];  /* Unused by MD5. */
+
+                nextJob += 1;
+                activeLaneCount += 1;
+            }
+        }
+
+        if (activeLaneCount == 0) {
+            return UUID_SUCCESS;
+        }
+
+        for (iLane = 0; iLane < laneCount; iLane += 1) {
+            if (laneJob[iLane] != count) {
+                uuid_hash_build_block(blocks + iLane*UUID_HASH_BLOCK_SIZE, pNamespaceUUID, (const unsigned char*)ppNames[laneJob[iLane]], laneNameLen[iLane], laneBlock[iLane], laneBlockCount[iLane], isSHA1);
+            }
+        }
+
+        onCompress(state, blocks);
+
+        for (iLane = 0; iLane < laneCount; iLane += 1) {
+            if (laneJob[iLane] != count) {
+                laneBlock[iLane] += 1;
+
+                if (laneBlock[iLane] == laneBlockCount[iLane]) {
+                    unsigned char* pUUID = pUUIDs + (laneJob[iLane] * UUID_SIZE);
+
+                    /* Only the first 16 bytes of the digest are used. */
+                    if (isSHA1) {
+                        uuid_store_be32(pUUID +  0, state[0*laneCount + iLane]);
+                        uuid_store_be32(pUUID +  4, state[1*laneCount + iLane]);
+                        uuid_store_be32(pUUID +  8, state[2*laneCount + iLane]);
+                        uuid_store_be32(pUUID + 12, state[3*laneCount + iLane]);
+
+                        /* Byte 6 needs to be updated so the version number is set appropriately. */
+                        pUUID[6] = (unsigned char)(0x50 | (pUUID[6] & 0x0F));
+                    } else {
+                        uuid_store_le32(pUUID +  0, state[0*laneCount + iLane]);
+                        uuid_store_le32(pUUID +  4, state[1*laneCount + iLane]);
+                        uuid_store_le32(pUUID +  8, state[2*laneCount + iLane]);
+                        uuid_store_le32(pUUID + 12, state[3*laneCount + iLane]);
+
+                        /* Byte 6 needs to be updated so the version number is set appropriately. */
+                        pUUID[6] = (unsigned char)(0x30 | (pUUID[6] & 0x0F));
+                    }
+
+                    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+                    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+                    laneJob[iLane] = count;
+                    activeLaneCount -= 1;
+                }
+            }
+        }
+    }
+}
+
+/*
+A single name with a single buffer kernel. This is what the hardware accelerated SHA-1 uses for
+uuid5(). It skips the scheduler which is a significant part of the cost for short names.
+*/
+static void uuid5_compress_internal(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName, size_t nameLen, uuid_hash_compress_proc onCompress)
+{
+    unsigned char block[UUID_HASH_BLOCK_SIZE];
+    uuid_uint32 state[5];
+    size_t blockCount = (UUID_SIZE + nameLen + 8) / UUID_HASH_BLOCK_SIZE + 1;
+    size_t iBlock;
+
+    UUID_COPY_MEMORY(state, uuid_g_sha1Init, sizeof(state));
+
+    for (iBlock = 0; iBlock < blockCount; iBlock += 1) {
+        uuid_hash_build_block(block, pNamespaceUUID, (const unsigned char*)pName, nameLen, iBlock, blockCount, 1);
+        onCompress(state, block);
+    }
+
+    uuid_store_be32(pUUID +  0, state[0]);
+    uuid_store_be32(pUUID +  4, state[1]);
+    uuid_store_be32(pUUID +  8, state[2]);
+    uuid_store_be32(pUUID + 12, state[3]);
+
+    /* Byte 6 needs to be updated so the version number is set appropriately. */
+    pUUID[6] = (unsigned char)(0x50 | (pUUID[6] & 0x0F));
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+}
+
+static uuid_result uuid_hash_names_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths, int isSHA1)
+{
+    uuid_result result;
+    const uuid_dispatch* pDispatch;
+    uuid_hash_compress_proc onCompress;
+    size_t laneCount;
+
+    if (pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (count > ((size_t)-1) / UUID_SIZE) {
+        return UUID_INVALID_ARGS;   /* Too big. */
+    }
+
+    if (pNamespaceUUID == NULL || (ppNames == NULL && count > 0)) {
+        UUID_ZERO_MEMORY(pUUIDs, count * UUID_SIZE);
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Use the widest kernel available. When there are only a few names, a single buffer avoids compressing idle lanes. */
+    pDispatch = uuid_get_dispatch();
+
+    if (isSHA1) {
+        onCompress = pDispatch->onSHA1Compress;
+        laneCount  = pDispatch->sha1LaneCount;
+    } else {
+        onCompress = pDispatch->onMD5Compress;
+        laneCount  = pDispatch->md5LaneCount;
+    }
+
+    if (count < laneCount) {
+        onCompress = isSHA1 ? pDispatch->onSHA1CompressSingle : uuid_md5_compress;
+        laneCount  = 1;
+    }
+
+    result = uuid_hash_batch_internal(pUUIDs, count, pNamespaceUUID, ppNames, pNameLengths, isSHA1, onCompress, laneCount);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUIDs, count * UUID_SIZE);    /* Don't leave a partially filled buffer. */
+    }
+
+    return result;
+}
+
+
+#if defined(UUID_MD5_CTX_TYPE)
+/* Makes sure the context fits in uuid_namespace. If this fails you need to increase UUID_NAMESPACE_CTX_SIZE. */
+typedef char uuid_md5_ctx_size_check[(sizeof(UUID_MD5_CTX_TYPE) <= UUID_NAMESPACE_CTX_SIZE) ? 1 : -1];
+
+static void uuid3_from_ctx(unsigned char* pUUID, UUID_MD5_CTX_TYPE* pCtx, const char* pName, size_t nameLen)
+{
+    unsigned char hash[16];
+
+    UUID_MD5_UPDATE(pCtx, (const unsigned char*)pName, nameLen);
+    UUID_MD5_FINAL(pCtx, hash);
+
+    UUID_COPY_MEMORY(pUUID, hash, UUID_SIZE);
+
+    /* Byte 6 needs to be updated so the version number is set appropriately. */
+    pUUID[6] = (unsigned char)(0x30 | (pUUID[6] & 0x0F));
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+}
+#endif
+
+static uuid_result uuid3_internal(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+{
+#if defined(UUID_MD5_CTX_TYPE)
+    UUID_MD5_CTX_TYPE ctx;
+
+    UUID_MD5_INIT(&ctx);
+    UUID_MD5_UPDATE(&ctx, pNamespaceUUID, UUID_SIZE);
+
+    uuid3_from_ctx(pUUID, &ctx, pName, strlen(pName));
+
+    return UUID_SUCCESS;
+#else
+    (void)pUUID;
+    (void)pNamespaceUUID;
+    (void)pName;
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+static uuid_result uuid4_internal(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    uuid_result result;
+
+    UUID_ASSERT(pUUID != NULL);
+    UUID_ASSERT(pRNG  != NULL);
+
+    /* First just generate some random numbers. */
+    result = uuid_rand_generate(pRNG, pUUID, UUID_SIZE);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return result;
+    }
+
+    /* Byte 6 needs to be updated so the version number is set appropriately. */
+    pUUID[6] = (unsigned char)(0x40 | (pUUID[6] & 0x0F));
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+    return UUID_SUCCESS;
+}
+
+#if defined(UUID_SHA1_CTX_TYPE)
+/* Makes sure the context fits in uuid_namespace. If this fails you need to increase UUID_NAMESPACE_CTX_SIZE. */
+typedef char uuid_sha1_ctx_size_check[(sizeof(UUID_SHA1_CTX_TYPE) <= UUID_NAMESPACE_CTX_SIZE) ? 1 : -1];
+
+static void uuid5_from_ctx(unsigned char* pUUID, UUID_SHA1_CTX_TYPE* pCtx, const char* pName, size_t nameLen)
+{
+    unsigned char hash[20];
+
+    UUID_SHA1_UPDATE(pCtx, (const unsigned char*)pName, nameLen);
+    UUID_SHA1_FINAL(pCtx, hash);
+
+    UUID_COPY_MEMORY(pUUID, hash, UUID_SIZE);
+
+    /* Byte 6 needs to be updated so the version number is set appropriately. */
+    pUUID[6] = (unsigned char)(0x50 | (pUUID[6] & 0x0F));
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+}
+#endif
+
+static uuid_result uuid5_internal(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+{
+    const uuid_dispatch* pDispatch = uuid_get_dispatch();
+
+    /* Prefer the hardware accelerated SHA-1 when the CPU supports it. */
+    if (pDispatch->onSHA1CompressAccelerated != NULL) {
+        uuid5_compress_internal(pUUID, pNamespaceUUID, pName, strlen(pName), pDispatch->onSHA1CompressAccelerated);
+        return UUID_SUCCESS;
+    }
+
+    {
+#if defined(UUID_SHA1_CTX_TYPE)
+    UUID_SHA1_CTX_TYPE ctx;
+
+    UUID_SHA1_INIT(&ctx);
+    UUID_SHA1_UPDATE(&ctx, pNamespaceUUID, UUID_SIZE);
+
+    uuid5_from_ctx(pUUID, &ctx, pName, strlen(pName));
+
+    return UUID_SUCCESS;
+#else
+    /* Without the SHA-1 macros, fall back to the built-in implementation so this works on every CPU. */
+    uuid5_compress_internal(pUUID, pNamespaceUUID, pName, strlen(pName), pDispatch->onSHA1CompressSingle);
+    return UUID_SUCCESS;
+#endif
+    }
+}
+
+static void uuid_ordered_set_time(unsigned char* pUUID, uuid_uint64 time)
+{
+    uuid_uint32 timeLow;
+    uuid_uint16 timeMid;
+    uuid_uint16 timeHi;
+
+    timeLow = (uuid_uint32)((time >>  0) & 0xFFFFFFFF);
+    timeMid = (uuid_uint16)((time >> 32) & 0x0000FFFF);
+    timeHi  = (uuid_uint16)((time >> 48) & 0x00000FFF);
+
+    /* Time High and Version */
+    pUUID[0] = (unsigned char)((timeHi  >>  8) & 0xFF);
+    pUUID[1] = (unsigned char)((timeHi  >>  0) & 0xFF);
+
+    /* Time Mid */
+    pUUID[2] = (unsigned char)((timeMid >>  8) & 0xFF);
+    pUUID[3] = (unsigned char)((timeMid >>  0) & 0xFF);
+
+    /* Time Low */
+    pUUID[4] = (unsigned char)((timeLow >> 24) & 0xFF);
+    pUUID[5] = (unsigned char)((timeLow >> 16) & 0xFF);
+    pUUID[6] = (unsigned char)((timeLow >>  8) & 0xFF);
+    pUUID[7] = (unsigned char)((timeLow >>  0) & 0xFF);
+}
+
+static uuid_result uuid_ordered_internal(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    uuid_result result;
+    uuid_uint64 time;
+
+    UUID_ASSERT(pUUID != NULL);
+    UUID_ASSERT(pRNG  != NULL);
+
+    result = uuid_get_time(&time);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    uuid_ordered_set_time(pUUID, time);
+
+
+    /* For the clock sequence and node ID we're always using a random number. */
+    result = uuid_rand_generate(pRNG, pUUID + 8, UUID_SIZE - 8);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return result;
+    }
+
+    /* Setting the version number breaks the ordering property of these UUIDs so I'm leaving this unset. */
+    /*pUUID[6] = (unsigned char)(0x40 | (pUUID[6] & 0x0F));*/
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+    return UUID_SUCCESS;
+}
+
+
+static void uuid6_set_time(unsigned char* pUUID, uuid_uint64 time)
+{
+    uuid_uint32 timeHigh;
+    uuid_uint16 timeMid;
+    uuid_uint16 timeLowAndVersion;
+
+    /* Same timestamp as version 1, but most significant bits first. */
+    timeHigh          = (uuid_uint32) ((time >> 28) & 0xFFFFFFFF);
+    timeMid           = (uuid_uint16) ((time >> 12) & 0x0000FFFF);
+    timeLowAndVersion = (uuid_uint16)(((time >>  0) & 0x00000FFF) | 0x6000);
+
+    pUUID[0] = (unsigned char)((timeHigh >> 24) & 0xFF);
+    pUUID[1] = (unsigned char)((timeHigh >> 16) & 0xFF);
+    pUUID[2] = (unsigned char)((timeHigh >>  8) & 0xFF);
+    pUUID[3] = (unsigned char)((timeHigh >>  0) & 0xFF);
+
+    pUUID[4] = (unsigned char)((timeMid >> 8) & 0xFF);
+    pUUID[5] = (unsigned char)((timeMid >> 0) & 0xFF);
+
+    pUUID[6] = (unsigned char)((timeLowAndVersion >> 8) & 0xFF);
+    pUUID[7] = (unsigned char)((timeLowAndVersion >> 0) & 0xFF);
+}
+
+/*
+Version 7 stores the Unix time in milliseconds. The 12 bits after the version are used for the
+sub-millisecond fraction (RFC 9562 section 6.2, method 3) so that UUIDs generated within the same
+millisecond are still sorted by time.
+*/
+static uuid_uint64 uuid7_time_from_uuid_time(uuid_uint64 time)
+{
+    uuid_uint64 unixTime;
+    uuid_uint64 milliseconds;
+    uuid_uint64 fraction;
+
+    unixTime     = time - (((uuid_uint64)0x01B21DD2 << 32) | 0x13814000);  /* UUID Epoch to Unix Epoch. */
+    milliseconds = unixTime / 10000;
+    fraction     = ((unixTime % 10000) * 4096) / 10000;
+
+    return (milliseconds << 12) | fraction;
+}
+
+static void uuid7_set_time_and_fraction(unsigned char* pUUID, uuid_uint64 time7)
+{
+    uuid_uint64 milliseconds = time7 >> 12;
+    uuid_uint32 fraction     = (uuid_uint32)(time7 & 0x0FFF);
+
+    pUUID[0] = (unsigned char)((milliseconds >> 40) & 0xFF);
+    pUUID[1] = (unsigned char)((milliseconds >> 32) & 0xFF);
+    pUUID[2] = (unsigned char)((milliseconds >> 24) & 0xFF);
+    pUUID[3] = (unsigned char)((milliseconds >> 16) & 0xFF);
+    pUUID[4] = (unsigned char)((milliseconds >>  8) & 0xFF);
+    pUUID[5] = (unsigned char)((milliseconds >>  0) & 0xFF);
+
+    pUUID[6] = (unsigned char)(0x70 | ((fraction >> 8) & 0x0F));
+    pUUID[7] = (unsigned char)((fraction >> 0) & 0xFF);
+}
+
+static void uuid7_set_time(unsigned char* pUUID, uuid_uint64 time)
+{
+    uuid7_set_time_and_fraction(pUUID, uuid7_time_from_uuid_time(time));
+}
+
+/* Generic time-based generation. The first 8 bytes are the timestamp and the rest is random. */
+static uuid_result uuid_time_internal(unsigned char* pUUID, uuid_rand* pRNG, void (* onSetTime)(unsigned char*, uuid_uint64))
+{
+    uuid_result result;
+    uuid_uint64 time;
+
+    UUID_ASSERT(pUUID != NULL);
+    UUID_ASSERT(pRNG  != NULL);
+
+    result = uuid_get_time(&time);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    UUID_STATS_CHECK_SAME_TICK(time);
+    onSetTime(pUUID, time);
+
+    result = uuid_rand_generate(pRNG, pUUID + 8, UUID_SIZE - 8);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return result;
+    }
+
+    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+    return UUID_SUCCESS;
+}
+
+/* The custom data is allowed to be the output buffer so this must not clear pUUID before copying. */
+static uuid_result uuid8_internal(unsigned char* pUUID, const unsigned char* pCustomData)
+{
+    UUID_ASSERT(pUUID != NULL);
+
+    if (pCustomData == NULL) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_MOVE_MEMORY(pUUID, pCustomData, UUID_SIZE);
+
+    /* Everything except for the version and variant is up to the application. */
+    pUUID[6] = (unsigned char)(0x80 | (pUUID[6] & 0x0F));
+    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+
+    return UUID_SUCCESS;
+}
+
+
+/*
+Stamps the version and variant bits into a run of UUIDs. The SIMD versions do this with a single
+AND and OR per UUID. Any leftovers are done with the scalar version.
+*/
+static void uuid_stamp_scalar(unsigned char* pUUIDs, size_t count, unsigned char version)
+{
+    size_t i;
+
+    for (i = 0; i < count; i += 1) {
+        unsigned char* pUUID = pUUIDs + (i * UUID_SIZE);
+        pUUID[6] = (unsigned char)((version << 4) | (pUUID[6] & 0x0F));
+        pUUID[8] = (unsigned char)(0x80           | (pUUID[8] & 0x3F));
+    }
+}
+
+#if defined(UUID_SUPPORT_SSE2)
+static void uuid_stamp_sse2(unsigned char* pUUIDs, size_t count, unsigned char version)
+{
+    __m128i andMask = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 0x0F, -1, 0x3F, -1, -1, -1, -1, -1, -1, -1);
+    __m128i orMask  = _mm_setr_epi8( 0,  0,  0,  0,  0,  0, (char)(version << 4), 0, (char)0x80, 0, 0, 0, 0, 0, 0, 0);
+    size_t i;
+
+    for (i = 0; i < count; i += 1) {
+        __m128i* pUUID = (__m128i*)(pUUIDs + (i * UUID_SIZE));
+        _mm_storeu_si128(pUUID, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(pUUID), andMask), orMask));
+    }
+}
+#endif
+
+#if defined(UUID_SUPPORT_AVX2)
+static UUID_TARGET_AVX2 void uuid_stamp_avx2(unsigned char* pUUIDs, size_t count, unsigned char version)
+{
+    __m256i andMask = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, 0x0F, -1, 0x3F, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0x0F, -1, 0x3F, -1, -1, -1, -1, -1, -1, -1);
+    __m256i orMask  = _mm256_setr_epi8( 0,  0,  0,  0,  0,  0, (char)(version << 4), 0, (char)0x80, 0, 0, 0, 0, 0, 0, 0,  0,  0,  0,  0,  0,  0, (char)(version << 4), 0, (char)0x80, 0, 0, 0, 0, 0, 0, 0);
+    size_t i;
+
+    /* Two at a time. */
+    for (i = 0; i + 2 <= count; i += 2) {
+        __m256i* pUUID = (__m256i*)(pUUIDs + (i * UUID_SIZE));
+        _mm256_storeu_si256(pUUID, _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(pUUID), andMask), orMask));
+    }
+
+    uuid_stamp_scalar(pUUIDs + (i * UUID_SIZE), count - i, version);
+}
+#endif
+
+/*
+Batch generation. The idea here is to make a single request to the random number generator for the
+entire batch and then stamp the version and variant bits in a tight loop afterwards.
+*/
+static uuid_result uuid4_batch_internal(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    uuid_result result;
+
+    UUID_ASSERT(pUUIDs != NULL);
+    UUID_ASSERT(pRNG   != NULL);
+
+    result = uuid_rand_generate(pRNG, pUUIDs, count * UUID_SIZE);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUIDs, count * UUID_SIZE);
+        return result;
+    }
+
+    uuid_get_dispatch()->onStamp(pUUIDs, count, 4);
+
+    return UUID_SUCCESS;
+}
+
+
+typedef enum
+{
+    UUID_VERSION_1       = 1,   /* Timed. */
+    UUID_VERSION_2       = 2,   /* ??? */
+    UUID_VERSION_3       = 3,   /* Named with MD5 hashing. */
+    UUID_VERSION_4       = 4,   /* Random. */
+    UUID_VERSION_5       = 5,   /* Named with SHA1 hashing. */
+    UUID_VERSION_6       = 6,   /* Timed, reordered so that it's sorted by time. RFC 9562. */
+    UUID_VERSION_7       = 7,   /* Unix time in milliseconds followed by random data. Sorted by time. RFC 9562. */
+    UUID_VERSION_8       = 8,   /* Custom. RFC 9562. */
+    UUID_VERSION_ORDERED = 100  /* Unofficial. Similar to version 1, but the time part is swapped so that it's sorted by time. Useful for database keys. */
+} uuid_version;
+
+/*
+Reserves count consecutive timestamps that all come after the last one handed out from pLastTime,
+and returns the first. If the clock hasn't moved on far enough the timestamps run ahead of it as if
+they were a counter. This is shared by uuid_generator and the batch functions.
+*/
+static uuid_uint64 uuid_reserve_time(volatile uuid_uint64* pLastTime, uuid_uint64 now, size_t count)
+{
+    uuid_uint64 lastTime;
+    uuid_uint64 firstTime;
+
+    UUID_ASSERT(pLastTime != NULL);
+    UUID_ASSERT(count > 0);
+
+    for (;;) {
+        lastTime = uuid_atomic_load_64(pLastTime);
+
+        if (now > lastTime) {
+            firstTime = now;
+        } else {
+            firstTime = lastTime + 1;
+        }
+
+        if (uuid_atomic_compare_exchange_64(pLastTime, lastTime, firstTime + (count - 1))) {
+            return firstTime;
+        }
+    }
+}
+
+/*
+The most recent timestamps handed out by the batch functions. Version 7 is in milliseconds with a
+12-bit fraction in the lower bits, the others are in 100-nanosecond ticks.
+*/
+static volatile uuid_uint64 uuid_g_batchLastTime  = 0;
+static volatile uuid_uint64 uuid_g_batchLastTime7 = 0;
+
+/*
+Time-based batches only need 8 random bytes per UUID. These are generated in one go into the second
+half of the output buffer and then spread out to their final positions, front to back. The source of
+each move is never before its destination so nothing gets overwritten before it's been read.
+
+The clock is read once for the whole batch. Each UUID in the batch gets the next timestamp after the
+previous one, with the last one carried over into the next batch, so a batch is strictly increasing
+and so is one batch after another. For version 7 the counter is the 12-bit fraction after the
+version, carrying over into the milliseconds. If batches are generated faster than the clock ticks,
+the timestamps run slightly ahead of the clock until it catches up, like uuid_generator.
+*/
+static uuid_result uuid_time_batch_internal(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG, uuid_version version)
+{
+    uuid_result result;
+    uuid_uint64 time;
+    unsigned char* pRandom;
+    volatile uuid_uint64* pLastTime;
+    void (* onSetTime)(unsigned char*, uuid_uint64);
+    size_t i;
+
+    UUID_ASSERT(pUUIDs != NULL);
+    UUID_ASSERT(pRNG   != NULL);
+
+    if (count == 0) {
+        return UUID_SUCCESS;
+    }
+
+    result = uuid_get_time(&time);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    UUID_STATS_CHECK_SAME_TICK(time);
+    UUID_STATS_ADD(sameTickCount, count - 1);   /* Every UUID after the first shares the clock reading. */
+
+    switch (version)
+    {
+        case UUID_VERSION_1:       onSetTime = uuid1_set_time;              break;
+        case UUID_VERSION_6:       onSetTime = uuid6_set_time;              break;
+        case UUID_VERSION_7:       onSetTime = uuid7_set_time_and_fraction; break;
+        case UUID_VERSION_ORDERED: onSetTime = uuid_ordered_set_time;       break;
+        default:                   return UUID_INVALID_ARGS;
+    }
+
+    if (version == UUID_VERSION_7) {
+        time      = uuid7_time_from_uuid_time(time);
+        pLastTime = &uuid_g_batchLastTime7;
+    } else {
+        pLastTime = &uuid_g_batchLastTime;
+    }
+
+    time = uuid_reserve_time(pLastTime, time, count);
+
+    pRandom = pUUIDs + (count * (UUID_SIZE - 8));
+
+    result = uuid_rand_generate(pRNG, pRandom, count * 8);
+    if (result != UUID_SUCCESS) {
+        UUID_ZERO_MEMORY(pUUIDs, count * UUID_SIZE);
+        return result;
+    }
+
+    for (i = 0; i < count; i += 1) {
+        unsigned char* pUUID = pUUIDs + (i * UUID_SIZE);
+
+        /* The random part must be moved before the time is written because the last one overlaps. */
+        UUID_MOVE_MEMORY(pUUID + 8, pRandom + (i * 8), 8);
+        onSetTime(pUUID, time + i);
+
+        pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+    }
+
+    return UUID_SUCCESS;
+}
+
+
+static uuid_result uuidn(unsigned char* pUUID, uuid_rand* pRNG, const unsigned char* pNamespaceUUID, const char* pName, uuid_version version)
+{
+    uuid_result result;
+#if defined(UUID_HAS_DEFAULT_RNG)
+    uuid_default_rng defaultRNG;
+#endif
+
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+
+    /* Some versions need s random number generator. */
+    if (version == UUID_VERSION_1 || version == UUID_VERSION_4 || version == UUID_VERSION_6 || version == UUID_VERSION_7 || version == UUID_VERSION_ORDERED) {
+        if (pRNG == NULL) {
+        #if defined(UUID_HAS_DEFAULT_RNG)
+            result = uuid_default_rng_acquire(&pRNG, &defaultRNG);
+            if (result != UUID_SUCCESS) {
+                return result;
+            }
+        #else
+            return UUID_INVALID_ARGS;   /* No random number generator available. */
+        #endif
+        }
+    }
+
+    switch (version)
+    {
+        case UUID_VERSION_1:       result = uuid1_internal(pUUID, pRNG);                  break;
+        case UUID_VERSION_2:       result = UUID_NOT_IMPLEMENTED;                         break;
+        case UUID_VERSION_3:       result = uuid3_internal(pUUID, pNamespaceUUID, pName); break;
+        case UUID_VERSION_4:       result = uuid4_internal(pUUID, pRNG);                  break;
+        case UUID_VERSION_5:       result = uuid5_internal(pUUID, pNamespaceUUID, pName); break;
+        case UUID_VERSION_6:       result = uuid_time_internal(pUUID, pRNG, uuid6_set_time); break;
+        case UUID_VERSION_7:       result = uuid_time_internal(pUUID, pRNG, uuid7_set_time); break;
+        case UUID_VERSION_ORDERED: result = uuid_ordered_internal(pUUID, pRNG);           break;
+        default:                   result = UUID_INVALID_ARGS;                            break;  /* Unknown or unsupported version. */
+    };
+
+#if defined(UUID_HAS_DEFAULT_RNG)
+    uuid_default_rng_release(pRNG, &defaultRNG);
+#endif
+
+    return result;
+}
+
+
+static uuid_result uuidn_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG, uuid_version version)
+{
+    uuid_result result;
+#if defined(UUID_HAS_DEFAULT_RNG)
+    uuid_default_rng defaultRNG;
+#endif
+
+    if (pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (count > ((size_t)-1) / UUID_SIZE) {
+        return UUID_INVALID_ARGS;   /* Too big. */
+    }
+
+    if (count == 0) {
+        return UUID_SUCCESS;
+    }
+
+    /* Only random and time based versions are supported in batch mode. */
+    if (version != UUID_VERSION_1 && version != UUID_VERSION_4 && version != UUID_VERSION_6 && version != UUID_VERSION_7 && version != UUID_VERSION_ORDERED) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (pRNG == NULL) {
+    #if defined(UUID_HAS_DEFAULT_RNG)
+        result = uuid_default_rng_acquire(&pRNG, &defaultRNG);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+    #else
+        return UUID_INVALID_ARGS;   /* No random number generator available. */
+    #endif
+    }
+
+    switch (version)
+    {
+        case UUID_VERSION_1:
+        case UUID_VERSION_6:
+        case UUID_VERSION_7:
+        case UUID_VERSION_ORDERED: result = uuid_time_batch_internal(pUUIDs, count, pRNG, version); break;
+        case UUID_VERSION_4:       result = uuid4_batch_internal(pUUIDs, count, pRNG);              break;
+        default:                   result = UUID_INVALID_ARGS;                                      break;
+    };
+
+#if defined(UUID_HAS_DEFAULT_RNG)
+    uuid_default_rng_release(pRNG, &defaultRNG);
+#endif
+
+    return result;
+}
+
+
+UUID_API uuid_result uuid1(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_1);
+}
+
+UUID_API uuid_result uuid3(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+{
+    return uuidn(pUUID, NULL, pNamespaceUUID, pName, UUID_VERSION_3);
+}
+
+UUID_API uuid_result uuid4(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_4);
+}
+
+UUID_API uuid_result uuid5(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+{
+    return uuidn(pUUID, NULL, pNamespaceUUID, pName, UUID_VERSION_5);
+}
+
+UUID_API uuid_result uuid6(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_6);
+}
+
+UUID_API uuid_result uuid7(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_7);
+}
+
+UUID_API uuid_result uuid8(unsigned char* pUUID, const unsigned char* pCustomData)
+{
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid8_internal(pUUID, pCustomData);
+}
+
+UUID_API uuid_result uuid_ordered(unsigned char* pUUID, uuid_rand* pRNG)
+{
+    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_ORDERED);
+}
+
+
+UUID_API uuid_result uuid_namespace_init(const unsigned char* pNamespaceUUID, uuid_namespace* pNamespace)
+{
+    if (pNamespace == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pNamespace);
+
+    if (pNamespaceUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_COPY_MEMORY(pNamespace->uuid, pNamespaceUUID, UUID_SIZE);
+
+    /*
+    The 16-byte namespace is less than a single block for both MD5 and SHA-1 so there is no compression
+    to skip at this point. What we save is the initialization and absorbing of the namespace for each UUID.
+    */
+#if defined(UUID_MD5_CTX_TYPE)
+    {
+        UUID_MD5_CTX_TYPE* pCtx = (UUID_MD5_CTX_TYPE*)pNamespace->md5.data;
+        UUID_MD5_INIT(pCtx);
+        UUID_MD5_UPDATE(pCtx, pNamespace->uuid, UUID_SIZE);
+    }
+#endif
+
+#if defined(UUID_SHA1_CTX_TYPE)
+    {
+        UUID_SHA1_CTX_TYPE* pCtx = (UUID_SHA1_CTX_TYPE*)pNamespace->sha1.data;
+        UUID_SHA1_INIT(pCtx);
+        UUID_SHA1_UPDATE(pCtx, pNamespace->uuid, UUID_SIZE);
+    }
+#endif
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid3_ns(unsigned char* pUUID, const uuid_namespace* pNamespace, const char* pName, size_t nameLen)
+{
+#if defined(UUID_MD5_CTX_TYPE)
+    UUID_MD5_CTX_TYPE ctx;
+
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+
+    if (pNamespace == NULL || pName == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (nameLen == (size_t)-1) {
+        nameLen = strlen(pName);
+    }
+
+    UUID_COPY_MEMORY(&ctx, pNamespace->md5.data, sizeof(ctx));
+    uuid3_from_ctx(pUUID, &ctx, pName, nameLen);
+
+    return UUID_SUCCESS;
+#else
+    (void)pUUID;
+    (void)pNamespace;
+    (void)pName;
+    (void)nameLen;
+    return UUID_NOT_IMPLEMENTED;
+#endif
+}
+
+UUID_API uuid_result uuid5_ns(unsigned char* pUUID, const uuid_namespace* pNamespace, const char* pName, size_t nameLen)
+{
+    const uuid_dispatch* pDispatch;
+
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+
+    if (pNamespace == NULL || pName == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (nameLen == (size_t)-1) {
+        nameLen = strlen(pName);
+    }
+
+    /*
+    With hardware SHA-1 it's faster to hash the namespace again than to copy the precomputed context
+    and go through the generic implementation.
+    */
+    pDispatch = uuid_get_dispatch();
+    if (pDispatch->onSHA1CompressAccelerated != NULL) {
+        uuid5_compress_internal(pUUID, pNamespace->uuid, pName, nameLen, pDispatch->onSHA1CompressAccelerated);
+        return UUID_SUCCESS;
+    }
+
+    {
+#if defined(UUID_SHA1_CTX_TYPE)
+    UUID_SHA1_CTX_TYPE ctx;
+
+    UUID_COPY_MEMORY(&ctx, pNamespace->sha1.data, sizeof(ctx));
+    uuid5_from_ctx(pUUID, &ctx, pName, nameLen);
+
+    return UUID_SUCCESS;
+#else
+    uuid5_compress_internal(pUUID, pNamespace->uuid, pName, nameLen, pDispatch->onSHA1CompressSingle);
+    return UUID_SUCCESS;
+#endif
+    }
+}
+
+UUID_API uuid_result uuid3_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths)
+{
+    return uuid_hash_names_batch(pUUIDs, count, pNamespaceUUID, ppNames, pNameLengths, 0);
+}
+
+UUID_API uuid_result uuid5_batch(unsigned char* pUUIDs, size_t count, const unsigned char* pNamespaceUUID, const char* const* ppNames, const size_t* pNameLengths)
+{
+    return uuid_hash_names_batch(pUUIDs, count, pNamespaceUUID, ppNames, pNameLengths, 1);
+}
+
+UUID_API uuid_result uuid1_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    return uuidn_batch(pUUIDs, count, pRNG, UUID_VERSION_1);
+}
+
+UUID_API uuid_result uuid4_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    return uuidn_batch(pUUIDs, count, pRNG, UUID_VERSION_4);
+}
+
+UUID_API uuid_result uuid6_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    return uuidn_batch(pUUIDs, count, pRNG, UUID_VERSION_6);
+}
+
+UUID_API uuid_result uuid7_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    return uuidn_batch(pUUIDs, count, pRNG, UUID_VERSION_7);
+}
+
+UUID_API uuid_result uuid_ordered_batch(unsigned char* pUUIDs, size_t count, uuid_rand* pRNG)
+{
+    return uuidn_batch(pUUIDs, count, pRNG, UUID_VERSION_ORDERED);
+}
+
+
+UUID_API uuid_result uuid_generator_init(uuid_rand* pRNG, uuid_clock* pClock, uuid_generator* pGenerator)
+{
+    uuid_result result;
+    unsigned char random[8];
+
+    if (pGenerator == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pGenerator);
+
+    /* The clock sequence and node ID are random. They are only generated once. */
+    result = uuid_rand_generate_or_default(pRNG, random, sizeof(random));
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    pGenerator->pRNG          = pRNG;
+    pGenerator->pClock        = pClock;
+    pGenerator->clockSequence = ((uuid_uint32)random[0] << 8) | (uuid_uint32)random[1];
+    UUID_COPY_MEMORY(pGenerator->node, random + 2, 6);
+
+    /* RFC 4122 section 4.5. The multicast bit must be set for randomly generated node IDs. */
+    pGenerator->node[0] |= 0x01;
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_generator_uninit(uuid_generator* pGenerator)
+{
+    if (pGenerator == NULL) {
+        return;
+    }
+
+    UUID_ZERO_OBJECT(pGenerator);
+}
+
+/*
+This is where the ordering guarantee comes from. The timestamp is always at least one tick after the
+previous one. When more than one UUID is requested in the same tick, the timestamp is incremented as
+if it were a counter, running slightly ahead of the clock until the clock catches up.
+
+If the clock goes backwards the clock sequence is incremented as per RFC 4122, but the timestamp will
+still continue on from the previous one so that ordering is maintained.
+*/
+static uuid_result uuid_generator_next(uuid_generator* pGenerator, uuid_version version, uuid_uint64* pTime, uuid_uint32* pClockSequence)
+{
+    uuid_result result;
+    uuid_uint64 now;
+    uuid_uint64 prevClockReading;
+    uuid_uint64 nextTime;
+    volatile uuid_uint64* pLastTime;
+
+    UUID_ASSERT(pGenerator     != NULL);
+    UUID_ASSERT(pTime          != NULL);
+    UUID_ASSERT(pClockSequence != NULL);
+
+    result = uuid_get_time_from_clock(pGenerator->pClock, &now);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    prevClockReading = uuid_atomic_exchange_64(&pGenerator->lastClockReading, now);
+    if (now < prevClockReading) {
+        uuid_atomic_fetch_add_32(&pGenerator->clockSequence, 1);
+    }
+
+    /*
+    Version 7 has a different resolution so it needs to be tracked separately. Its lower 12 bits are
+    the sub-millisecond fraction which doubles as the counter.
+    */
+    if (version == UUID_VERSION_7) {
+        now       = uuid7_time_from_uuid_time(now);
+        pLastTime = &pGenerator->lastTime7;
+    } else {
+        pLastTime = &pGenerator->lastTime;
+    }
+
+    nextTime = uuid_reserve_time(pLastTime, now, 1);
+
+    if (nextTime != now) {
+        UUID_STATS_ADD(sameTickCount, 1);
+    }
+
+    *pTime          = nextTime;
+    *pClockSequence = uuid_atomic_load_32(&pGenerator->clockSequence);
+
+    return UUID_SUCCESS;
+}
+
+static void uuid_generator_set_clock_sequence_and_node(uuid_generator* pGenerator, unsigned char* pUUID, uuid_uint32 clockSequence)
+{
+    /* Variant 1 goes in the top two bits of the clock sequence. */
+    pUUID[8] = (unsigned char)(0x80 | ((clockSequence >> 8) & 0x3F));
+    pUUID[9] = (unsigned char)((clockSequence >> 0) & 0xFF);
+    UUID_COPY_MEMORY(pUUID + 10, pGenerator->node, 6);
+}
+
+static uuid_result uuid_generator_generate(uuid_generator* pGenerator, unsigned char* pUUID, uuid_version version)
+{
+    uuid_result result;
+    uuid_uint64 time;
+    uuid_uint32 clockSequence;
+
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+
+    if (pGenerator == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_generator_next(pGenerator, version, &time, &clockSequence);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    switch (version)
+    {
+        case UUID_VERSION_1:       uuid1_set_time(pUUID, time);              break;
+        case UUID_VERSION_6:       uuid6_set_time(pUUID, time);              break;
+        case UUID_VERSION_7:       uuid7_set_time_and_fraction(pUUID, time); break;
+        case UUID_VERSION_ORDERED: uuid_ordered_set_time(pUUID, time);       break;
+        default:                   return UUID_INVALID_ARGS;
+    };
+
+    /* RFC 9562 requires the bits after the variant to be random for version 7. The clock sequence and node are for versions 1 and 6. */
+    if (version == UUID_VERSION_7) {
+        result = uuid_rand_generate_or_default(pGenerator->pRNG, pUUID + 8, 8);
+        if (result != UUID_SUCCESS) {
+            UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+            return result;
+        }
+
+        pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+    } else {
+        uuid_generator_set_clock_sequence_and_node(pGenerator, pUUID, clockSequence);
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_generator_uuid1(uuid_generator* pGenerator, unsigned char* pUUID)
+{
+    return uuid_generator_generate(pGenerator, pUUID, UUID_VERSION_1);
+}
+
+UUID_API uuid_result uuid_generator_uuid6(uuid_generator* pGenerator, unsigned char* pUUID)
+{
+    return uuid_generator_generate(pGenerator, pUUID, UUID_VERSION_6);
+}
+
+UUID_API uuid_result uuid_generator_uuid7(uuid_generator* pGenerator, unsigned char* pUUID)
+{
+    return uuid_generator_generate(pGenerator, pUUID, UUID_VERSION_7);
+}
+
+UUID_API uuid_result uuid_generator_ordered(uuid_generator* pGenerator, unsigned char* pUUID)
+{
+    return uuid_generator_generate(pGenerator, pUUID, UUID_VERSION_ORDERED);
+}
+
+
+
+
+/*
+Formatting works by converting all 16 bytes to 32 hex characters in one go and then copying them
+into place around the dashes. With SSE2 or SSSE3 the hex conversion is done 16 bytes at a time, and
+with AVX2 all 32 characters are produced in a single register.
+*/
+static void uuid_format_hex_scalar(char* pHex, const unsigned char* pUUID)
+{
+    const char* hex = "0123456789abcdef";
+    int i;
+
+    for (i = 0; i < UUID_SIZE; i += 1) {
+        pHex[i*2 + 0] = hex[(pUUID[i] & 0xF0) >> 4];
+        pHex[i*2 + 1] = hex[(pUUID[i] & 0x0F)     ];
+    }
+}
+
+#if defined(UUID_SUPPORT_SSE2)
+static __m128i uuid_nibbles_to_hex_sse2(__m128i nibbles)
+{
+    /* '0' for 0-9 and 'a' for 10-15. The distance between '9' + 1 and 'a' is 39. */
+    __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    __m128i hex      = _mm_add_epi8(nibbles, _mm_set1_epi8('0'));
+    return _mm_add_epi8(hex, _mm_and_si128(isLetter, _mm_set1_epi8(39)));
+}
+
+static void uuid_format_hex_sse2(char* pHex, const unsigned char* pUUID)
+{
+    __m128i bytes = _mm_loadu_si128((const __m128i*)pUUID);
+    __m128i mask  = _mm_set1_epi8(0x0F);
+    __m128i lo    = _mm_and_si128(bytes, mask);
+    __m128i hi    = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+
+    /* High nibble comes first in the output so it needs to be interleaved in that order. */
+    _mm_storeu_si128((__m128i*)(pHex +  0), uuid_nibbles_to_hex_sse2(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128((__m128i*)(pHex + 16), uuid_nibbles_to_hex_sse2(_mm_unpackhi_epi8(hi, lo)));
+}
+#endif
+
+#if defined(UUID_SUPPORT_SSSE3)
+static UUID_TARGET_SSSE3 void uuid_format_hex_ssse3(char* pHex, const unsigned char* pUUID)
+{
+    __m128i table = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    __m128i bytes = _mm_loadu_si128((const __m128i*)pUUID);
+    __m128i mask  = _mm_set1_epi8(0x0F);
+    __m128i lo    = _mm_and_si128(bytes, mask);
+    __m128i hi    = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+
+    _mm_storeu_si128((__m128i*)(pHex +  0), _mm_shuffle_epi8(table, _mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128((__m128i*)(pHex + 16), _mm_shuffle_epi8(table, _mm_unpackhi_epi8(hi, lo)));
+}
+#endif
+
+#if defined(UUID_SUPPORT_AVX2)
+static UUID_TARGET_AVX2 void uuid_format_hex_avx2(char* pHex, const unsigned char* pUUID)
+{
+    __m256i table = _mm256_broadcastsi128_si256(_mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'));
+    __m256i bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)pUUID));  /* Each byte in its own 16-bit lane, so there's no need to interleave across the two halves. */
+    __m256i hi    = _mm256_srli_epi16(bytes, 4);
+    __m256i lo    = _mm256_slli_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0x0F)), 8);
+
+    /* High nibble in the low byte of each lane so it comes first in memory. */
+    _mm256_storeu_si256((__m256i*)pHex, _mm256_shuffle_epi8(table, _mm256_or_si256(hi, lo)));
+}
+#endif
+
+/*
+Runtime dispatch. The CPU is queried once and the best kernel for each job is stored in a table.
+Only features for which a kernel has been compiled are reported.
+*/
+static uuid_uint32 uuid_get_compiled_cpu_features(void)
+{
+    uuid_uint32 features = 0;
+
+#if defined(UUID_SUPPORT_SSE2)
+    features |= UUID_CPU_FEATURE_SSE2;
+#endif
+#if defined(UUID_SUPPORT_SSSE3)
+    features |= UUID_CPU_FEATURE_SSSE3;
+#endif
+#if defined(UUID_SUPPORT_AVX2)
+    features |= UUID_CPU_FEATURE_AVX2;
+#endif
+#if defined(UUID_SUPPORT_SHA)
+    features |= UUID_CPU_FEATURE_SHA;
+#endif
+
+    return features;
+}
+
+static uuid_uint32 uuid_detect_cpu_features(void)
+{
+#if defined(UUID_SUPPORT_RUNTIME_DISPATCH) && defined(UUID_SUPPORT_CPUID)
+    uuid_uint32 features = 0;
+    int info[4];
+    int maxFunction;
+
+    uuid_cpuid(info, 0);
+    maxFunction = info[0];
+
+    if (maxFunction >= 1) {
+        int osxsave;
+
+        uuid_cpuid(info, 1);
+
+        if ((info[3] & (1 << 26)) != 0) {
+            features |= UUID_CPU_FEATURE_SSE2;
+        }
+        if ((info[2] & (1 <<  9)) != 0) {
+            features |= UUID_CPU_FEATURE_SSSE3;
+        }
+
+        osxsave = (info[2] & (1 << 27)) != 0;
+
+        if (maxFunction >= 7) {
+            uuid_cpuid(info, 7);
+
+            /* AVX2 needs the OS to save the YMM registers. That's OSXSAVE followed by a check of XCR0. */
+            if ((info[1] & (1 <<  5)) != 0 && osxsave && (uuid_xgetbv(0) & 6) == 6) {
+                features |= UUID_CPU_FEATURE_AVX2;
+            }
+            if ((info[1] & (1 << 29)) != 0) {
+                features |= UUID_CPU_FEATURE_SHA;
+            }
+        }
+    }
+
+    return features & uuid_get_compiled_cpu_features();
+#else
+    /* Without runtime dispatch the compiler has been told what the CPU supports. */
+    return uuid_get_compiled_cpu_features();
+#endif
+}
+
+static uuid_dispatch uuid_g_dispatch;
+static volatile uuid_uint64 uuid_g_dispatchInitialized = 0;
+
+static void uuid_dispatch_init(uuid_dispatch* pDispatch, uuid_uint32 features)
+{
+    UUID_ASSERT(pDispatch != NULL);
+
+    /* Portable defaults first. */
+    pDispatch->cpuFeatures               = features;
+    pDispatch->onFormatHex               = uuid_format_hex_scalar;
+    pDispatch->onStamp                   = uuid_stamp_scalar;
+    pDispatch->onMD5Compress             = uuid_md5_compress;
+    pDispatch->md5LaneCount              = 1;
+    pDispatch->onSHA1Compress            = uuid_sha1_compress;
+    pDispatch->sha1LaneCount             = 1;
+    pDispatch->onSHA1CompressSingle      = uuid_sha1_compress;
+    pDispatch->onSHA1CompressAccelerated = NULL;
+
+#if defined(UUID_SUPPORT_SSE2)
+    if ((features & UUID_CPU_FEATURE_SSE2) != 0) {
+        pDispatch->onFormatHex    = uuid_format_hex_sse2;
+        pDispatch->onStamp        = uuid_stamp_sse2;
+        pDispatch->onMD5Compress  = uuid_md5_compress_x4_sse2;
+        pDispatch->md5LaneCount   = 4;
+        pDispatch->onSHA1Compress = uuid_sha1_compress_x4_sse2;
+        pDispatch->sha1LaneCount  = 4;
+    }
+#endif
+#if defined(UUID_SUPPORT_SSSE3)
+    if ((features & UUID_CPU_FEATURE_SSSE3) != 0) {
+        pDispatch->onFormatHex = uuid_format_hex_ssse3;
+    }
+#endif
+#if defined(UUID_SUPPORT_AVX2)
+    if ((features & UUID_CPU_FEATURE_AVX2) != 0) {
+        pDispatch->onFormatHex    = uuid_format_hex_avx2;
+        pDispatch->onStamp        = uuid_stamp_avx2;
+        pDispatch->onMD5Compress  = uuid_md5_compress_x8_avx2;
+        pDispatch->md5LaneCount   = 8;
+        pDispatch->onSHA1Compress = uuid_sha1_compress_x8_avx2;
+        pDispatch->sha1LaneCount  = 8;
+    }
+#endif
+#if defined(UUID_SUPPORT_SHA)
+    if ((features & UUID_CPU_FEATURE_SHA) != 0) {
+        pDispatch->onSHA1CompressSingle      = uuid_sha1_compress_shani;
+        pDispatch->onSHA1CompressAccelerated = uuid_sha1_compress_shani;
+    }
+#endif
+}
+
+/*
+Multiple threads may race to initialize the table the first time. That's fine because they'll all
+fill it out with the same values. The flag is only set once the table has been filled out.
+*/
+static const uuid_dispatch* uuid_get_dispatch(void)
+{
+    if (uuid_atomic_load_64(&uuid_g_dispatchInitialized) == 0) {
+        uuid_dispatch_init(&uuid_g_dispatch, uuid_detect_cpu_features());
+        uuid_atomic_exchange_64(&uuid_g_dispatchInitialized, 1);
+    }
+
+    return &uuid_g_dispatch;
+}
+
+UUID_API uuid_uint32 uuid_get_cpu_features(void)
+{
+    return uuid_get_dispatch()->cpuFeatures;
+}
+
+UUID_API uuid_uint32 uuid_set_cpu_features(uuid_uint32 features)
+{
+    uuid_dispatch_init(&uuid_g_dispatch, uuid_detect_cpu_features() & features);
+    uuid_atomic_exchange_64(&uuid_g_dispatchInitialized, 1);
+
+    return uuid_g_dispatch.cpuFeatures;
+}
+
+
+/* Outputs exactly 36 characters. Does not null terminate. */
+static void uuid_format_internal(char* dst, const unsigned char* pUUID, uuid_format_hex_proc onFormatHex)
+{
+    char hex[UUID_SIZE * 2];
+
+    onFormatHex(hex, pUUID);
+
+    /* xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+    UUID_COPY_MEMORY(dst +  0, hex +  0, 8);
+    dst[ 8] = '-';
+    UUID_COPY_MEMORY(dst +  9, hex +  8, 4);
+    dst[13] = '-';
+    UUID_COPY_MEMORY(dst + 14, hex + 12, 4);
+    dst[18] = '-';
+    UUID_COPY_MEMORY(dst + 19, hex + 16, 4);
+    dst[23] = '-';
+    UUID_COPY_MEMORY(dst + 24, hex + 20, 12);
+}
+
+UUID_API uuid_result uuid_format(char* dst, size_t dstCap, const unsigned char* pUUID)
+{
+    if (dst == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (dstCap < UUID_SIZE_FORMATTED) {
+        if (dstCap > 0) {
+            dst[0] = '\0';
+        }
+
+        return UUID_INVALID_ARGS;
+    }
+
+    if (pUUID == NULL) {
+        dst[0] = '\0';
+        return UUID_INVALID_ARGS;
+    }
+
+    uuid_format_internal(dst, pUUID, uuid_get_dispatch()->onFormatHex);
+
+    /* Never forget to null terminate. */
+    dst[UUID_SIZE_FORMATTED - 1] = '\0';
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_format_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count)
+{
+    uuid_format_hex_proc onFormatHex;
+    size_t i;
+
+    if (dst == NULL || pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (stride < UUID_SIZE_FORMATTED - 1) {
+        return UUID_INVALID_ARGS;   /* Not enough room for the formatted string. */
+    }
+
+    onFormatHex = uuid_get_dispatch()->onFormatHex;
+
+    for (i = 0; i < count; i += 1) {
+        char* pDst = dst + (i * stride);
+
+        uuid_format_internal(pDst, pUUIDs + (i * UUID_SIZE), onFormatHex);
+
+        /* Only null terminate if there's room for it. */
+        if (stride >= UUID_SIZE_FORMATTED) {
+            pDst[UUID_SIZE_FORMATTED - 1] = '\0';
+        }
+    }
+
+    return UUID_SUCCESS;
+}
+
+/*
+Parsing. The string is first normalized into 32 hex characters based on its length, then the hex
+characters are decoded. Any problems are accumulated in a flag rather than branching per character,
+which means malformed input costs the same as well-formed input.
+*/
+static const unsigned char uuid_g_hexDecodeTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#if defined(UUID_SUPPORT_SSE2)
+static int uuid_decode_hex16_sse2(__m128i* pResult, const char* pHex)
+{
+    __m128i chars    = _mm_loadu_si128((const __m128i*)pHex);
+    __m128i lower    = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    __m128i isDigit  = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    __m128i nibbles;
+
+    nibbles = _mm_or_si128(
+        _mm_and_si128(isDigit,  _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+        _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))
+    );
+
+    /* Each 16-bit lane has the high nibble in the low byte and the low nibble in the high byte. */
+    *pResult = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(nibbles, 8));
+
+    return _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
+}
+#endif
+
+/* Returns non-zero if all 32 characters were valid hex digits. */
+static int uuid_decode_hex32(unsigned char* pUUID, const char* pHex)
+{
+#if defined(UUID_SUPPORT_SSE2)
+    __m128i lo;
+    __m128i hi;
+    int isValid;
+
+    isValid  = uuid_decode_hex16_sse2(&lo, pHex +  0);
+    isValid &= uuid_decode_hex16_sse2(&hi, pHex + 16);
+
+    _mm_storeu_si128((__m128i*)pUUID, _mm_packus_epi16(lo, hi));
+
+    return isValid;
+#else
+    unsigned char invalid = 0;
+    int i;
+
+    for (i = 0; i < UUID_SIZE; i += 1) {
+        unsigned char hi = uuid_g_hexDecodeTable[(unsigned char)pHex[i*2 + 0]];
+        unsigned char lo = uuid_g_hexDecodeTable[(unsigned char)pHex[i*2 + 1]];
+
+        invalid |= (hi | lo) & 0xF0;    /* Invalid characters are 0xFF. */
+        pUUID[i] = (unsigned char)((hi << 4) | (lo & 0x0F));
+    }
+
+    return invalid == 0;
+#endif
+}
+
+static int uuid_parse_canonical(unsigned char* pUUID, const char* pSrc)
+{
+    char hex[UUID_SIZE * 2];
+    int isValid;
+
+    /* xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+    isValid = (pSrc[8] == '-') & (pSrc[13] == '-') & (pSrc[18] == '-') & (pSrc[23] == '-');
+
+    UUID_COPY_MEMORY(hex +  0, pSrc +  0, 8);
+    UUID_COPY_MEMORY(hex +  8, pSrc +  9, 4);
+    UUID_COPY_MEMORY(hex + 12, pSrc + 14, 4);
+    UUID_COPY_MEMORY(hex + 16, pSrc + 19, 4);
+    UUID_COPY_MEMORY(hex + 20, pSrc + 24, 12);
+
+    isValid &= uuid_decode_hex32(pUUID, hex);
+
+    return isValid;
+}
+
+static uuid_result uuid_parse_internal(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    int isValid;
+
+    UUID_ASSERT(pUUID != NULL);
+    UUID_ASSERT(pSrc  != NULL);
+
+    switch (srcLen)
+    {
+        case 32:    /* xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx */
+        {
+            isValid = uuid_decode_hex32(pUUID, pSrc);
+        } break;
+
+        case 36:    /* xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+        {
+            isValid = uuid_parse_canonical(pUUID, pSrc);
+        } break;
+
+        case 38:    /* {xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx} */
+        {
+            isValid  = (pSrc[0] == '{') & (pSrc[37] == '}');
+            isValid &= uuid_parse_canonical(pUUID, pSrc + 1);
+        } break;
+
+        case 45:    /* urn:uuid:xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+        {
+            /* The prefix is case-insensitive. None of these characters change meaning with 0x20 set. */
+            isValid  = ((pSrc[0] | 0x20) == 'u') & ((pSrc[1] | 0x20) == 'r') & ((pSrc[2] | 0x20) == 'n') & (pSrc[3] == ':');
+            isValid &= ((pSrc[4] | 0x20) == 'u') & ((pSrc[5] | 0x20) == 'u') & ((pSrc[6] | 0x20) == 'i') & ((pSrc[7] | 0x20) == 'd') & (pSrc[8] == ':');
+            isValid &= uuid_parse_canonical(pUUID, pSrc + 9);
+        } break;
+
+        default:
+        {
+            isValid = 0;
+        } break;
+    }
+
+    if (!isValid) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_parse(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (pSrc == NULL) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_ARGS;
+    }
+
+    if (srcLen == (size_t)-1) {
+        srcLen = strlen(pSrc);
+    }
+
+    return uuid_parse_internal(pUUID, pSrc, srcLen);
+}
+
+static size_t uuid_trim_record_length(const char* pSrc, size_t srcLen)
+{
+    while (srcLen > 0 && (pSrc[srcLen - 1] == '\0' || pSrc[srcLen - 1] == '\n' || pSrc[srcLen - 1] == '\r' || pSrc[srcLen - 1] == ' ')) {
+        srcLen -= 1;
+    }
+
+    return srcLen;
+}
+
+typedef uuid_result (* uuid_parse_proc)(unsigned char* pUUID, const char* pSrc, size_t srcLen);
+
+static uuid_result uuid_parse_batch_internal(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount, uuid_parse_proc onParse)
+{
+    uuid_result result;
+    size_t uuidCount = 0;
+    size_t cursor = 0;
+
+    if (pUUIDCount != NULL) {
+        *pUUIDCount = 0;
+    }
+
+    if (pUUIDs == NULL || pSrc == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (srcLen == (size_t)-1) {
+        srcLen = strlen(pSrc);
+    }
+
+    /*
+    With a stride of 0 each UUID is on its own line. Otherwise each record is exactly `stride` bytes,
+    with any trailing null terminators, new lines or spaces ignored.
+    */
+    while (cursor < srcLen && uuidCount < uuidCap) {
+        size_t recordLen;
+        size_t nextCursor;
+
+        if (stride == 0) {
+            recordLen = 0;
+            while (cursor + recordLen < srcLen && pSrc[cursor + recordLen] != '\n') {
+                recordLen += 1;
+            }
+
+            nextCursor = cursor + recordLen + 1;
+        } else {
+            recordLen = stride;
+            if (recordLen > srcLen - cursor) {
+                recordLen = srcLen - cursor;
+            }
+
+            nextCursor = cursor + stride;
+        }
+
+        recordLen = uuid_trim_record_length(pSrc + cursor, recordLen);
+
+        /* Blank lines are skipped when parsing line by line. */
+        if (recordLen > 0 || stride != 0) {
+            result = onParse(pUUIDs + (uuidCount * UUID_SIZE), pSrc + cursor, recordLen);
+            if (result != UUID_SUCCESS) {
+                if (pUUIDCount != NULL) {
+                    *pUUIDCount = uuidCount;    /* The index of the bad record. */
+                }
+
+                return result;
+            }
+
+            uuidCount += 1;
+        }
+
+        cursor = nextCursor;
+    }
+
+    if (pUUIDCount != NULL) {
+        *pUUIDCount = uuidCount;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_parse_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount)
+{
+    return uuid_parse_batch_internal(pUUIDs, uuidCap, pSrc, srcLen, stride, pUUIDCount, uuid_parse_internal);
+}
+
+UUID_API uuid_result uuid_validate(const char* pSrc, size_t srcLen)
+{
+    unsigned char uuid[UUID_SIZE];
+    return uuid_parse(uuid, pSrc, srcLen);
+}
+
+
+/*
+Compact encodings. The UUID is treated as a 128-bit big-endian number so that encodings with an
+alphabet in ASCII order, which is base32 and base58, sort the same as the UUID. Decoding goes
+through a 256 entry table where invalid characters are 0xFF. As with hex, problems are accumulated
+in a flag rather than branching per character.
+*/
+typedef void (* uuid_encode_proc)(char* dst, const unsigned char* pUUID);
+
+static uuid_result uuid_format_compact(char* dst, size_t dstCap, const unsigned char* pUUID, size_t length, uuid_encode_proc onEncode)
+{
+    if (dst == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (dstCap < length + 1) {
+        if (dstCap > 0) {
+            dst[0] = '\0';
+        }
+
+        return UUID_INVALID_ARGS;
+    }
+
+    if (pUUID == NULL) {
+        dst[0] = '\0';
+        return UUID_INVALID_ARGS;
+    }
+
+    onEncode(dst, pUUID);
+    dst[length] = '\0';
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_format_compact_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count, size_t length, uuid_encode_proc onEncode)
+{
+    size_t i;
+
+    if (dst == NULL || pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (stride < length) {
+        return UUID_INVALID_ARGS;   /* Not enough room for the encoded string. */
+    }
+
+    for (i = 0; i < count; i += 1) {
+        char* pDst = dst + (i * stride);
+
+        onEncode(pDst, pUUIDs + (i * UUID_SIZE));
+
+        /* Only null terminate if there's room for it. */
+        if (stride > length) {
+            pDst[length] = '\0';
+        }
+    }
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_parse_compact(unsigned char* pUUID, const char* pSrc, size_t srcLen, uuid_parse_proc onParse)
+{
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (pSrc == NULL) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_ARGS;
+    }
+
+    if (srcLen == (size_t)-1) {
+        srcLen = strlen(pSrc);
+    }
+
+    return onParse(pUUID, pSrc, srcLen);
+}
+
+
+/*
+Crockford base32. This is the same as ULID. 26 characters is 130 bits so the first character only
+holds 3 bits. The 128 bits are split into 8 + 60 + 60 bits so each part can be encoded from a single
+64-bit integer.
+*/
+static const char uuid_g_base32Alphabet[32] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+    'G', 'H', 'J', 'K', 'M', 'N', 'P', 'Q', 'R', 'S', 'T', 'V', 'W', 'X', 'Y', 'Z'
+};
+
+static const unsigned char uuid_g_base32DecodeTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0xFF, 0x12, 0x13, 0xFF, 0x14, 0x15, 0xFF,
+    0x16, 0x17, 0x18, 0x19, 0x1A, 0xFF, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0xFF, 0x12, 0x13, 0xFF, 0x14, 0x15, 0xFF,
+    0x16, 0x17, 0x18, 0x19, 0x1A, 0xFF, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#define UUID_BASE32_MASK60  UUID_UINT64_CONSTANT(0x0FFFFFFF, 0xFFFFFFFF)
+
+static void uuid_encode_base32_60(char* dst, uuid_uint64 x)
+{
+    int i;
+
+    for (i = 11; i >= 0; i -= 1) {
+        dst[i] = uuid_g_base32Alphabet[x & 0x1F];
+        x >>= 5;
+    }
+}
+
+static void uuid_encode_base32(char* dst, const unsigned char* pUUID)
+{
+    uuid_uint64 hi = uuid_load_be64(pUUID + 0);
+    uuid_uint64 lo = uuid_load_be64(pUUID + 8);
+
+    dst[0] = uuid_g_base32Alphabet[(hi >> 61) & 0x07];
+    dst[1] = uuid_g_base32Alphabet[(hi >> 56) & 0x1F];
+    uuid_encode_base32_60(dst +  2, ((hi << 4) | (lo >> 60)) & UUID_BASE32_MASK60);
+    uuid_encode_base32_60(dst + 14, lo & UUID_BASE32_MASK60);
+}
+
+static uuid_uint64 uuid_decode_base32_60(const char* pSrc, unsigned char* pInvalid)
+{
+    uuid_uint64 x = 0;
+    unsigned char invalid = 0;
+    int i;
+
+    for (i = 0; i < 12; i += 1) {
+        unsigned char value = uuid_g_base32DecodeTable[(unsigned char)pSrc[i]];
+
+        invalid |= value;
+        x = (x << 5) | (value & 0x1F);
+    }
+
+    *pInvalid |= invalid & 0xE0;
+    return x;
+}
+
+static uuid_result uuid_parse_base32_internal(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    unsigned char invalid;
+    unsigned char first;
+    unsigned char second;
+    uuid_uint64 mid;
+    uuid_uint64 lo;
+
+    if (srcLen != UUID_SIZE_BASE32 - 1) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    first  = uuid_g_base32DecodeTable[(unsigned char)pSrc[0]];
+    second = uuid_g_base32DecodeTable[(unsigned char)pSrc[1]];
+
+    /* The first character only holds 3 bits so it can't be higher than 7. */
+    invalid = (unsigned char)((first & 0xF8) | (second & 0xE0));
+
+    mid = uuid_decode_base32_60(pSrc +  2, &invalid);
+    lo  = uuid_decode_base32_60(pSrc + 14, &invalid);
+
+    if (invalid != 0) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    uuid_store_be64(pUUID + 0, ((uuid_uint64)first << 61) | ((uuid_uint64)second << 56) | (mid >> 4));
+    uuid_store_be64(pUUID + 8, (mid << 60) | lo);
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_format_base32(char* dst, size_t dstCap, const unsigned char* pUUID)
+{
+    return uuid_format_compact(dst, dstCap, pUUID, UUID_SIZE_BASE32 - 1, uuid_encode_base32);
+}
+
+UUID_API uuid_result uuid_format_base32_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count)
+{
+    return uuid_format_compact_batch(dst, stride, pUUIDs, count, UUID_SIZE_BASE32 - 1, uuid_encode_base32);
+}
+
+UUID_API uuid_result uuid_parse_base32(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    return uuid_parse_compact(pUUID, pSrc, srcLen, uuid_parse_base32_internal);
+}
+
+UUID_API uuid_result uuid_parse_base32_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount)
+{
+    return uuid_parse_batch_internal(pUUIDs, uuidCap, pSrc, srcLen, stride, pUUIDCount, uuid_parse_base32_internal);
+}
+
+
+/*
+Base58. This is always padded out to 22 characters with leading '1' characters, which is the zero
+digit, so that it sorts correctly. Rather than dividing the whole number by 58 for each character,
+it's divided by 58^5 which fits in 32 bits, with each remainder giving 5 characters. The number is
+stored as four 32-bit limbs, most significant first.
+*/
+#define UUID_BASE58_CHUNK   656356768   /* 58^5 */
+
+static const char uuid_g_base58Alphabet[58] = {
+    '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F', 'G',
+    'H', 'J', 'K', 'L', 'M', 'N', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y',
+    'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'm', 'n', 'o', 'p',
+    'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'
+};
+
+static const unsigned char uuid_g_base58DecodeTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0xFF, 0x11, 0x12, 0x13, 0x14, 0x15, 0xFF,
+    0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0xFF, 0x2C, 0x2D, 0x2E,
+    0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static void uuid_encode_base58(char* dst, const unsigned char* pUUID)
+{
+    uuid_uint32 limbs[4];
+    uuid_uint32 remainder;
+    int iChunk;
+    int iLimb;
+    int iChar;
+
+    for (iLimb = 0; iLimb < 4; iLimb += 1) {
+        limbs[iLimb] = uuid_load_be32(pUUID + (iLimb * 4));
+    }
+
+    /* 4 chunks of 5 characters from the end, leaving a number below 58^2 for the first 2 characters. */
+    for (iChunk = 0; iChunk < 4; iChunk += 1) {
+        uuid_uint64 carry = 0;
+
+        for (iLimb = 0; iLimb < 4; iLimb += 1) {
+            uuid_uint64 x = (carry << 32) | limbs[iLimb];
+
+            limbs[iLimb] = (uuid_uint32)(x / UUID_BASE58_CHUNK);
+            carry = x % UUID_BASE58_CHUNK;
+        }
+
+        remainder = (uuid_uint32)carry;
+        for (iChar = 0; iChar < 5; iChar += 1) {
+            dst[21 - (iChunk * 5) - iChar] = uuid_g_base58Alphabet[remainder % 58];
+            remainder /= 58;
+        }
+    }
+
+    UUID_ASSERT(limbs[0] == 0 && limbs[1] == 0 && limbs[2] == 0 && limbs[3] < 58*58);
+
+    dst[0] = uuid_g_base58Alphabet[limbs[3] / 58];
+    dst[1] = uuid_g_base58Alphabet[limbs[3] % 58];
+}
+
+static uuid_result uuid_parse_base58_internal(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    uuid_uint32 limbs[4];
+    uuid_uint64 overflow = 0;
+    unsigned char invalid = 0;
+    int iChunk;
+    int iLimb;
+    int iChar;
+
+    if (srcLen != UUID_SIZE_BASE58 - 1) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    limbs[0] = 0;
+    limbs[1] = 0;
+    limbs[2] = 0;
+    limbs[3] = 0;
+
+    /* The first chunk is 2 characters and the rest are 5. */
+    for (iChunk = 0; iChunk < 5; iChunk += 1) {
+        const char* pChunk = (iChunk == 0) ? pSrc : pSrc + 2 + ((iChunk - 1) * 5);
+        int chunkLen = (iChunk == 0) ? 2 : 5;
+        uuid_uint32 multiplier = (iChunk == 0) ? 58*58 : UUID_BASE58_CHUNK;
+        uuid_uint64 carry = 0;
+
+        for (iChar = 0; iChar < chunkLen; iChar += 1) {
+            unsigned char value = uuid_g_base58DecodeTable[(unsigned char)pChunk[iChar]];
+
+            invalid |= value;
+            carry = (carry * 58) + (value & 0x3F);
+        }
+
+        for (iLimb = 3; iLimb >= 0; iLimb -= 1) {
+            uuid_uint64 x = ((uuid_uint64)limbs[iLimb] * multiplier) + carry;
+
+            limbs[iLimb] = (uuid_uint32)x;
+            carry = x >> 32;
+        }
+
+        overflow |= carry;
+    }
+
+    /* Anything that doesn't fit in 128 bits is invalid, as is anything that isn't in the alphabet. */
+    if ((invalid & 0xC0) != 0 || overflow != 0) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    for (iLimb = 0; iLimb < 4; iLimb += 1) {
+        uuid_store_be32(pUUID + (iLimb * 4), limbs[iLimb]);
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_format_base58(char* dst, size_t dstCap, const unsigned char* pUUID)
+{
+    return uuid_format_compact(dst, dstCap, pUUID, UUID_SIZE_BASE58 - 1, uuid_encode_base58);
+}
+
+UUID_API uuid_result uuid_format_base58_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count)
+{
+    return uuid_format_compact_batch(dst, stride, pUUIDs, count, UUID_SIZE_BASE58 - 1, uuid_encode_base58);
+}
+
+UUID_API uuid_result uuid_parse_base58(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    return uuid_parse_compact(pUUID, pSrc, srcLen, uuid_parse_base58_internal);
+}
+
+UUID_API uuid_result uuid_parse_base58_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount)
+{
+    return uuid_parse_batch_internal(pUUIDs, uuidCap, pSrc, srcLen, stride, pUUIDCount, uuid_parse_base58_internal);
+}
+
+
+/*
+Base64url. The first 15 bytes are encoded 3 bytes at a time into 20 characters and the last byte
+is encoded into 2 characters. The last character only holds 2 bits. The other 4 must be zero,
+otherwise there would be multiple strings for the same UUID.
+*/
+static const char uuid_g_base64urlAlphabet[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_'
+};
+
+static const unsigned char uuid_g_base64urlDecodeTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static void uuid_encode_base64url(char* dst, const unsigned char* pUUID)
+{
+    int i;
+
+    for (i = 0; i < 5; i += 1) {
+        uuid_uint32 x = ((uuid_uint32)pUUID[i*3 + 0] << 16) | ((uuid_uint32)pUUID[i*3 + 1] << 8) | ((uuid_uint32)pUUID[i*3 + 2] << 0);
+
+        dst[i*4 + 0] = uuid_g_base64urlAlphabet[(x >> 18) & 0x3F];
+        dst[i*4 + 1] = uuid_g_base64urlAlphabet[(x >> 12) & 0x3F];
+        dst[i*4 + 2] = uuid_g_base64urlAlphabet[(x >>  6) & 0x3F];
+        dst[i*4 + 3] = uuid_g_base64urlAlphabet[(x >>  0) & 0x3F];
+    }
+
+    dst[20] = uuid_g_base64urlAlphabet[(pUUID[15] >> 2) & 0x3F];
+    dst[21] = uuid_g_base64urlAlphabet[(pUUID[15] << 4) & 0x30];
+}
+
+static uuid_result uuid_parse_base64url_internal(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    unsigned char invalid = 0;
+    unsigned char a;
+    unsigned char b;
+    int i;
+
+    if (srcLen != UUID_SIZE_BASE64URL - 1) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    for (i = 0; i < 5; i += 1) {
+        unsigned char c0 = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[i*4 + 0]];
+        unsigned char c1 = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[i*4 + 1]];
+        unsigned char c2 = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[i*4 + 2]];
+        unsigned char c3 = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[i*4 + 3]];
+        uuid_uint32 x;
+
+        invalid |= c0 | c1 | c2 | c3;
+
+        x = ((uuid_uint32)(c0 & 0x3F) << 18) | ((uuid_uint32)(c1 & 0x3F) << 12) | ((uuid_uint32)(c2 & 0x3F) << 6) | ((uuid_uint32)(c3 & 0x3F) << 0);
+        pUUID[i*3 + 0] = (unsigned char)((x >> 16) & 0xFF);
+        pUUID[i*3 + 1] = (unsigned char)((x >>  8) & 0xFF);
+        pUUID[i*3 + 2] = (unsigned char)((x >>  0) & 0xFF);
+    }
+
+    a = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[20]];
+    b = uuid_g_base64urlDecodeTable[(unsigned char)pSrc[21]];
+    pUUID[15] = (unsigned char)(((a & 0x3F) << 2) | ((b & 0x30) >> 4));
+
+    /* Invalid characters are 0xFF so they'll have the top bits set. The unused bits must be zero. */
+    if (((invalid | a | b) & 0xC0) != 0 || (b & 0x0F) != 0) {
+        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+        return UUID_INVALID_DATA;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_format_base64url(char* dst, size_t dstCap, const unsigned char* pUUID)
+{
+    return uuid_format_compact(dst, dstCap, pUUID, UUID_SIZE_BASE64URL - 1, uuid_encode_base64url);
+}
+
+UUID_API uuid_result uuid_format_base64url_batch(char* dst, size_t stride, const unsigned char* pUUIDs, size_t count)
+{
+    return uuid_format_compact_batch(dst, stride, pUUIDs, count, UUID_SIZE_BASE64URL - 1, uuid_encode_base64url);
+}
+
+UUID_API uuid_result uuid_parse_base64url(unsigned char* pUUID, const char* pSrc, size_t srcLen)
+{
+    return uuid_parse_compact(pUUID, pSrc, srcLen, uuid_parse_base64url_internal);
+}
+
+UUID_API uuid_result uuid_parse_base64url_batch(unsigned char* pUUIDs, size_t uuidCap, const char* pSrc, size_t srcLen, size_t stride, size_t* pUUIDCount)
+{
+    return uuid_parse_batch_internal(pUUIDs, uuidCap, pSrc, srcLen, stride, pUUIDCount, uuid_parse_base64url_internal);
+}
+
+
+/*
+Comparison and hashing. uuid_compare_inline() and uuid_hash_inline() are defined in the header. The
+equality check here can use SSE2 which the header version can't rely on.
+*/
+static UUID_INLINE int uuid_equal_internal(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+{
+#if defined(UUID_SUPPORT_SSE2)
+    __m128i a = _mm_loadu_si128((const __m128i*)pUUIDA);
+    __m128i b = _mm_loadu_si128((const __m128i*)pUUIDB);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF;
+#else
+    return uuid_equal_inline(pUUIDA, pUUIDB);
+#endif
+}
+
+UUID_API int uuid_equal(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+{
+    UUID_ASSERT(pUUIDA != NULL);
+    UUID_ASSERT(pUUIDB != NULL);
+
+    return uuid_equal_internal(pUUIDA, pUUIDB);
+}
+
+UUID_API int uuid_compare(const unsigned char* pUUIDA, const unsigned char* pUUIDB)
+{
+    UUID_ASSERT(pUUIDA != NULL);
+    UUID_ASSERT(pUUIDB != NULL);
+
+    return uuid_compare_inline(pUUIDA, pUUIDB);
+}
+
+UUID_API int uuid_is_nil(const unsigned char* pUUID)
+{
+    UUID_ASSERT(pUUID != NULL);
+
+    return (uuid_load_le64(pUUID + 0) | uuid_load_le64(pUUID + 8)) == 0;
+}
+
+UUID_API uuid_uint64 uuid_hash(const unsigned char* pUUID, uuid_uint64 seed)
+{
+    UUID_ASSERT(pUUID != NULL);
+
+    return uuid_hash_inline(pUUID, seed);
+}
+
+UUID_API uuid_result uuid_equal_batch(int* pResults, const unsigned char* pUUIDsA, const unsigned char* pUUIDsB, size_t count)
+{
+    size_t i;
+
+    if (pResults == NULL || pUUIDsA == NULL || pUUIDsB == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    for (i = 0; i < count; i += 1) {
+        pResults[i] = uuid_equal_internal(pUUIDsA + (i * UUID_SIZE), pUUIDsB + (i * UUID_SIZE));
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_compare_batch(int* pResults, const unsigned char* pUUIDsA, const unsigned char* pUUIDsB, size_t count)
+{
+    size_t i;
+
+    if (pResults == NULL || pUUIDsA == NULL || pUUIDsB == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    for (i = 0; i < count; i += 1) {
+        pResults[i] = uuid_compare_inline(pUUIDsA + (i * UUID_SIZE), pUUIDsB + (i * UUID_SIZE));
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_hash_batch(uuid_uint64* pHashes, const unsigned char* pUUIDs, size_t count, uuid_uint64 seed)
+{
+    size_t i;
+
+    if (pHashes == NULL || pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Each hash is independent so the multiplies from neighbouring iterations overlap. */
+    for (i = 0; i < count; i += 1) {
+        pHashes[i] = uuid_hash_inline(pUUIDs + (i * UUID_SIZE), seed);
+    }
+
+    return UUID_SUCCESS;
+}
+
+
+
+/*
+Memory allocation.
+*/
+static void* uuid_malloc(size_t sz, const uuid_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pAllocationCallbacks != NULL && pAllocationCallbacks->onMalloc != NULL) {
+        return pAllocationCallbacks->onMalloc(sz, pAllocationCallbacks->pUserData);
+    }
+
+    if (pAllocationCallbacks != NULL && (pAllocationCallbacks->onRealloc != NULL || pAllocationCallbacks->onFree != NULL)) {
+        return NULL;    /* Partially set callbacks. Don't mix allocators. */
+    }
+
+    return UUID_MALLOC(sz);
+}
+
+static void uuid_free(void* p, const uuid_allocation_callbacks* pAllocationCallbacks)
+{
+    if (p == NULL) {
+        return;
+    }
+
+    if (pAllocationCallbacks != NULL && pAllocationCallbacks->onFree != NULL) {
+        pAllocationCallbacks->onFree(p, pAllocationCallbacks->pUserData);
+        return;
+    }
+
+    if (pAllocationCallbacks != NULL && (pAllocationCallbacks->onMalloc != NULL || pAllocationCallbacks->onRealloc != NULL)) {
+        return;
+    }
+
+    UUID_FREE(p);
+}
+
+
+
+/*
+Hash map. The table is split into groups of 16 slots. The control bytes of a group are checked
+together with a single SSE2 compare. A control byte is either UUID_MAP_CTRL_EMPTY, UUID_MAP_CTRL_DELETED
+or the top 7 bits of the hash of the key in that slot. The low bits of the hash select the first
+group, and if the key is not found there the following groups are visited in triangular order which
+visits every group once when the number of groups is a power of two. Lookups stop at the first group
+with an empty slot.
+
+A removed slot can only be marked as empty if its group already has an empty slot. Otherwise a lookup
+for a key that was inserted further along while the group was full would stop early. These slots are
+marked as deleted instead and are reused by inserts and cleared out when the table is rehashed.
+*/
+#define UUID_MAP_GROUP_SIZE     16
+#define UUID_MAP_CTRL_EMPTY     0x80
+#define UUID_MAP_CTRL_DELETED   0xFE
+#define UUID_MAP_PREFETCH_DISTANCE 8     /* Slots are prefetched this many keys ahead, and control bytes twice as far. */
+
+#if defined(__GNUC__)
+    #define UUID_PREFETCH(p)    __builtin_prefetch((p))
+#elif defined(UUID_SUPPORT_SSE2)
+    #define UUID_PREFETCH(p)    _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+    #define UUID_PREFETCH(p)    (void)(p)
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h> /* For _BitScanForward(). */
+#endif
+
+/* Index of the lowest set bit. x cannot be 0. */
+static UUID_INLINE unsigned int uuid_ctz32(uuid_uint32 x)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (unsigned int)index;
+#else
+    unsigned int index = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        index += 1;
+    }
+    return index;
+#endif
+}
+
+/* Bit i is set if control byte i of the group matches. */
+static UUID_INLINE uuid_uint32 uuid_map_group_match(const unsigned char* pGroup, unsigned char h2)
+{
+#if defined(UUID_SUPPORT_SSE2)
+    return (uuid_uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)pGroup), _mm_set1_epi8((char)h2)));
+#else
+    uuid_uint32 mask = 0;
+    int i;
+
+    for (i = 0; i < UUID_MAP_GROUP_SIZE; i += 1) {
+        mask |= (uuid_uint32)(pGroup[i] == h2) << i;
+    }
+
+    return mask;
+#endif
+}
+
+/* Both empty and deleted control bytes have the high bit set. */
+static UUID_INLINE uuid_uint32 uuid_map_group_match_empty_or_deleted(const unsigned char* pGroup)
+{
+#if defined(UUID_SUPPORT_SSE2)
+    return (uuid_uint32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)pGroup));
+#else
+    uuid_uint32 mask = 0;
+    int i;
+
+    for (i = 0; i < UUID_MAP_GROUP_SIZE; i += 1) {
+        mask |= (uuid_uint32)(pGroup[i] >> 7) << i;
+    }
+
+    return mask;
+#endif
+}
+
+static UUID_INLINE uuid_uint32 uuid_map_group_match_empty(const unsigned char* pGroup)
+{
+    return uuid_map_group_match(pGroup, UUID_MAP_CTRL_EMPTY);
+}
+
+/*
+With UUID_MAP_FLAG_RANDOM_KEYS the hash is the second half of the key folded onto itself. For version
+4 and 7 UUIDs these 8 bytes are random apart from the 2 variant bits which the fold XOR's with random
+bits. The top 7 bits, which are used for the control byte, come from the last byte.
+*/
+static UUID_INLINE uuid_uint64 uuid_map_hash(const uuid_map* pMap, const unsigned char* pKey)
+{
+    if ((pMap->config.flags & UUID_MAP_FLAG_RANDOM_KEYS) != 0) {
+        uuid_uint64 x = uuid_load_le64(pKey + 8);
+        return x ^ (x >> 32);
+    } else {
+        return uuid_hash_inline(pKey, pMap->config.seed);
+    }
+}
+
+static UUID_INLINE unsigned char uuid_map_h2(uuid_uint64 hash)
+{
+    return (unsigned char)(hash >> 57);
+}
+
+static UUID_INLINE unsigned char* uuid_map_slot(const uuid_map* pMap, size_t index)
+{
+    return pMap->pSlots + (index * pMap->slotSize);
+}
+
+/* The number of items that can be stored before growing. The maximum load factor is 7/8. */
+static size_t uuid_map_max_count(size_t capacity)
+{
+    return capacity - (capacity / 8);
+}
+
+/* Returns the index of the slot holding the key, or (size_t)-1 if it's not in the map. */
+static UUID_INLINE size_t uuid_map_find_index(const uuid_map* pMap, const unsigned char* pKey, uuid_uint64 hash)
+{
+    size_t groupMask;
+    size_t group;
+    size_t probe;
+    unsigned char h2 = uuid_map_h2(hash);
+
+    if (pMap->capacity == 0) {
+        return (size_t)-1;
+    }
+
+    groupMask = (pMap->capacity / UUID_MAP_GROUP_SIZE) - 1;
+    group     = (size_t)hash & groupMask;
+
+    for (probe = 1; ; probe += 1) {
+        const unsigned char* pGroup = pMap->pControl + (group * UUID_MAP_GROUP_SIZE);
+        uuid_uint32 match = uuid_map_group_match(pGroup, h2);
+
+        while (match != 0) {
+            size_t index = (group * UUID_MAP_GROUP_SIZE) + uuid_ctz32(match);
+            if (uuid_equal_internal(uuid_map_slot(pMap, index), pKey)) {
+                return index;
+            }
+
+            match &= match - 1;
+        }
+
+        if (uuid_map_group_match_empty(pGroup) != 0) {
+            return (size_t)-1;
+        }
+
+        group = (group + probe) & groupMask;
+    }
+}
+
+/* Returns the index of the first empty or deleted slot in the probe sequence. There must be one. */
+static UUID_INLINE size_t uuid_map_find_insert_index(const uuid_map* pMap, uuid_uint64 hash)
+{
+    size_t groupMask = (pMap->capacity / UUID_MAP_GROUP_SIZE) - 1;
+    size_t group     = (size_t)hash & groupMask;
+    size_t probe;
+
+    for (probe = 1; ; probe += 1) {
+        uuid_uint32 match = uuid_map_group_match_empty_or_deleted(pMap->pControl + (group * UUID_MAP_GROUP_SIZE));
+        if (match != 0) {
+            return (group * UUID_MAP_GROUP_SIZE) + uuid_ctz32(match);
+        }
+
+        group = (group + probe) & groupMask;
+    }
+}
+
+/*
+Prefetching for the batch APIs. The control bytes are prefetched first. Once they've arrived the slot
+that the key is most likely in can be prefetched too, which is the first slot with a matching control
+byte, or the first empty slot if there isn't one which is where it would be inserted.
+*/
+static UUID_INLINE void uuid_map_prefetch_control(const uuid_map* pMap, uuid_uint64 hash)
+{
+    size_t group = (size_t)hash & ((pMap->capacity / UUID_MAP_GROUP_SIZE) - 1);
+    UUID_PREFETCH(pMap->pControl + (group * UUID_MAP_GROUP_SIZE));
+}
+
+static UUID_INLINE void uuid_map_prefetch_slot(const uuid_map* pMap, uuid_uint64 hash)
+{
+    size_t group = (size_t)hash & ((pMap->capacity / UUID_MAP_GROUP_SIZE) - 1);
+    const unsigned char* pGroup = pMap->pControl + (group * UUID_MAP_GROUP_SIZE);
+    uuid_uint32 match;
+
+    match = uuid_map_group_match(pGroup, uuid_map_h2(hash));
+    if (match == 0) {
+        match = uuid_map_group_match_empty_or_deleted(pGroup);
+    }
+
+    if (match != 0) {
+        UUID_PREFETCH(uuid_map_slot(pMap, (group * UUID_MAP_GROUP_SIZE) + uuid_ctz32(match)));
+    }
+}
+
+/* Moves everything into a new table with the given capacity. This also clears out deleted slots. */
+static uuid_result uuid_map_rehash(uuid_map* pMap, size_t capacity)
+{
+    unsigned char* pNewControl;
+    unsigned char* pNewSlots;
+    unsigned char* pOldControl = pMap->pControl;
+    unsigned char* pOldSlots   = pMap->pSlots;
+    size_t oldCapacity = pMap->capacity;
+    size_t i;
+
+    UUID_ASSERT(capacity >= UUID_MAP_GROUP_SIZE);
+    UUID_ASSERT((capacity & (capacity - 1)) == 0);
+    UUID_ASSERT(uuid_map_max_count(capacity) >= pMap->count);
+
+    if (capacity > ((size_t)-1) / (pMap->slotSize + 1)) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    /* The control bytes and slots are in a single allocation. The slots come first to keep them aligned. */
+    pNewSlots = (unsigned char*)uuid_malloc(capacity * (pMap->slotSize + 1), &pMap->config.allocationCallbacks);
+    if (pNewSlots == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    pNewControl = pNewSlots + (capacity * pMap->slotSize);
+    memset(pNewControl, UUID_MAP_CTRL_EMPTY, capacity);
+
+    pMap->pControl   = pNewControl;
+    pMap->pSlots     = pNewSlots;
+    pMap->capacity   = capacity;
+    pMap->growthLeft = uuid_map_max_count(capacity) - pMap->count;
+
+    for (i = 0; i < oldCapacity; i += 1) {
+        if ((pOldControl[i] & 0x80) == 0) {
+            const unsigned char* pOldSlot = pOldSlots + (i * pMap->slotSize);
+            uuid_uint64 hash  = uuid_map_hash(pMap, pOldSlot);
+            size_t index = uuid_map_find_insert_index(pMap, hash);
+
+            pNewControl[index] = uuid_map_h2(hash);
+            UUID_COPY_MEMORY(uuid_map_slot(pMap, index), pOldSlot, pMap->slotSize);
+        }
+    }
+
+    uuid_free(pOldSlots, &pMap->config.allocationCallbacks);
+
+    return UUID_SUCCESS;
+}
+
+static size_t uuid_map_capacity_for_count(size_t count)
+{
+    size_t capacity = UUID_MAP_GROUP_SIZE;
+
+    while (uuid_map_max_count(capacity) < count) {
+        if (capacity > ((size_t)-1) / 2) {
+            return 0;   /* Too big. */
+        }
+
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+/* Makes room for one more item. */
+static uuid_result uuid_map_grow(uuid_map* pMap)
+{
+    size_t capacity;
+
+    if (pMap->capacity == 0) {
+        capacity = UUID_MAP_GROUP_SIZE;
+    } else if (pMap->count < uuid_map_max_count(pMap->capacity) / 2) {
+        capacity = pMap->capacity;      /* Mostly deleted slots. Clean them out without growing. */
+    } else {
+        if (pMap->capacity > ((size_t)-1) / 2) {
+            return UUID_OUT_OF_MEMORY;
+        }
+
+        capacity = pMap->capacity * 2;
+    }
+
+    return uuid_map_rehash(pMap, capacity);
+}
+
+static uuid_result uuid_map_insert_internal(uuid_map* pMap, const unsigned char* pKey, uuid_uint64 hash, const void* pValue, void** ppValue)
+{
+    size_t index;
+    unsigned char* pSlot;
+
+    index = uuid_map_find_index(pMap, pKey, hash);
+    if (index != (size_t)-1) {
+        if (ppValue != NULL) {
+            *ppValue = uuid_map_slot(pMap, index) + UUID_SIZE;
+        }
+
+        return UUID_ALREADY_EXISTS;
+    }
+
+    if (pMap->capacity == 0) {
+        uuid_result result = uuid_map_grow(pMap);
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
+    }
+
+    index = uuid_map_find_insert_index(pMap, hash);
+
+    /* Reusing a deleted slot doesn't use up any of the growth budget. */
+    if (pMap->pControl[index] == UUID_MAP_CTRL_EMPTY) {
+        if (pMap->growthLeft == 0) {
+            uuid_result result = uuid_map_grow(pMap);
+            if (result != UUID_SUCCESS) {
+                return result;
+            }
+
+            index = uuid_map_find_insert_index(pMap, hash);
+        }
+
+        pMap->growthLeft -= 1;
+    }
+
+    pMap->pControl[index] = uuid_map_h2(hash);
+    pMap->count += 1;
+
+    pSlot = uuid_map_slot(pMap, index);
+    UUID_COPY_MEMORY(pSlot, pKey, UUID_SIZE);
+
+    if (pMap->config.valueSize > 0) {
+        if (pValue != NULL) {
+            UUID_COPY_MEMORY(pSlot + UUID_SIZE, pValue, pMap->config.valueSize);
+        } else {
+            UUID_ZERO_MEMORY(pSlot + UUID_SIZE, pMap->config.valueSize);
+        }
+    }
+
+    if (ppValue != NULL) {
+        *ppValue = pSlot + UUID_SIZE;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_map_config uuid_map_config_init(size_t valueSize)
+{
+    uuid_map_config config;
+
+    UUID_ZERO_OBJECT(&config);
+    config.valueSize = valueSize;
+
+    return config;
+}
+
+UUID_API uuid_result uuid_map_init(const uuid_map_config* pConfig, uuid_map* pMap)
+{
+    if (pMap == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pMap);
+
+    if (pConfig == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    pMap->config = *pConfig;
+
+    /* Slots are padded to 8 bytes so values can be accessed in place. */
+    pMap->slotSize = UUID_SIZE + ((pConfig->valueSize + 7) & ~(size_t)7);
+    if (pMap->slotSize < pConfig->valueSize) {
+        return UUID_INVALID_ARGS;   /* Overflow. */
+    }
+
+    if (pConfig->initialCapacity > 0) {
+        uuid_result result = uuid_map_reserve(pMap, pConfig->initialCapacity);
+        if (result != UUID_SUCCESS) {
+            UUID_ZERO_OBJECT(pMap);
+            return result;
+        }
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_map_uninit(uuid_map* pMap)
+{
+    if (pMap == NULL) {
+        return;
+    }
+
+    uuid_free(pMap->pSlots, &pMap->config.allocationCallbacks);
+    UUID_ZERO_OBJECT(pMap);
+}
+
+UUID_API uuid_result uuid_map_reserve(uuid_map* pMap, size_t count)
+{
+    size_t capacity;
+
+    if (pMap == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (count <= pMap->count + pMap->growthLeft) {
+        return UUID_SUCCESS;    /* Already have room. */
+    }
+
+    capacity = uuid_map_capacity_for_count(count);
+    if (capacity == 0) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    return uuid_map_rehash(pMap, capacity);
+}
+
+UUID_API void uuid_map_clear(uuid_map* pMap)
+{
+    if (pMap == NULL || pMap->capacity == 0) {
+        return;
+    }
+
+    /* Keep the memory around. */
+    memset(pMap->pControl, UUID_MAP_CTRL_EMPTY, pMap->capacity);
+    pMap->count      = 0;
+    pMap->growthLeft = uuid_map_max_count(pMap->capacity);
+}
+
+UUID_API size_t uuid_map_count(const uuid_map* pMap)
+{
+    if (pMap == NULL) {
+        return 0;
+    }
+
+    return pMap->count;
+}
+
+UUID_API uuid_result uuid_map_insert(uuid_map* pMap, const unsigned char* pKey, const void* pValue, void** ppValue)
+{
+    if (ppValue != NULL) {
+        *ppValue = NULL;
+    }
+
+    if (pMap == NULL || pKey == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_insert_internal(pMap, pKey, uuid_map_hash(pMap, pKey), pValue, ppValue);
+}
+
+UUID_API uuid_result uuid_map_find(const uuid_map* pMap, const unsigned char* pKey, void** ppValue)
+{
+    size_t index;
+
+    if (ppValue != NULL) {
+        *ppValue = NULL;
+    }
+
+    if (pMap == NULL || pKey == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    index = uuid_map_find_index(pMap, pKey, uuid_map_hash(pMap, pKey));
+    if (index == (size_t)-1) {
+        return UUID_DOES_NOT_EXIST;
+    }
+
+    if (ppValue != NULL) {
+        *ppValue = uuid_map_slot(pMap, index) + UUID_SIZE;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_map_remove(uuid_map* pMap, const unsigned char* pKey)
+{
+    size_t index;
+
+    if (pMap == NULL || pKey == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    index = uuid_map_find_index(pMap, pKey, uuid_map_hash(pMap, pKey));
+    if (index == (size_t)-1) {
+        return UUID_DOES_NOT_EXIST;
+    }
+
+    if (uuid_map_group_match_empty(pMap->pControl + (index & ~(size_t)(UUID_MAP_GROUP_SIZE - 1))) != 0) {
+        pMap->pControl[index] = UUID_MAP_CTRL_EMPTY;
+        pMap->growthLeft += 1;
+    } else {
+        pMap->pControl[index] = UUID_MAP_CTRL_DELETED;
+    }
+
+    pMap->count -= 1;
+
+    return UUID_SUCCESS;
+}
+
+/*
+The batch versions hide the cache misses of large tables by working ahead of the key currently being
+processed. See uuid_map_prefetch_slot(). The hashes are kept in a ring buffer so they're only
+calculated once. Space is reserved up front for inserts so the table doesn't get rehashed part way
+through, which means duplicates in the batch can cause it to grow more than necessary.
+*/
+#define UUID_MAP_HASH_RING_SIZE (UUID_MAP_PREFETCH_DISTANCE * 2)
+
+static void uuid_map_batch_begin(const uuid_map* pMap, const unsigned char* pKeys, size_t count, uuid_uint64* pHashes)
+{
+    size_t i;
+
+    for (i = 0; i < count && i < UUID_MAP_HASH_RING_SIZE; i += 1) {
+        pHashes[i] = uuid_map_hash(pMap, pKeys + (i * UUID_SIZE));
+        uuid_map_prefetch_control(pMap, pHashes[i]);
+    }
+
+    for (i = 0; i < count && i < UUID_MAP_PREFETCH_DISTANCE; i += 1) {
+        uuid_map_prefetch_slot(pMap, pHashes[i]);
+    }
+}
+
+/* Returns the hash of key i and starts prefetching for the keys ahead of it. */
+static UUID_INLINE uuid_uint64 uuid_map_batch_step(const uuid_map* pMap, const unsigned char* pKeys, size_t count, uuid_uint64* pHashes, size_t i)
+{
+    uuid_uint64 hash = pHashes[i % UUID_MAP_HASH_RING_SIZE];
+
+    if (i + UUID_MAP_HASH_RING_SIZE < count) {
+        uuid_uint64 nextHash = uuid_map_hash(pMap, pKeys + ((i + UUID_MAP_HASH_RING_SIZE) * UUID_SIZE));
+        pHashes[i % UUID_MAP_HASH_RING_SIZE] = nextHash;
+        uuid_map_prefetch_control(pMap, nextHash);
+    }
+
+    if (i + UUID_MAP_PREFETCH_DISTANCE < count) {
+        uuid_map_prefetch_slot(pMap, pHashes[(i + UUID_MAP_PREFETCH_DISTANCE) % UUID_MAP_HASH_RING_SIZE]);
+    }
+
+    return hash;
+}
+
+/* Either ppValues or pResults will be set depending on whether this is for a map or a set. */
+static size_t uuid_map_find_batch_internal(const uuid_map* pMap, const unsigned char* pKeys, size_t count, void** ppValues, int* pResults)
+{
+    uuid_uint64 hashes[UUID_MAP_HASH_RING_SIZE];
+    size_t foundCount = 0;
+    size_t i;
+
+    if (pMap->capacity == 0) {
+        for (i = 0; i < count; i += 1) {
+            if (ppValues != NULL) {
+                ppValues[i] = NULL;
+            }
+            if (pResults != NULL) {
+                pResults[i] = 0;
+            }
+        }
+
+        return 0;
+    }
+
+    uuid_map_batch_begin(pMap, pKeys, count, hashes);
+
+    for (i = 0; i < count; i += 1) {
+        uuid_uint64 hash  = uuid_map_batch_step(pMap, pKeys, count, hashes, i);
+        size_t index = uuid_map_find_index(pMap, pKeys + (i * UUID_SIZE), hash);
+
+        if (ppValues != NULL) {
+            ppValues[i] = (index != (size_t)-1) ? uuid_map_slot(pMap, index) + UUID_SIZE : NULL;
+        }
+        if (pResults != NULL) {
+            pResults[i] = (index != (size_t)-1);
+        }
+
+        foundCount += (index != (size_t)-1);
+    }
+
+    return foundCount;
+}
+
+UUID_API uuid_result uuid_map_insert_batch(uuid_map* pMap, const unsigned char* pKeys, const void* pValues, size_t count, size_t* pInsertedCount)
+{
+    uuid_result result = UUID_SUCCESS;
+    uuid_uint64 hashes[UUID_MAP_HASH_RING_SIZE];
+    size_t insertedCount = 0;
+    size_t i;
+
+    if (pInsertedCount != NULL) {
+        *pInsertedCount = 0;
+    }
+
+    if (pMap == NULL || (pKeys == NULL && count > 0)) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (count == 0) {
+        return UUID_SUCCESS;
+    }
+
+    if (count > ((size_t)-1) - pMap->count) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    result = uuid_map_reserve(pMap, pMap->count + count);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    uuid_map_batch_begin(pMap, pKeys, count, hashes);
+
+    for (i = 0; i < count; i += 1) {
+        uuid_uint64 hash = uuid_map_batch_step(pMap, pKeys, count, hashes, i);
+        const void* pValue = (pValues != NULL) ? (const unsigned char*)pValues + (i * pMap->config.valueSize) : NULL;
+
+        result = uuid_map_insert_internal(pMap, pKeys + (i * UUID_SIZE), hash, pValue, NULL);
+        if (result == UUID_SUCCESS) {
+            insertedCount += 1;
+        } else if (result != UUID_ALREADY_EXISTS) {
+            break;
+        }
+
+        result = UUID_SUCCESS;
+    }
+
+    if (pInsertedCount != NULL) {
+        *pInsertedCount = insertedCount;
+    }
+
+    return result;
+}
+
+UUID_API uuid_result uuid_map_find_batch(const uuid_map* pMap, const unsigned char* pKeys, size_t count, void** ppValues, size_t* pFoundCount)
+{
+    size_t foundCount;
+
+    if (pFoundCount != NULL) {
+        *pFoundCount = 0;
+    }
+
+    if (pMap == NULL || ppValues == NULL || (pKeys == NULL && count > 0)) {
+        return UUID_INVALID_ARGS;
+    }
+
+    foundCount = uuid_map_find_batch_internal(pMap, pKeys, count, ppValues, NULL);
+
+    if (pFoundCount != NULL) {
+        *pFoundCount = foundCount;
+    }
+
+    return UUID_SUCCESS;
+}
+
+/*
+Iteration. Initialize the iterator to 0 and call this until it returns UUID_DOES_NOT_EXIST. The map
+must not be modified while iterating.
+*/
+UUID_API uuid_result uuid_map_next(const uuid_map* pMap, size_t* pIterator, const unsigned char** ppKey, void** ppValue)
+{
+    size_t i;
+
+    if (ppKey != NULL) {
+        *ppKey = NULL;
+    }
+    if (ppValue != NULL) {
+        *ppValue = NULL;
+    }
+
+    if (pMap == NULL || pIterator == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    for (i = *pIterator; i < pMap->capacity; i += 1) {
+        if ((pMap->pControl[i] & 0x80) == 0) {
+            unsigned char* pSlot = uuid_map_slot(pMap, i);
+
+            if (ppKey != NULL) {
+                *ppKey = pSlot;
+            }
+            if (ppValue != NULL) {
+                *ppValue = pSlot + UUID_SIZE;
+            }
+
+            *pIterator = i + 1;
+            return UUID_SUCCESS;
+        }
+    }
+
+    *pIterator = pMap->capacity;
+    return UUID_DOES_NOT_EXIST;
+}
+
+
+UUID_API uuid_set_config uuid_set_config_init(void)
+{
+    return uuid_map_config_init(0);
+}
+
+UUID_API uuid_result uuid_set_init(const uuid_set_config* pConfig, uuid_set* pSet)
+{
+    uuid_map_config config;
+
+    if (pSet == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pSet);
+
+    if (pConfig == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    config = *pConfig;
+    config.valueSize = 0;
+
+    return uuid_map_init(&config, &pSet->map);
+}
+
+UUID_API void uuid_set_uninit(uuid_set* pSet)
+{
+    if (pSet == NULL) {
+        return;
+    }
+
+    uuid_map_uninit(&pSet->map);
+}
+
+UUID_API uuid_result uuid_set_reserve(uuid_set* pSet, size_t count)
+{
+    if (pSet == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_reserve(&pSet->map, count);
+}
+
+UUID_API void uuid_set_clear(uuid_set* pSet)
+{
+    if (pSet == NULL) {
+        return;
+    }
+
+    uuid_map_clear(&pSet->map);
+}
+
+UUID_API size_t uuid_set_count(const uuid_set* pSet)
+{
+    if (pSet == NULL) {
+        return 0;
+    }
+
+    return pSet->map.count;
+}
+
+UUID_API uuid_result uuid_set_insert(uuid_set* pSet, const unsigned char* pKey)
+{
+    if (pSet == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_insert(&pSet->map, pKey, NULL, NULL);
+}
+
+UUID_API int uuid_set_contains(const uuid_set* pSet, const unsigned char* pKey)
+{
+    if (pSet == NULL) {
+        return 0;
+    }
+
+    return uuid_map_find(&pSet->map, pKey, NULL) == UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_set_remove(uuid_set* pSet, const unsigned char* pKey)
+{
+    if (pSet == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_remove(&pSet->map, pKey);
+}
+
+UUID_API uuid_result uuid_set_insert_batch(uuid_set* pSet, const unsigned char* pKeys, size_t count, size_t* pInsertedCount)
+{
+    if (pSet == NULL) {
+        if (pInsertedCount != NULL) {
+            *pInsertedCount = 0;
+        }
+
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_insert_batch(&pSet->map, pKeys, NULL, count, pInsertedCount);
+}
+
+UUID_API uuid_result uuid_set_contains_batch(const uuid_set* pSet, const unsigned char* pKeys, size_t count, int* pResults, size_t* pFoundCount)
+{
+    size_t foundCount;
+
+    if (pFoundCount != NULL) {
+        *pFoundCount = 0;
+    }
+
+    if (pSet == NULL || pResults == NULL || (pKeys == NULL && count > 0)) {
+        return UUID_INVALID_ARGS;
+    }
+
+    foundCount = uuid_map_find_batch_internal(&pSet->map, pKeys, count, NULL, pResults);
+
+    if (pFoundCount != NULL) {
+        *pFoundCount = foundCount;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_set_next(const uuid_set* pSet, size_t* pIterator, const unsigned char** ppKey)
+{
+    if (pSet == NULL) {
+        if (ppKey != NULL) {
+            *ppKey = NULL;
+        }
+
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_map_next(&pSet->map, pIterator, ppKey, NULL);
+}
+
+
+
+/*
+Sorting. This is a radix sort on bytes. Bytes that are the same in every UUID are skipped which for
+time-based UUIDs is most of the timestamp and the version and variant. Large arrays are first split
+into 256 buckets by their most significant differing byte (MSD), and this repeats until a bucket is
+small enough to fit in cache. These buckets are then sorted with one pass for each remaining byte,
+starting with the least significant (LSD). Very small buckets use an insertion sort instead.
+
+Arrays that start with a sorted run, such as from a monotonic generator, only have the rest sorted
+before being merged with the run.
+*/
+#define UUID_SORT_LSD_THRESHOLD         32768   /* 1MB of data and scratch. The counts must fit in 32 bits. */
+#define UUID_SORT_INSERTION_THRESHOLD   48
+#define UUID_SORT_MT_THRESHOLD          65536   /* Arrays smaller than this aren't worth the overhead of threads. */
+#define UUID_SORT_MAX_THREADS           64
+
+/* Bit i is set if byte i is not the same in every UUID. */
+static unsigned int uuid_sort_varying_bytes(const unsigned char* pUUIDs, size_t count)
+{
+    uuid_uint64 first0 = uuid_load_le64(pUUIDs + 0);
+    uuid_uint64 first1 = uuid_load_le64(pUUIDs + 8);
+    uuid_uint64 diff0  = 0;
+    uuid_uint64 diff1  = 0;
+    unsigned int mask = 0;
+    size_t i;
+
+    for (i = 1; i < count; i += 1) {
+        diff0 |= uuid_load_le64(pUUIDs + (i * UUID_SIZE) + 0) ^ first0;
+        diff1 |= uuid_load_le64(pUUIDs + (i * UUID_SIZE) + 8) ^ first1;
+    }
+
+    for (i = 0; i < 8; i += 1) {
+        if (((diff0 >> (i * 8)) & 0xFF) != 0) {
+            mask |= 1U << i;
+        }
+        if (((diff1 >> (i * 8)) & 0xFF) != 0) {
+            mask |= 1U << (i + 8);
+        }
+    }
+
+    return mask;
+}
+
+/* The number of UUIDs at the start of the array that are already in order. */
+static size_t uuid_sort_sorted_prefix(const unsigned char* pUUIDs, size_t count)
+{
+    size_t i;
+
+    for (i = 1; i < count; i += 1) {
+        if (uuid_compare_inline(pUUIDs + ((i - 1) * UUID_SIZE), pUUIDs + (i * UUID_SIZE)) > 0) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+static void uuid_sort_insertion(unsigned char* pUUIDs, size_t count)
+{
+    unsigned char temp[UUID_SIZE];
+    size_t i;
+    size_t j;
+
+    for (i = 1; i < count; i += 1) {
+        UUID_COPY_MEMORY(temp, pUUIDs + (i * UUID_SIZE), UUID_SIZE);
+
+        for (j = i; j > 0 && uuid_compare_inline(pUUIDs + ((j - 1) * UUID_SIZE), temp) > 0; j -= 1) {
+            UUID_COPY_MEMORY(pUUIDs + (j * UUID_SIZE), pUUIDs + ((j - 1) * UUID_SIZE), UUID_SIZE);
+        }
+
+        UUID_COPY_MEMORY(pUUIDs + (j * UUID_SIZE), temp, UUID_SIZE);
+    }
+}
+
+/* One pass per byte in the mask, least significant first. The counts for every byte are done up front in a single pass. */
+static void uuid_sort_lsd(unsigned char* pUUIDs, unsigned char* pScratch, size_t count, unsigned int mask)
+{
+    uuid_uint32 counts[UUID_SIZE][256];
+    unsigned char* pSrc = pUUIDs;
+    unsigned char* pDst = pScratch;
+    size_t i;
+    int iByte;
+
+    UUID_ASSERT(count <= UUID_SORT_LSD_THRESHOLD);
+
+    UUID_ZERO_MEMORY(counts, sizeof(counts));
+
+    for (i = 0; i < count; i += 1) {
+        const unsigned char* pUUID = pUUIDs + (i * UUID_SIZE);
+        for (iByte = 0; iByte < UUID_SIZE; iByte += 1) {
+            counts[iByte][pUUID[iByte]] += 1;
+        }
+    }
+
+    for (iByte = UUID_SIZE - 1; iByte >= 0; iByte -= 1) {
+        uuid_uint32* pOffsets = counts[iByte];
+        uuid_uint32 offset = 0;
+        unsigned char* pTemp;
+        int iValue;
+
+        if ((mask & (1U << iByte)) == 0) {
+            continue;
+        }
+
+        for (iValue = 0; iValue < 256; iValue += 1) {
+            uuid_uint32 valueCount = pOffsets[iValue];
+            pOffsets[iValue] = offset;
+            offset += valueCount;
+        }
+
+        for (i = 0; i < count; i += 1) {
+            const unsigned char* pUUID = pSrc + (i * UUID_SIZE);
+            UUID_COPY_MEMORY(pDst + (pOffsets[pUUID[iByte]] * UUID_SIZE), pUUID, UUID_SIZE);
+            pOffsets[pUUID[iByte]] += 1;
+        }
+
+        pTemp = pSrc;
+        pSrc  = pDst;
+        pDst  = pTemp;
+    }
+
+    if (pSrc != pUUIDs) {
+        UUID_COPY_MEMORY(pUUIDs, pSrc, count * UUID_SIZE);
+    }
+}
+
+/* Sorts pUUIDs in place. Bytes before firstByte are known to be the same in every UUID. */
+static void uuid_sort_msd(unsigned char* pUUIDs, unsigned char* pScratch, size_t count, unsigned int firstByte)
+{
+    size_t counts[256];
+    size_t offsets[256];
+    size_t offset;
+    size_t i;
+    unsigned int mask;
+    unsigned int iByte;
+    int iValue;
+
+    if (count < UUID_SORT_INSERTION_THRESHOLD) {
+        uuid_sort_insertion(pUUIDs, count);
+        return;
+    }
+
+    mask = uuid_sort_varying_bytes(pUUIDs, count) & (0xFFFFU << firstByte) & 0xFFFFU;
+    if (mask == 0) {
+        return; /* They're all the same. */
+    }
+
+    if (count <= UUID_SORT_LSD_THRESHOLD) {
+        uuid_sort_lsd(pUUIDs, pScratch, count, mask);
+        return;
+    }
+
+    iByte = uuid_ctz32(mask);
+
+    UUID_ZERO_MEMORY(counts, sizeof(counts));
+    for (i = 0; i < count; i += 1) {
+        counts[pUUIDs[(i * UUID_SIZE) + iByte]] += 1;
+    }
+
+    offset = 0;
+    for (iValue = 0; iValue < 256; iValue += 1) {
+        offsets[iValue] = offset;
+        offset += counts[iValue];
+    }
+
+    for (i = 0; i < count; i += 1) {
+        const unsigned char* pUUID = pUUIDs + (i * UUID_SIZE);
+        UUID_COPY_MEMORY(pScratch + (offsets[pUUID[iByte]] * UUID_SIZE), pUUID, UUID_SIZE);
+        offsets[pUUID[iByte]] += 1;
+    }
+
+    /* The buckets are now in the scratch buffer. Sort each one there and then copy it back while it's still in cache. */
+    offset = 0;
+    for (iValue = 0; iValue < 256; iValue += 1) {
+        if (counts[iValue] > 0) {
+            uuid_sort_msd(pScratch + (offset * UUID_SIZE), pUUIDs + (offset * UUID_SIZE), counts[iValue], iByte + 1);
+            UUID_COPY_MEMORY(pUUIDs + (offset * UUID_SIZE), pScratch + (offset * UUID_SIZE), counts[iValue] * UUID_SIZE);
+            offset += counts[iValue];
+        }
+    }
+}
+
+/* Merges two adjacent sorted runs. The second run is moved into the scratch buffer and then the two are merged from the back. */
+static void uuid_sort_merge_adjacent(unsigned char* pUUIDs, unsigned char* pScratch, size_t count, size_t splitIndex)
+{
+    size_t iA = splitIndex;
+    size_t iB = count - splitIndex;
+    size_t iOut = count;
+
+    UUID_COPY_MEMORY(pScratch, pUUIDs + (splitIndex * UUID_SIZE), (count - splitIndex) * UUID_SIZE);
+
+    while (iB > 0) {
+        if (iA > 0 && uuid_compare_inline(pUUIDs + ((iA - 1) * UUID_SIZE), pScratch + ((iB - 1) * UUID_SIZE)) > 0) {
+            iA -= 1;
+            UUID_COPY_MEMORY(pUUIDs + ((iOut - 1) * UUID_SIZE), pUUIDs + (iA * UUID_SIZE), UUID_SIZE);
+        } else {
+            iB -= 1;
+            UUID_COPY_MEMORY(pUUIDs + ((iOut - 1) * UUID_SIZE), pScratch + (iB * UUID_SIZE), UUID_SIZE);
+        }
+
+        iOut -= 1;
+    }
+}
+
+
+#if defined(UUID_SUPPORT_THREADS)
+/*
+Multi-threaded sorting. The array is split into one chunk per thread and each thread counts the
+bytes in its chunk. These are combined to find the most significant byte that differs, and then each
+thread moves its chunk into the right buckets in the scratch buffer. If that byte only has a few
+different values, such as the top of a timestamp, the following byte is included as well so there's
+enough buckets to go around. The threads then take buckets one at a time and sort them.
+*/
+typedef struct
+{
+    unsigned char* pUUIDs;
+    unsigned char* pScratch;
+    size_t count;
+    unsigned int threadCount;
+    unsigned int digitByte;         /* The most significant byte of the digit that the buckets are split on. */
+    unsigned int digitBytes;        /* 1 or 2. */
+    size_t* pCounts;                /* [threadCount][UUID_SIZE][256] for the first pass, then [threadCount][bucketCount] offsets. */
+    size_t* pBucketCounts;          /* [bucketCount] */
+    volatile uuid_uint32 nextBucket;
+    int phase;
+} uuid_sort_mt_job;
+
+typedef struct
+{
+    uuid_sort_mt_job* pJob;
+    unsigned int threadIndex;
+} uuid_sort_mt_thread;
+
+#define UUID_SORT_MT_PHASE_COUNT_BYTES  0
+#define UUID_SORT_MT_PHASE_COUNT_DIGITS 1
+#define UUID_SORT_MT_PHASE_SCATTER      2
+#define UUID_SORT_MT_PHASE_SORT_BUCKETS 3
+
+static size_t uuid_sort_mt_digit(const uuid_sort_mt_job* pJob, const unsigned char* pUUID)
+{
+    if (pJob->digitBytes == 2) {
+        return ((size_t)pUUID[pJob->digitByte] << 8) | pUUID[pJob->digitByte + 1];
+    } else {
+        return pUUID[pJob->digitByte];
+    }
+}
+
+static void uuid_sort_mt_thread_entry(void* pUserData)
+{
+    uuid_sort_mt_thread* pThread = (uuid_sort_mt_thread*)pUserData;
+    uuid_sort_mt_job* pJob = pThread->pJob;
+    size_t chunkSize = (pJob->count + pJob->threadCount - 1) / pJob->threadCount;
+    size_t chunkBeg  = chunkSize * pThread->threadIndex;
+    size_t chunkEnd  = chunkBeg + chunkSize;
+    size_t bucketCount = (size_t)1 << (pJob->digitBytes * 8);
+    size_t i;
+
+    if (chunkBeg > pJob->count) {
+        chunkBeg = pJob->count;
+    }
+    if (chunkEnd > pJob->count) {
+        chunkEnd = pJob->count;
+    }
+
+    if (pJob->phase == UUID_SORT_MT_PHASE_COUNT_BYTES) {
+        size_t* pCounts = pJob->pCounts + (pThread->threadIndex * UUID_SIZE * 256);
+        unsigned int iByte;
+
+        for (i = chunkBeg; i < chunkEnd; i += 1) {
+            const unsigned char* pUUID = pJob->pUUIDs + (i * UUID_SIZE);
+            for (iByte = 0; iByte < UUID_SIZE; iByte += 1) {
+                pCounts[(iByte * 256) + pUUID[iByte]] += 1;
+            }
+        }
+    } else if (pJob->phase == UUID_SORT_MT_PHASE_COUNT_DIGITS) {
+        size_t* pCounts = pJob->pCounts + (pThread->threadIndex * bucketCount);
+
+        for (i = chunkBeg; i < chunkEnd; i += 1) {
+            pCounts[uuid_sort_mt_digit(pJob, pJob->pUUIDs + (i * UUID_SIZE))] += 1;
+        }
+    } else if (pJob->phase == UUID_SORT_MT_PHASE_SCATTER) {
+        size_t* pOffsets = pJob->pCounts + (pThread->threadIndex * bucketCount);
+
+        for (i = chunkBeg; i < chunkEnd; i += 1) {
+            const unsigned char* pUUID = pJob->pUUIDs + (i * UUID_SIZE);
+            size_t digit = uuid_sort_mt_digit(pJob, pUUID);
+
+            UUID_COPY_MEMORY(pJob->pScratch + (pOffsets[digit] * UUID_SIZE), pUUID, UUID_SIZE);
+            pOffsets[digit] += 1;
+        }
+    } else {
+        for (;;) {
+            size_t bucket = uuid_atomic_fetch_add_32(&pJob->nextBucket, 1);
+            size_t bucketOffset;
+            size_t bucketSize;
+
+            if (bucket >= bucketCount) {
+                break;
+            }
+
+            bucketSize = pJob->pBucketCounts[bucket];
+            if (bucketSize == 0) {
+                continue;
+            }
+
+            bucketOffset = pJob->pCounts[bucket] - bucketSize;  /* The first row holds the end of each bucket. */
+            uuid_sort_msd(pJob->pScratch + (bucketOffset * UUID_SIZE), pJob->pUUIDs + (bucketOffset * UUID_SIZE), bucketSize, pJob->digitByte + pJob->digitBytes);
+            UUID_COPY_MEMORY(pJob->pUUIDs + (bucketOffset * UUID_SIZE), pJob->pScratch + (bucketOffset * UUID_SIZE), bucketSize * UUID_SIZE);
+        }
+    }
+}
+
+/* Runs the current phase on every thread. The calling thread does the work of the first one. */
+static void uuid_sort_mt_run_phase(uuid_sort_mt_job* pJob, uuid_sort_mt_thread* pThreadData, uuid_thread* pThreads, int phase)
+{
+    unsigned int threadsStarted;
+    unsigned int iThread;
+
+    pJob->phase = phase;
+
+    for (threadsStarted = 1; threadsStarted < pJob->threadCount; threadsStarted += 1) {
+        if (uuid_thread_create(&pThreads[threadsStarted], uuid_sort_mt_thread_entry, &pThreadData[threadsStarted]) != UUID_SUCCESS) {
+            break;
+        }
+    }
+
+    uuid_sort_mt_thread_entry(&pThreadData[0]);
+
+    for (iThread = 1; iThread < threadsStarted; iThread += 1) {
+        uuid_thread_join(&pThreads[iThread]);
+    }
+
+    /* If a thread failed to start its part of the work needs to be done here. */
+    for (iThread = threadsStarted; iThread < pJob->threadCount; iThread += 1) {
+        uuid_sort_mt_thread_entry(&pThreadData[iThread]);
+    }
+}
+
+static uuid_result uuid_sort_mt_internal(unsigned char* pUUIDs, unsigned char* pScratch, size_t count, unsigned int threadCount)
+{
+    uuid_sort_mt_job job;
+    uuid_sort_mt_thread threadData[UUID_SORT_MAX_THREADS];
+    uuid_thread threads[UUID_SORT_MAX_THREADS];
+    size_t bucketCount;
+    size_t distinctCount;
+    size_t offset;
+    size_t iBucket;
+    unsigned int mask;
+    unsigned int iThread;
+    unsigned int iByte;
+
+    UUID_ZERO_OBJECT(&job);
+    job.pUUIDs      = pUUIDs;
+    job.pScratch    = pScratch;
+    job.count       = count;
+    job.threadCount = threadCount;
+
+    /* Enough room for the byte counts of the first pass, or the digit counts of the second, plus the combined bucket counts. */
+    job.pCounts = (size_t*)uuid_malloc(sizeof(size_t) * ((threadCount * 65536) + 65536), NULL);
+    if (job.pCounts == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    job.pBucketCounts = job.pCounts + (threadCount * 65536);
+
+    for (iThread = 0; iThread < threadCount; iThread += 1) {
+        threadData[iThread].pJob        = &job;
+        threadData[iThread].threadIndex = iThread;
+    }
+
+    UUID_ZERO_MEMORY(job.pCounts, sizeof(size_t) * threadCount * UUID_SIZE * 256);
+    uuid_sort_mt_run_phase(&job, threadData, threads, UUID_SORT_MT_PHASE_COUNT_BYTES);
+
+    /* Combine the counts to find the most significant byte that differs. */
+    mask = 0;
+    distinctCount = 0;
+    for (iByte = 0; iByte < UUID_SIZE; iByte += 1) {
+        size_t values = 0;
+        unsigned int iValue;
+
+        for (iValue = 0; iValue < 256; iValue += 1) {
+            size_t valueCount = 0;
+            for (iThread = 0; iThread < threadCount; iThread += 1) {
+                valueCount += job.pCounts[(iThread * UUID_SIZE * 256) + (iByte * 256) + iValue];
+            }
+
+            values += (valueCount > 0);
+        }
+
+        if (values > 1) {
+            if (mask == 0) {
+                distinctCount = values;
+            }
+
+            mask |= 1U << iByte;
+            break;
+        }
+    }
+
+    if (mask == 0) {
+        uuid_free(job.pCounts, NULL);
+        return UUID_SUCCESS;    /* They're all the same. */
+    }
+
+    job.digitByte  = uuid_ctz32(mask);
+    job.digitBytes = (distinctCount < threadCount * 4 && job.digitByte + 1 < UUID_SIZE) ? 2 : 1;
+    bucketCount = (size_t)1 << (job.digitBytes * 8);
+
+    UUID_ZERO_MEMORY(job.pCounts, sizeof(size_t) * threadCount * bucketCount);
+    uuid_sort_mt_run_phase(&job, threadData, threads, UUID_SORT_MT_PHASE_COUNT_DIGITS);
+
+    /* Turn the counts into offsets. Within a bucket, each thread's part follows the previous thread's. */
+    offset = 0;
+    for (iBucket = 0; iBucket < bucketCount; iBucket += 1) {
+        size_t bucketStart = offset;
+
+        for (iThread = 0; iThread < threadCount; iThread += 1) {
+            size_t threadCountInBucket = job.pCounts[(iThread * bucketCount) + iBucket];
+            job.pCounts[(iThread * bucketCount) + iBucket] = offset;
+            offset += threadCountInBucket;
+        }
+
+        job.pBucketCounts[iBucket] = offset - bucketStart;
+    }
+
+    uuid_sort_mt_run_phase(&job, threadData, threads, UUID_SORT_MT_PHASE_SCATTER);
+
+    /* The offsets of the last thread now point to the end of each bucket. Move them into the first row so the bucket offsets can be found. */
+    for (iBucket = 0; iBucket < bucketCount; iBucket += 1) {
+        job.pCounts[iBucket] = job.pCounts[((threadCount - 1) * bucketCount) + iBucket];
+    }
+
+    uuid_sort_mt_run_phase(&job, threadData, threads, UUID_SORT_MT_PHASE_SORT_BUCKETS);
+
+    uuid_free(job.pCounts, NULL);
+    return UUID_SUCCESS;
+}
+#endif
+
+static uuid_result uuid_sort_internal(unsigned char* pUUIDs, size_t count, void* pScratch, unsigned int threadCount)
+{
+    uuid_result result = UUID_SUCCESS;
+    unsigned char* pScratchAllocated = NULL;
+    size_t sortedCount;
+
+    if (pUUIDs == NULL && count > 0) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* Nothing to do if it's already sorted. */
+    sortedCount = uuid_sort_sorted_prefix(pUUIDs, count);
+    if (sortedCount == count) {
+        return UUID_SUCCESS;
+    }
+
+    if (pScratch == NULL) {
+        if (count > ((size_t)-1) / UUID_SIZE) {
+            return UUID_OUT_OF_MEMORY;
+        }
+
+        pScratchAllocated = (unsigned char*)uuid_malloc(count * UUID_SIZE, NULL);
+        if (pScratchAllocated == NULL) {
+            return UUID_OUT_OF_MEMORY;
+        }
+
+        pScratch = pScratchAllocated;
+    }
+
+    /* A short sorted run at the start isn't worth the cost of the merge. */
+    if (sortedCount < count / 8) {
+        sortedCount = 0;
+    }
+
+#if defined(UUID_SUPPORT_THREADS)
+    if (threadCount > UUID_SORT_MAX_THREADS) {
+        threadCount = UUID_SORT_MAX_THREADS;
+    }
+
+    if (threadCount > 1 && (count - sortedCount) >= UUID_SORT_MT_THRESHOLD) {
+        result = uuid_sort_mt_internal(pUUIDs + (sortedCount * UUID_SIZE), (unsigned char*)pScratch, count - sortedCount, threadCount);
+    } else
+#else
+    (void)threadCount;
+#endif
+    {
+        uuid_sort_msd(pUUIDs + (sortedCount * UUID_SIZE), (unsigned char*)pScratch, count - sortedCount, 0);
+    }
+
+    if (result == UUID_SUCCESS && sortedCount > 0) {
+        uuid_sort_merge_adjacent(pUUIDs, (unsigned char*)pScratch, count, sortedCount);
+    }
+
+    uuid_free(pScratchAllocated, NULL);
+
+    return result;
+}
+
+UUID_API uuid_result uuid_sort(unsigned char* pUUIDs, size_t count, void* pScratch)
+{
+    return uuid_sort_internal(pUUIDs, count, pScratch, 1);
+}
+
+UUID_API uuid_result uuid_sort_mt(unsigned char* pUUIDs, size_t count, void* pScratch, unsigned int threadCount)
+{
+    return uuid_sort_internal(pUUIDs, count, pScratch, threadCount);
+}
+
+
+/*
+K-way merge. The head of each run is kept in a binary heap with the first 8 bytes of the UUID cached
+in the heap entry so that most comparisons don't need to touch the runs.
+*/
+typedef struct
+{
+    uuid_uint64 key;                /* The first 8 bytes of the head, big-endian. */
+    const unsigned char* pHead;
+    const unsigned char* pEnd;
+} uuid_merge_entry;
+
+static int uuid_merge_entry_less(const uuid_merge_entry* pA, const uuid_merge_entry* pB)
+{
+    if (pA->key != pB->key) {
+        return pA->key < pB->key;
+    }
+
+    return uuid_load_be64(pA->pHead + 8) < uuid_load_be64(pB->pHead + 8);
+}
+
+static void uuid_merge_sift_down(uuid_merge_entry* pHeap, size_t heapSize, size_t index)
+{
+    uuid_merge_entry entry = pHeap[index];
+
+    for (;;) {
+        size_t child = (index * 2) + 1;
+        if (child >= heapSize) {
+            break;
+        }
+
+        if (child + 1 < heapSize && uuid_merge_entry_less(&pHeap[child + 1], &pHeap[child])) {
+            child += 1;
+        }
+
+        if (!uuid_merge_entry_less(&pHeap[child], &entry)) {
+            break;
+        }
+
+        pHeap[index] = pHeap[child];
+        index = child;
+    }
+
+    pHeap[index] = entry;
+}
+
+UUID_API uuid_result uuid_merge(unsigned char* pOut, const unsigned char* const* ppRuns, const size_t* pRunCounts, size_t runCount)
+{
+    uuid_merge_entry heapStack[32];
+    uuid_merge_entry* pHeap = heapStack;
+    size_t heapSize = 0;
+    size_t iRun;
+
+    if (pOut == NULL || ((ppRuns == NULL || pRunCounts == NULL) && runCount > 0)) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (runCount > sizeof(heapStack) / sizeof(heapStack[0])) {
+        if (runCount > ((size_t)-1) / sizeof(uuid_merge_entry)) {
+            return UUID_OUT_OF_MEMORY;
+        }
+
+        pHeap = (uuid_merge_entry*)uuid_malloc(sizeof(uuid_merge_entry) * runCount, NULL);
+        if (pHeap == NULL) {
+            return UUID_OUT_OF_MEMORY;
+        }
+    }
+
+    for (iRun = 0; iRun < runCount; iRun += 1) {
+        if (pRunCounts[iRun] == 0) {
+            continue;
+        }
+
+        if (ppRuns[iRun] == NULL) {
+            if (pHeap != heapStack) {
+                uuid_free(pHeap, NULL);
+            }
+
+            return UUID_INVALID_ARGS;
+        }
+
+        pHeap[heapSize].pHead = ppRuns[iRun];
+        pHeap[heapSize].pEnd  = ppRuns[iRun] + (pRunCounts[iRun] * UUID_SIZE);
+        pHeap[heapSize].key   = uuid_load_be64(ppRuns[iRun]);
+        heapSize += 1;
+    }
+
+    if (heapSize > 1) {
+        iRun = heapSize / 2;
+        while (iRun > 0) {
+            iRun -= 1;
+            uuid_merge_sift_down(pHeap, heapSize, iRun);
+        }
+    }
+
+    while (heapSize > 1) {
+        uuid_merge_entry* pTop = &pHeap[0];
+
+        UUID_COPY_MEMORY(pOut, pTop->pHead, UUID_SIZE);
+        pOut += UUID_SIZE;
+
+        pTop->pHead += UUID_SIZE;
+        if (pTop->pHead == pTop->pEnd) {
+            heapSize -= 1;
+            pHeap[0] = pHeap[heapSize];
+        } else {
+            pTop->key = uuid_load_be64(pTop->pHead);
+        }
+
+        uuid_merge_sift_down(pHeap, heapSize, 0);
+    }
+
+    /* The last run can be copied in one go. */
+    if (heapSize == 1) {
+        UUID_COPY_MEMORY(pOut, pHeap[0].pHead, (size_t)(pHeap[0].pEnd - pHeap[0].pHead));
+    }
+
+    if (pHeap != heapStack) {
+        uuid_free(pHeap, NULL);
+    }
+
+    return UUID_SUCCESS;
+}
+
+
+
+/*
+Column encoding.
+
+The layout is as follows. All integers are little-endian.
+
+    "UCL1"              4 bytes
+    Block size          4 bytes
+    UUID count          8 bytes
+    Block offsets       8 bytes per block, relative to the start of the data
+    Blocks
+
+Each block is as follows:
+
+    Flags               1 byte
+    Head size           varint
+    Heads               Head size bytes
+    Tails               8 bytes per UUID
+
+The head is the first 8 bytes of the UUID as a big-endian integer. For version 1 the time fields are
+stored least significant first so they are swapped around so that the head increases with time. The
+first head in a block is stored in full as 8 big-endian bytes, and then every other head is stored as
+a zigzag varint of the difference from the previous one. If that ends up bigger than storing them
+as-is, which will be the case for random UUIDs, the heads are stored in full instead. The tails are
+stored separately so that a scan of the heads doesn't need to touch them.
+*/
+#define UUID_COLUMN_HEADER_SIZE         16
+#define UUID_COLUMN_BLOCK_FLAG_V1       0x01    /* The heads have been reordered from version 1 layout. */
+#define UUID_COLUMN_BLOCK_FLAG_RAW      0x02    /* The heads are stored in full rather than as deltas. */
+
+static UUID_INLINE uuid_uint64 uuid_column_zigzag(uuid_uint64 x)
+{
+    return (x << 1) ^ ((uuid_uint64)0 - (x >> 63));
+}
+
+static UUID_INLINE uuid_uint64 uuid_column_unzigzag(uuid_uint64 x)
+{
+    return (x >> 1) ^ ((uuid_uint64)0 - (x & 1));
+}
+
+static UUID_INLINE size_t uuid_column_varint_size(uuid_uint64 x)
+{
+    size_t size = 1;
+
+    while (x >= 0x80) {
+        x >>= 7;
+        size += 1;
+    }
+
+    return size;
+}
+
+static UUID_INLINE unsigned char* uuid_column_write_varint(unsigned char* p, uuid_uint64 x)
+{
+    while (x >= 0x80) {
+        *p++ = (unsigned char)((x & 0x7F) | 0x80);
+        x >>= 7;
+    }
+
+    *p++ = (unsigned char)x;
+    return p;
+}
+
+/* Returns NULL if the varint runs past the end of the buffer or is longer than 64 bits. */
+static UUID_INLINE const unsigned char* uuid_column_read_varint(const unsigned char* p, const unsigned char* pEnd, uuid_uint64* pValue)
+{
+    uuid_uint64 value = 0;
+    unsigned int shift = 0;
+
+    while (p < pEnd) {
+        unsigned char b = *p++;
+
+        value |= (uuid_uint64)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            *pValue = value;
+            return p;
+        }
+
+        shift += 7;
+        if (shift > 63) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static UUID_INLINE uuid_uint64 uuid_column_get_head(const unsigned char* pUUID, unsigned int flags)
+{
+    uuid_uint64 head = uuid_load_be64(pUUID);
+
+    if ((flags & UUID_COLUMN_BLOCK_FLAG_V1) != 0) {
+        /* time_low, time_mid, time_hi -> time_hi, time_mid, time_low */
+        head = (head << 48) | ((head << 16) & UUID_UINT64_CONSTANT(0x0000FFFF, 0x00000000)) | (head >> 32);
+    }
+
+    return head;
+}
+
+static UUID_INLINE void uuid_column_set_head(unsigned char* pUUID, uuid_uint64 head, unsigned int flags)
+{
+    if ((flags & UUID_COLUMN_BLOCK_FLAG_V1) != 0) {
+        head = (head << 32) | ((head >> 16) & UUID_UINT64_CONSTANT(0x00000000, 0xFFFF0000)) | (head >> 48);
+    }
+
+    uuid_store_be64(pUUID, head);
+}
+
+static size_t uuid_column_block_count(size_t count, size_t blockSize)
+{
+    return (count + blockSize - 1) / blockSize;
+}
+
+static void uuid_column_analyze_block(const unsigned char* pUUIDs, size_t count, unsigned int* pFlags, size_t* pHeadSize)
+{
+    unsigned int flags = UUID_COLUMN_BLOCK_FLAG_V1;
+    size_t headSize;
+    uuid_uint64 prevHead;
+    size_t i;
+
+    UUID_ASSERT(count > 0);
+
+    for (i = 0; i < count; i += 1) {
+        const unsigned char* pUUID = pUUIDs + (i * UUID_SIZE);
+        if ((pUUID[6] & 0xF0) != 0x10 || (pUUID[8] & 0xC0) != 0x80) {
+            flags = 0;
+            break;
+        }
+    }
+
+    headSize = 8;
+    prevHead = uuid_column_get_head(pUUIDs, flags);
+    for (i = 1; i < count; i += 1) {
+        uuid_uint64 head = uuid_column_get_head(pUUIDs + (i * UUID_SIZE), flags);
+
+        headSize += uuid_column_varint_size(uuid_column_zigzag(head - prevHead));
+        prevHead  = head;
+    }
+
+    if (headSize > count * 8) {
+        flags   |= UUID_COLUMN_BLOCK_FLAG_RAW;
+        headSize = count * 8;
+    }
+
+    *pFlags    = flags;
+    *pHeadSize = headSize;
+}
+
+UUID_API size_t uuid_column_encode_bound(size_t count, size_t blockSize)
+{
+    if (blockSize == 0) {
+        blockSize = UUID_COLUMN_DEFAULT_BLOCK_SIZE;
+    }
+
+    /* Each block has an offset, a flags byte and a head size of at most 10 bytes. */
+    return UUID_COLUMN_HEADER_SIZE + (uuid_column_block_count(count, blockSize) * (8 + 1 + 10)) + (count * UUID_SIZE);
+}
+
+UUID_API uuid_result uuid_column_encode(void* pDst, size_t dstCap, const unsigned char* pUUIDs, size_t count, size_t blockSize, size_t* pDstSize)
+{
+    unsigned char* pOut = (unsigned char*)pDst;
+    size_t blockCount;
+    size_t blockIndex;
+    size_t size;
+
+    if (pDstSize != NULL) {
+        *pDstSize = 0;
+    }
+
+    if (pUUIDs == NULL && count > 0) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (blockSize == 0) {
+        blockSize = UUID_COLUMN_DEFAULT_BLOCK_SIZE;
+    }
+
+    if (blockSize > 0xFFFFFFFF) {
+        return UUID_INVALID_ARGS;
+    }
+
+    blockCount = uuid_column_block_count(count, blockSize);
+    size = UUID_COLUMN_HEADER_SIZE + (blockCount * 8);
+
+    if (pOut != NULL) {
+        if (dstCap < size) {
+            return UUID_INVALID_ARGS;
+        }
+
+        pOut[0] = 'U';
+        pOut[1] = 'C';
+        pOut[2] = 'L';
+        pOut[3] = '1';
+        uuid_store_le32(pOut + 4, (uuid_uint32)blockSize);
+        uuid_store_le64(pOut + 8, (uuid_uint64)count);
+    }
+
+    for (blockIndex = 0; blockIndex < blockCount; blockIndex += 1) {
+        const unsigned char* pBlockUUIDs = pUUIDs + (blockIndex * blockSize * UUID_SIZE);
+        size_t blockUUIDCount = count - (blockIndex * blockSize);
+        unsigned int flags;
+        size_t headSize;
+        size_t blockSizeInBytes;
+
+        if (blockUUIDCount > blockSize) {
+            blockUUIDCount = blockSize;
+        }
+
+        uuid_column_analyze_block(pBlockUUIDs, blockUUIDCount, &flags, &headSize);
+        blockSizeInBytes = 1 + uuid_column_varint_size(headSize) + headSize + (blockUUIDCount * 8);
+
+        if (pOut != NULL) {
+            unsigned char* pBlock = pOut + size;
+            unsigned char* pCursor;
+            size_t i;
+
+            if (dstCap - size < blockSizeInBytes) {
+                return UUID_INVALID_ARGS;
+            }
+
+            uuid_store_le64(pOut + UUID_COLUMN_HEADER_SIZE + (blockIndex * 8), (uuid_uint64)size);
+
+            pBlock[0] = (unsigned char)flags;
+            pCursor = uuid_column_write_varint(pBlock + 1, headSize);
+
+            if ((flags & UUID_COLUMN_BLOCK_FLAG_RAW) != 0) {
+                for (i = 0; i < blockUUIDCount; i += 1) {
+                    uuid_store_be64(pCursor, uuid_column_get_head(pBlockUUIDs + (i * UUID_SIZE), flags));
+                    pCursor += 8;
+                }
+            } else {
+                uuid_uint64 prevHead = uuid_column_get_head(pBlockUUIDs, flags);
+
+                uuid_store_be64(pCursor, prevHead);
+                pCursor += 8;
+
+                for (i = 1; i < blockUUIDCount; i += 1) {
+                    uuid_uint64 head = uuid_column_get_head(pBlockUUIDs + (i * UUID_SIZE), flags);
+
+                    pCursor  = uuid_column_write_varint(pCursor, uuid_column_zigzag(head - prevHead));
+                    prevHead = head;
+                }
+            }
+
+            for (i = 0; i < blockUUIDCount; i += 1) {
+                UUID_COPY_MEMORY(pCursor, pBlockUUIDs + (i * UUID_SIZE) + 8, 8);
+                pCursor += 8;
+            }
+
+            UUID_ASSERT(pCursor == pBlock + blockSizeInBytes);
+        }
+
+        size += blockSizeInBytes;
+    }
+
+    if (pDstSize != NULL) {
+        *pDstSize = size;
+    }
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_column_decoder_load_block(uuid_column_decoder* pDecoder, size_t blockIndex)
+{
+    const unsigned char* pIndex = pDecoder->pData + UUID_COLUMN_HEADER_SIZE;
+    const unsigned char* pBlockEnd;
+    const unsigned char* pCursor;
+    uuid_uint64 offset;
+    uuid_uint64 offsetEnd;
+    uuid_uint64 headSize;
+    size_t blockUUIDCount;
+
+    UUID_ASSERT(blockIndex < pDecoder->blockCount);
+
+    offset = uuid_load_le64(pIndex + (blockIndex * 8));
+    if (blockIndex + 1 < pDecoder->blockCount) {
+        offsetEnd = uuid_load_le64(pIndex + ((blockIndex + 1) * 8));
+    } else {
+        offsetEnd = pDecoder->dataSize;
+    }
+
+    if (offset < UUID_COLUMN_HEADER_SIZE + (pDecoder->blockCount * 8) || offset >= offsetEnd || offsetEnd > pDecoder->dataSize) {
+        return UUID_INVALID_DATA;
+    }
+
+    blockUUIDCount = pDecoder->count - (blockIndex * pDecoder->blockSize);
+    if (blockUUIDCount > pDecoder->blockSize) {
+        blockUUIDCount = pDecoder->blockSize;
+    }
+
+    pBlockEnd = pDecoder->pData + (size_t)offsetEnd;
+    pCursor   = pDecoder->pData + (size_t)offset;
+
+    pDecoder->blockFlags = *pCursor++;
+    if ((pDecoder->blockFlags & ~(UUID_COLUMN_BLOCK_FLAG_V1 | UUID_COLUMN_BLOCK_FLAG_RAW)) != 0) {
+        return UUID_INVALID_DATA;
+    }
+
+    pCursor = uuid_column_read_varint(pCursor, pBlockEnd, &headSize);
+    if (pCursor == NULL) {
+        return UUID_INVALID_DATA;
+    }
+
+    /* The tails take up the rest of the block. */
+    if ((uuid_uint64)(pBlockEnd - pCursor) < headSize || (size_t)(pBlockEnd - pCursor) - (size_t)headSize != blockUUIDCount * 8) {
+        return UUID_INVALID_DATA;
+    }
+
+    if ((pDecoder->blockFlags & UUID_COLUMN_BLOCK_FLAG_RAW) != 0) {
+        if (headSize != blockUUIDCount * 8) {
+            return UUID_INVALID_DATA;
+        }
+    } else {
+        if (headSize < 8) {
+            return UUID_INVALID_DATA;
+        }
+    }
+
+    pDecoder->blockIndex     = blockIndex;
+    pDecoder->blockUUIDCount = blockUUIDCount;
+    pDecoder->blockCursor    = 0;
+    pDecoder->pHeads         = pCursor;
+    pDecoder->pHeadsEnd      = pCursor + (size_t)headSize;
+    pDecoder->pTails         = pDecoder->pHeadsEnd;
+    pDecoder->prevHead       = 0;
+
+    return UUID_SUCCESS;
+}
+
+/*
+Decodes the next count heads in the current block. If pOut is NULL the heads are skipped. Otherwise
+they are written to pOut, stride bytes apart.
+*/
+static uuid_result uuid_column_decoder_read_block_heads(uuid_column_decoder* pDecoder, unsigned char* pOut, size_t stride, size_t count)
+{
+    const unsigned char* pHeads    = pDecoder->pHeads;
+    const unsigned char* pHeadsEnd = pDecoder->pHeadsEnd;
+    unsigned int flags = pDecoder->blockFlags;
+    uuid_uint64 head = pDecoder->prevHead;
+    size_t i = 0;
+
+    UUID_ASSERT(pDecoder->blockCursor + count <= pDecoder->blockUUIDCount);
+
+    if ((flags & UUID_COLUMN_BLOCK_FLAG_RAW) != 0) {
+        for (i = 0; i < count; i += 1) {
+            head = uuid_load_be64(pHeads);
+            pHeads += 8;
+
+            if (pOut != NULL) {
+                uuid_column_set_head(pOut + (i * stride), head, flags);
+            }
+        }
+    } else {
+        if (count > 0 && pDecoder->blockCursor == 0) {
+            head = uuid_load_be64(pHeads);
+            pHeads += 8;
+
+            if (pOut != NULL) {
+                uuid_column_set_head(pOut, head, flags);
+            }
+
+            i = 1;
+        }
+
+        for (; i < count; i += 1) {
+            uuid_uint64 delta;
+
+            /* Most deltas fit in a single byte. */
+            if (pHeads < pHeadsEnd && pHeads[0] < 0x80) {
+                delta = pHeads[0];
+                pHeads += 1;
+            } else {
+                pHeads = uuid_column_read_varint(pHeads, pHeadsEnd, &delta);
+                if (pHeads == NULL) {
+                    return UUID_INVALID_DATA;
+                }
+            }
+
+            head += uuid_column_unzigzag(delta);
+
+            if (pOut != NULL) {
+                uuid_column_set_head(pOut + (i * stride), head, flags);
+            }
+        }
+    }
+
+    pDecoder->pHeads       = pHeads;
+    pDecoder->prevHead     = head;
+    pDecoder->blockCursor += count;
+
+    /* All of the heads should have been used up by the end of the block. */
+    if (pDecoder->blockCursor == pDecoder->blockUUIDCount && pHeads != pHeadsEnd) {
+        return UUID_INVALID_DATA;
+    }
+
+    return UUID_SUCCESS;
+}
+
+static uuid_result uuid_column_decoder_read_internal(uuid_column_decoder* pDecoder, unsigned char* pOut, size_t cap, size_t stride, size_t* pCount)
+{
+    uuid_result result;
+    size_t totalCount = 0;
+
+    while (totalCount < cap && pDecoder->cursor < pDecoder->count) {
+        size_t count;
+
+        if (pDecoder->blockCursor == pDecoder->blockUUIDCount) {
+            result = uuid_column_decoder_load_block(pDecoder, pDecoder->cursor / pDecoder->blockSize);
+            if (result != UUID_SUCCESS) {
+                break;
+            }
+        }
+
+        count = pDecoder->blockUUIDCount - pDecoder->blockCursor;
+        if (count > cap - totalCount) {
+            count = cap - totalCount;
+        }
+
+        /* The tails are not needed when only reading the heads. */
+        if (stride == UUID_SIZE) {
+            const unsigned char* pTails = pDecoder->pTails + (pDecoder->blockCursor * 8);
+            size_t i;
+
+            for (i = 0; i < count; i += 1) {
+                UUID_COPY_MEMORY(pOut + (i * UUID_SIZE) + 8, pTails + (i * 8), 8);
+            }
+        }
+
+        result = uuid_column_decoder_read_block_heads(pDecoder, pOut, stride, count);
+        if (result != UUID_SUCCESS) {
+            break;
+        }
+
+        pOut             += count * stride;
+        pDecoder->cursor += count;
+        totalCount       += count;
+    }
+
+    if (pCount != NULL) {
+        *pCount = totalCount;
+    }
+
+    if (totalCount < cap && pDecoder->cursor < pDecoder->count) {
+        return UUID_INVALID_DATA;
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_result uuid_column_decoder_init(const void* pSrc, size_t srcSize, uuid_column_decoder* pDecoder)
+{
+    const unsigned char* pData = (const unsigned char*)pSrc;
+    uuid_uint64 count;
+    size_t blockSize;
+    size_t blockCount;
+
+    if (pDecoder == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pDecoder);
+
+    if (pData == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    if (srcSize < UUID_COLUMN_HEADER_SIZE || pData[0] != 'U' || pData[1] != 'C' || pData[2] != 'L' || pData[3] != '1') {
+        return UUID_INVALID_DATA;
+    }
+
+    blockSize = (size_t)uuid_load_le32(pData + 4);
+    count     = uuid_load_le64(pData + 8);
+
+    /* Every UUID takes up at least 8 bytes so this also guards against overflow. */
+    if (blockSize == 0 || count > srcSize / 8) {
+        return UUID_INVALID_DATA;
     }
 
-    GetSystemTimeAsFileTime(&ft);
-    current100Nanoseconds = (((LONGLONG)ft.dwHighDateTime << 32) | (LONGLONG)ft.dwLowDateTime);
-    current100Nanoseconds = current100Nanoseconds - ((LONGLONG)116444736 * 1000000000); /* Windows to Unix epoch. Normal value is 116444736000000000LL, but VC6 doesn't like 64-bit constants. */
+    blockCount = uuid_column_block_count((size_t)count, blockSize);
+    if ((srcSize - UUID_COLUMN_HEADER_SIZE) / 8 < blockCount) {
+        return UUID_INVALID_DATA;
+    }
 
-    ts->tv_sec  = (time_t)(current100Nanoseconds / 10000000);
-    ts->tv_nsec =  (long)((current100Nanoseconds - (ts->tv_sec * 10000000)) * 100);
+    pDecoder->pData      = pData;
+    pDecoder->dataSize   = srcSize;
+    pDecoder->count      = (size_t)count;
+    pDecoder->blockSize  = blockSize;
+    pDecoder->blockCount = blockCount;
 
-    return base;
+    return UUID_SUCCESS;
 }
-#else
-#include <sys/time.h>   /* For timeval. */
 
-static struct uuid_timespec uuid_timespec_from_timeval(struct timeval* tv)
+UUID_API size_t uuid_column_decoder_count(const uuid_column_decoder* pDecoder)
 {
-    struct uuid_timespec ts;
+    if (pDecoder == NULL) {
+        return 0;
+    }
 
-    ts.tv_sec  = tv->tv_sec;
-    ts.tv_nsec = tv->tv_usec * 1000;
+    return pDecoder->count;
+}
 
-    return ts;
+UUID_API uuid_result uuid_column_decoder_seek(uuid_column_decoder* pDecoder, size_t index)
+{
+    uuid_result result;
+
+    if (pDecoder == NULL || index > pDecoder->count) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* The next read will load the block. */
+    pDecoder->cursor         = index;
+    pDecoder->blockUUIDCount = 0;
+    pDecoder->blockCursor    = 0;
+
+    if (index == pDecoder->count || (index % pDecoder->blockSize) == 0) {
+        return UUID_SUCCESS;
+    }
+
+    result = uuid_column_decoder_load_block(pDecoder, index / pDecoder->blockSize);
+    if (result != UUID_SUCCESS) {
+        return result;
+    }
+
+    /* Deltas need to be accumulated from the start of the block. */
+    return uuid_column_decoder_read_block_heads(pDecoder, NULL, 0, index % pDecoder->blockSize);
 }
 
-static int uuid_timespec_get(struct uuid_timespec* ts, int base)
+UUID_API uuid_result uuid_column_decoder_read(uuid_column_decoder* pDecoder, unsigned char* pUUIDs, size_t uuidCap, size_t* pUUIDCount)
 {
-    UUID_ZERO_OBJECT(ts);
+    if (pUUIDCount != NULL) {
+        *pUUIDCount = 0;
+    }
 
-    /*
-    This is annoying to get working on all compilers. Here's the hierarchy:
+    if (pDecoder == NULL || pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
 
-        * If using C11, use timespec_get(); else
-        * If _POSIX_C_SOURCE >= 199309L, use clock_gettime(CLOCK_REALTIME, ...); else
-        * Fall back to gettimeofday().
-    */
-    #if defined (__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__APPLE__)
-    {
-        int result;
-        struct timespec _ts;
+    return uuid_column_decoder_read_internal(pDecoder, pUUIDs, uuidCap, UUID_SIZE, pUUIDCount);
+}
 
-        result = timespec_get(&_ts, base);
-        if (result == 0) {
-            return result;  /* Failed to get the time. */
-        }
+UUID_API uuid_result uuid_column_decoder_read_heads(uuid_column_decoder* pDecoder, unsigned char* pHeads, size_t headCap, size_t* pHeadCount)
+{
+    if (pHeadCount != NULL) {
+        *pHeadCount = 0;
+    }
 
-        ts->tv_sec  = _ts.tv_sec;
-        ts->tv_nsec = _ts.tv_nsec;
+    if (pDecoder == NULL || pHeads == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    return uuid_column_decoder_read_internal(pDecoder, pHeads, headCap, 8, pHeadCount);
+}
 
+UUID_API uuid_result uuid_column_decode(unsigned char* pUUIDs, size_t uuidCap, const void* pSrc, size_t srcSize, size_t* pUUIDCount)
+{
+    uuid_result result;
+    uuid_column_decoder decoder;
+
+    if (pUUIDCount != NULL) {
+        *pUUIDCount = 0;
+    }
+
+    if (pUUIDs == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_column_decoder_init(pSrc, srcSize, &decoder);
+    if (result != UUID_SUCCESS) {
         return result;
     }
-    #else
-    {
-        if (base != TIME_UTC) {
-            return 0;   /* Only TIME_UTC is supported. 0 = error. */
-        }
 
-        #if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
-        {
-            struct timespec _ts;
+    return uuid_column_decoder_read(&decoder, pUUIDs, uuidCap, pUUIDCount);
+}
 
-            if (clock_gettime(CLOCK_REALTIME, &_ts) != 0) {
-                return 0;   /* Failed to retrieve the time. 0 = error. */
-            }
 
-            ts->tv_sec  = _ts.tv_sec;
-            ts->tv_nsec = _ts.tv_nsec;
+/*
+Sharded generator. This is the same as uuid_generator_next() except that it's never shared between
+threads so there's no need for atomics. Each shard is padded out to a whole number of cache lines so
+that two threads never write to the same cache line.
 
-            /* Getting here means we were successful. On success, need to return base (strange...) */
-            return base;
-        }
-        #else
-        {
-            struct timeval tv;
-            if (gettimeofday(&tv, NULL) != 0) {
-                return 0;   /* Failed to retrieve the time. 0 = error. */
-            }
+The shard index goes in the upper bits of whatever follows the variant. For versions 1 and 6 and
+ordered UUIDs this is the clock sequence, and for version 7 it's the random data.
+*/
+#define UUID_CACHE_LINE_SIZE    64
 
-            *ts = uuid_timespec_from_timeval(&tv);
-            return base;
-        }
-        #endif  /* _POSIX_C_SOURCE >= 199309L */
+static uuid_result uuid_shard_init(const uuid_sharded_generator_config* pConfig, uuid_uint32 shardIndex, uuid_uint32 shardBits, uuid_shard* pShard)
+{
+    uuid_result result;
+    uuid_chacha_rng_config rngConfig;
+    unsigned char random[8];
+
+    UUID_ASSERT(pConfig != NULL);
+    UUID_ASSERT(pShard  != NULL);
+    UUID_ASSERT(shardBits <= 12);
+
+    UUID_ZERO_OBJECT(pShard);
+
+    rngConfig = uuid_chacha_rng_config_init(pConfig->pSeedRNG);
+
+    result = uuid_chacha_rng_init(&rngConfig, &pShard->rng);
+    if (result != UUID_SUCCESS) {
+        return result;
     }
-    #endif  /* C11 */
+
+    result = uuid_chacha_rng_generate((uuid_rand*)&pShard->rng, random, sizeof(random));
+    if (result != UUID_SUCCESS) {
+        uuid_chacha_rng_uninit(&pShard->rng);
+        return result;
+    }
+
+    pShard->pClock        = pConfig->pClock;
+    pShard->shardIndex    = shardIndex;
+    pShard->shardBits     = shardBits;
+    pShard->clockSequence = (shardIndex << (14 - shardBits)) | ((((uuid_uint32)random[0] << 8) | (uuid_uint32)random[1]) & (0x3FFF >> shardBits));
+    UUID_COPY_MEMORY(pShard->node, random + 2, 6);
+
+    /* RFC 4122 section 4.5. The multicast bit must be set for randomly generated node IDs. */
+    pShard->node[0] |= 0x01;
+
+    return UUID_SUCCESS;
 }
-#endif
 
-static uuid_result uuid_get_time(uuid_uint64* pTime)
+static uuid_result uuid_shard_next(uuid_shard* pShard, uuid_version version, uuid_uint64* pTime)
 {
-    struct uuid_timespec ts;
+    uuid_result result;
+    uuid_uint64 now;
+    uuid_uint64* pLastTime;
 
-    if (pTime == NULL) {
-        return UUID_INVALID_ARGS;
+    result = uuid_get_time_from_clock(pShard->pClock, &now);
+    if (result != UUID_SUCCESS) {
+        return result;
     }
 
-    *pTime = 0;
+    /* Only the bits below the shard index are incremented when the clock goes backwards. */
+    if (now < pShard->lastClockReading) {
+        uuid_uint32 lowMask = 0x3FFF >> pShard->shardBits;
+        pShard->clockSequence = (pShard->clockSequence & ~lowMask) | ((pShard->clockSequence + 1) & lowMask);
+    }
 
-    if (uuid_timespec_get(&ts, TIME_UTC) == 0) {
-        return UUID_ERROR;  /* Failed to retrieve time. */
+    pShard->lastClockReading = now;
+
+    if (version == UUID_VERSION_7) {
+        now       = uuid7_time_from_uuid_time(now);
+        pLastTime = &pShard->lastTime7;
+    } else {
+        pLastTime = &pShard->lastTime;
     }
 
-    *pTime  = (ts.tv_sec * 10000000) + (ts.tv_nsec / 100);      /* In 100-nanoseconds resolution. */
-    *pTime += (((uuid_uint64)0x01B21DD2 << 32) | 0x13814000);   /* Conversion from Unix Epoch to UUID Epoch. Weird format here is for compatibility with VC6 because it doesn't like 64-bit constants. */
+    if (now <= *pLastTime) {
+        now = *pLastTime + 1;
+        UUID_STATS_ADD(sameTickCount, 1);
+    }
+
+    *pLastTime = now;
+    *pTime     = now;
 
     return UUID_SUCCESS;
 }
 
-static uuid_result uuid1_internal(unsigned char* pUUID, uuid_rand* pRNG)
+static uuid_result uuid_shard_generate(uuid_shard* pShard, unsigned char* pUUID, uuid_version version)
 {
     uuid_result result;
     uuid_uint64 time;
-    uuid_uint32 timeLow;
-    uuid_uint16 timeMid;
-    uuid_uint16 timeHiAndVersion;
 
-    UUID_ASSERT(pUUID != NULL);
-    UUID_ASSERT(pRNG  != NULL);
+    if (pUUID == NULL) {
+        return UUID_INVALID_ARGS;
+    }
 
-    result = uuid_get_time(&time);
+    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
+
+    if (pShard == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    result = uuid_shard_next(pShard, version, &time);
     if (result != UUID_SUCCESS) {
         return result;
     }
 
-    timeLow          = (uuid_uint32) ((time >>  0) & 0xFFFFFFFF);
-    timeMid          = (uuid_uint16) ((time >> 32) & 0x0000FFFF);
-    timeHiAndVersion = (uuid_uint16)(((time >> 48) & 0x00000FFF) | 0x1000);
+    if (version == UUID_VERSION_7) {
+        unsigned char random[8];
+        uuid_uint64 tail;
 
-    /* Time Low */
-    pUUID[0] = (unsigned char)((timeLow >> 24) & 0xFF);
-    pUUID[1] = (unsigned char)((timeLow >> 16) & 0xFF);
-    pUUID[2] = (unsigned char)((timeLow >>  8) & 0xFF);
-    pUUID[3] = (unsigned char)((timeLow >>  0) & 0xFF);
+        result = uuid_chacha_rng_generate((uuid_rand*)&pShard->rng, random, sizeof(random));
+        if (result != UUID_SUCCESS) {
+            return result;
+        }
 
-    /* Time Mid */
-    pUUID[4] = (unsigned char)((timeMid >> 8) & 0xFF);
-    pUUID[5] = (unsigned char)((timeMid >> 0) & 0xFF);
+        /* Variant 1, then the shard index, then random data. */
+        tail = uuid_load_be64(random) >> (2 + pShard->shardBits);
+        tail = tail | ((uuid_uint64)pShard->shardIndex << (62 - pShard->shardBits)) | ((uuid_uint64)0x80 << 56);
+
+        uuid7_set_time_and_fraction(pUUID, time);
+        uuid_store_be64(pUUID + 8, tail);
+    } else {
+        switch (version)
+        {
+            case UUID_VERSION_1:       uuid1_set_time(pUUID, time);        break;
+            case UUID_VERSION_6:       uuid6_set_time(pUUID, time);        break;
+            case UUID_VERSION_ORDERED: uuid_ordered_set_time(pUUID, time); break;
+            default:                   return UUID_INVALID_ARGS;
+        };
+
+        /* Variant 1 goes in the top two bits of the clock sequence. */
+        pUUID[8] = (unsigned char)(0x80 | ((pShard->clockSequence >> 8) & 0x3F));
+        pUUID[9] = (unsigned char)((pShard->clockSequence >> 0) & 0xFF);
+        UUID_COPY_MEMORY(pUUID + 10, pShard->node, 6);
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API uuid_sharded_generator_config uuid_sharded_generator_config_init(uuid_uint32 shardCount)
+{
+    uuid_sharded_generator_config config;
+
+    UUID_ZERO_OBJECT(&config);
+    config.shardCount = shardCount;
+
+    return config;
+}
+
+UUID_API uuid_result uuid_sharded_generator_init(const uuid_sharded_generator_config* pConfig, uuid_sharded_generator* pGenerator)
+{
+    uuid_result result;
+    uuid_uint32 shardBits;
+    uuid_uint32 iShard;
+    size_t alignmentOffset;
+
+    if (pGenerator == NULL) {
+        return UUID_INVALID_ARGS;
+    }
+
+    UUID_ZERO_OBJECT(pGenerator);
+
+    if (pConfig == NULL || pConfig->shardCount == 0 || pConfig->shardCount > UUID_SHARD_MAX_COUNT) {
+        return UUID_INVALID_ARGS;
+    }
+
+    /* The number of bits needed to store the shard index. */
+    shardBits = 0;
+    while (((uuid_uint32)1 << shardBits) < pConfig->shardCount) {
+        shardBits += 1;
+    }
+
+    pGenerator->config      = *pConfig;
+    pGenerator->shardStride = (sizeof(uuid_shard) + UUID_CACHE_LINE_SIZE - 1) & ~(size_t)(UUID_CACHE_LINE_SIZE - 1);
+
+    pGenerator->pAllocation = uuid_malloc((pGenerator->shardStride * pConfig->shardCount) + UUID_CACHE_LINE_SIZE - 1, &pConfig->allocationCallbacks);
+    if (pGenerator->pAllocation == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
+
+    alignmentOffset = (UUID_CACHE_LINE_SIZE - ((size_t)pGenerator->pAllocation & (UUID_CACHE_LINE_SIZE - 1))) & (UUID_CACHE_LINE_SIZE - 1);
+    pGenerator->pShards = (unsigned char*)pGenerator->pAllocation + alignmentOffset;
+
+    for (iShard = 0; iShard < pConfig->shardCount; iShard += 1) {
+        result = uuid_shard_init(pConfig, iShard, shardBits, uuid_sharded_generator_get_shard(pGenerator, iShard));
+        if (result != UUID_SUCCESS) {
+            pGenerator->config.shardCount = iShard;     /* Only uninitialize the shards that were initialized. */
+            uuid_sharded_generator_uninit(pGenerator);
+            return result;
+        }
+    }
+
+    return UUID_SUCCESS;
+}
+
+UUID_API void uuid_sharded_generator_uninit(uuid_sharded_generator* pGenerator)
+{
+    uuid_uint32 iShard;
+
+    if (pGenerator == NULL) {
+        return;
+    }
+
+    /* Wipe the random number generators. */
+    for (iShard = 0; iShard < pGenerator->config.shardCount; iShard += 1) {
+        uuid_chacha_rng_uninit(&uuid_sharded_generator_get_shard(pGenerator, iShard)->rng);
+    }
+
+    uuid_free(pGenerator->pAllocation, &pGenerator->config.allocationCallbacks);
+    UUID_ZERO_OBJECT(pGenerator);
+}
+
+UUID_API uuid_shard* uuid_sharded_generator_get_shard(uuid_sharded_generator* pGenerator, uuid_uint32 shardIndex)
+{
+    if (pGenerator == NULL || pGenerator->pShards == NULL || shardIndex >= pGenerator->config.shardCount) {
+        return NULL;
+    }
+
+    return (uuid_shard*)(pGenerator->pShards + (shardIndex * pGenerator->shardStride));
+}
+
+UUID_API uuid_result uuid_shard_uuid1(uuid_shard* pShard, unsigned char* pUUID)
+{
+    return uuid_shard_generate(pShard, pUUID, UUID_VERSION_1);
+}
+
+UUID_API uuid_result uuid_shard_uuid6(uuid_shard* pShard, unsigned char* pUUID)
+{
+    return uuid_shard_generate(pShard, pUUID, UUID_VERSION_6);
+}
+
+UUID_API uuid_result uuid_shard_uuid7(uuid_shard* pShard, unsigned char* pUUID)
+{
+    return uuid_shard_generate(pShard, pUUID, UUID_VERSION_7);
+}
+
+UUID_API uuid_result uuid_shard_ordered(uuid_shard* pShard, unsigned char* pUUID)
+{
+    return uuid_shard_generate(pShard, pUUID, UUID_VERSION_ORDERED);
+}
+
+
+/*
+UUID pool. The ring buffer is a bounded multi-producer, multi-consumer queue. Each cell has a
+sequence number that says whether it's waiting to be written (equal to the enqueue position) or
+waiting to be read (one more than the dequeue position). A position is claimed with a
+compare-and-swap, and the sequence number is updated once the UUID has been copied. The positions
+are 64-bit and never wrap.
+
+Producers sleep on an event while the ring is above the low watermark. The consumer that takes it
+below the low watermark wakes them up. The event can miss a wakeup so producers also wake up on a
+timer, which is also used to keep the pool's idea of the current time up to date.
+*/
+#define UUID_POOL_BATCH_SIZE            64
+#define UUID_POOL_IDLE_TIMEOUT          100     /* Milliseconds. */
+#define UUID_POOL_MAX_STALE_DISCARDS    16      /* The most stale UUIDs uuid_pool_pop() will throw away before generating one itself. */
+
+typedef enum
+{
+    UUID_POOL_EMPTY,
+    UUID_POOL_STALE,
+    UUID_POOL_FRESH
+} uuid_pool_dequeue_result;
+
+UUID_API uuid_pool_config uuid_pool_config_init(void)
+{
+    uuid_pool_config config;
+
+    UUID_ZERO_OBJECT(&config);
+    config.capacity      = 4096;
+    config.producerCount = 1;
+
+    return config;
+}
+
+static uuid_uint64 uuid_pool_get_count(uuid_pool* pPool)
+{
+    /* Dequeue position is read second so it can be ahead of what we read for the enqueue position. */
+    uuid_uint64 enqueuePos = uuid_atomic_load_64(&pPool->enqueuePos);
+    uuid_uint64 dequeuePos = uuid_atomic_load_64(&pPool->dequeuePos);
+
+    if (dequeuePos > enqueuePos) {
+        return 0;
+    }
+
+    return enqueuePos - dequeuePos;
+}
+
+/* The minimum generation time of a UUID that can be returned. UUIDs older than this are stale. */
+static uuid_uint64 uuid_pool_get_min_time(uuid_pool* pPool, uuid_uint64 now)
+{
+    uuid_uint32 maxAge = pPool->config.maxAgeInMilliseconds;
+
+    /*
+    The current time is only updated by the producers every quarter of the maximum age so we need
+    to take that off to make sure nothing older than the maximum age gets through.
+    */
+    maxAge -= (maxAge / 4 > 0) ? maxAge / 4 : 1;
+
+    if (now < maxAge) {
+        return 0;
+    }
+
+    return now - maxAge;
+}
+
+/*
+When staleOnly is true the UUID at the head is only removed if it's stale, which is what producers
+use to drain old UUIDs. pUUID can be NULL in which case the UUID is thrown away.
+*/
+static uuid_pool_dequeue_result uuid_pool_dequeue(uuid_pool* pPool, unsigned char* pUUID, uuid_uint64 minTime, int staleOnly)
+{
+    uuid_pool_cell* pCell;
+    uuid_uint64 pos;
+    uuid_uint64 seq;
+    uuid_uint64 time;
+
+    pos = uuid_atomic_load_64(&pPool->dequeuePos);
+    for (;;) {
+        pCell = &pPool->pCells[pos & pPool->mask];
+        seq   = uuid_atomic_load_64(&pCell->sequence);
+
+        if (seq == pos + 1) {
+            /*
+            The time needs to be read before claiming the cell for the staleOnly case. If the claim
+            succeeds nobody else can have touched the cell in between so what we read is valid. It's
+            read atomically because a producer may be writing to it if the claim is going to fail.
+            */
+            time = uuid_atomic_load_64(&pCell->time);
+            if (staleOnly && time >= minTime) {
+                return UUID_POOL_FRESH;
+            }
 
-    /* Time High and Version */
-    pUUID[6] = (unsigned char)((timeHiAndVersion >> 8) & 0xFF);
-    pUUID[7] = (unsigned char)((timeHiAndVersion >> 0) & 0xFF);
+            if (uuid_atomic_compare_exchange_64(&pPool->dequeuePos, pos, pos + 1)) {
+                break;
+            }
 
-    /* For the clock sequence and node ID we're always using a random number. */
-    result = uuid_rand_generate(pRNG, pUUID + 8, UUID_SIZE - 8);
-    if (result != UUID_SUCCESS) {
-        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
-        return result;
+            pos = uuid_atomic_load_64(&pPool->dequeuePos);
+        } else if (seq < pos + 1) {
+            return UUID_POOL_EMPTY;
+        } else {
+            pos = uuid_atomic_load_64(&pPool->dequeuePos);  /* Another consumer got this cell first. */
+        }
     }
 
-    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
-    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+    if (pUUID != NULL) {
+        UUID_COPY_MEMORY(pUUID, pCell->uuid, 16);
+    }
 
-    return UUID_SUCCESS;
+    uuid_atomic_store_64(&pCell->sequence, pos + pPool->mask + 1);
+
+    if (time < minTime) {
+        return UUID_POOL_STALE;
+    }
+
+    return UUID_POOL_FRESH;
 }
 
-static uuid_result uuid3_internal(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+#if defined(UUID_SUPPORT_THREADS)
+/*
+The random number generator from the config may not be thread-safe, so every call to it goes through
+this lock. Each producer has its own ChaCha20 generator which only comes back here to reseed, so the
+lock is only contended when uuid_pool_pop() has to generate on the calling thread.
+*/
+static uuid_result uuid_pool_locked_rng_generate(uuid_rand* pRNG, void* pBufferOut, size_t byteCount)
 {
-#if defined(UUID_MD5_CTX_TYPE)
-    unsigned char hash[16];
-    UUID_MD5_CTX_TYPE ctx;
+    uuid_pool_locked_rng* pLockedRNG = (uuid_pool_locked_rng*)pRNG;
+    uuid_result result;
 
-    UUID_MD5_INIT(&ctx);
-    {
-        UUID_MD5_UPDATE(&ctx, pNamespaceUUID, UUID_SIZE);
-        UUID_MD5_UPDATE(&ctx, (const unsigned char*)pName, strlen(pName));
+    while (uuid_atomic_load_64(&pLockedRNG->lock) != 0 || !uuid_atomic_compare_exchange_64(&pLockedRNG->lock, 0, 1)) {
     }
-    UUID_MD5_FINAL(&ctx, hash);
 
-    UUID_COPY_MEMORY(pUUID, hash, UUID_SIZE);
+    result = uuid_rand_generate(pLockedRNG->pRNG, pBufferOut, byteCount);
+    uuid_atomic_store_64(&pLockedRNG->lock, 0);
 
-    /* Byte 6 needs to be updated so the version number is set appropriately. */
-    pUUID[6] = (unsigned char)(0x30 | (pUUID[6] & 0x0F));
+    return result;
+}
+#endif
 
-    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
-    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+/* NULL for the default generator, which is thread-local. */
+static uuid_rand* uuid_pool_get_rng(uuid_pool* pPool)
+{
+    if (pPool->config.pRNG == NULL) {
+        return NULL;
+    }
 
-    return UUID_SUCCESS;
-#else
-    (void)pUUID;
-    (void)pNamespaceUUID;
-    (void)pName;
-    return UUID_NOT_IMPLEMENTED;
-#endif
+    return (uuid_rand*)&pPool->lockedRNG;
 }
 
-static uuid_result uuid4_internal(unsigned char* pUUID, uuid_rand* pRNG)
+static uuid_result uuid_pool_generate(uuid_pool* pPool, uuid_rand* pRNG, unsigned char* pUUIDs, size_t count)
 {
-    uuid_result result;
+    if (pPool->config.onGenerate == NULL) {
+        return uuid4_batch(pUUIDs, count, pRNG);
+    }
 
-    UUID_ASSERT(pUUID != NULL);
-    UUID_ASSERT(pRNG  != NULL);
+    return pPool->config.onGenerate(pUUIDs, count, pRNG);
+}
 
-    /* First just generate some random numbers. */
-    result = uuid_rand_generate(pRNG, pUUID, UUID_SIZE);
-    if (result != UUID_SUCCESS) {
-        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
-        return result;
+#if defined(UUID_SUPPORT_THREADS)
+static uuid_uint64 uuid_pool_get_time(void)
+{
+    uuid_uint64 time;
+
+    if (uuid_clock_default_get_time(&time) != UUID_SUCCESS) {
+        return 0;
     }
 
-    /* Byte 6 needs to be updated so the version number is set appropriately. */
-    pUUID[6] = (unsigned char)(0x40 | (pUUID[6] & 0x0F));
+    return time / 1000000;
+}
 
-    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
-    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+static uuid_uint32 uuid_pool_get_timeout(uuid_pool* pPool)
+{
+    if (pPool->config.maxAgeInMilliseconds == 0) {
+        return UUID_POOL_IDLE_TIMEOUT;
+    }
 
-    return UUID_SUCCESS;
+    return (pPool->config.maxAgeInMilliseconds / 4 > 0) ? pPool->config.maxAgeInMilliseconds / 4 : 1;
 }
 
-static uuid_result uuid5_internal(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
+static int uuid_pool_enqueue(uuid_pool* pPool, const unsigned char* pUUID, uuid_uint64 time)
 {
-#if defined(UUID_SHA1_CTX_TYPE)
-    unsigned char hash[20];
-    UUID_SHA1_CTX_TYPE ctx;
+    uuid_pool_cell* pCell;
+    uuid_uint64 pos;
+    uuid_uint64 seq;
 
-    UUID_SHA1_INIT(&ctx);
-    {
-        UUID_SHA1_UPDATE(&ctx, pNamespaceUUID, UUID_SIZE);
-        UUID_SHA1_UPDATE(&ctx, (const unsigned char*)pName, strlen(pName));
-    }
-    UUID_SHA1_FINAL(&ctx, hash);
+    pos = uuid_atomic_load_64(&pPool->enqueuePos);
+    for (;;) {
+        pCell = &pPool->pCells[pos & pPool->mask];
+        seq   = uuid_atomic_load_64(&pCell->sequence);
 
-    UUID_COPY_MEMORY(pUUID, hash, UUID_SIZE);
+        if (seq == pos) {
+            if (uuid_atomic_compare_exchange_64(&pPool->enqueuePos, pos, pos + 1)) {
+                break;
+            }
 
-    /* Byte 6 needs to be updated so the version number is set appropriately. */
-    pUUID[6] = (unsigned char)(0x50 | (pUUID[6] & 0x0F));
+            pos = uuid_atomic_load_64(&pPool->enqueuePos);
+        } else if (seq < pos) {
+            return 0;   /* Full. */
+        } else {
+            pos = uuid_atomic_load_64(&pPool->enqueuePos);  /* Another producer got this cell first. */
+        }
+    }
 
-    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
-    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+    uuid_atomic_store_64(&pCell->time, time);
+    UUID_COPY_MEMORY(pCell->uuid, pUUID, 16);
+    uuid_atomic_store_64(&pCell->sequence, pos + 1);
 
-    return UUID_SUCCESS;
-#else
-    (void)pUUID;
-    (void)pNamespaceUUID;
-    (void)pName;
-    return UUID_NOT_IMPLEMENTED;
-#endif
+    return 1;
 }
 
-static uuid_result uuid_ordered_internal(unsigned char* pUUID, uuid_rand* pRNG)
+typedef struct
 {
-    uuid_result result;
-    uuid_uint64 time;
-    uuid_uint32 timeLow;
-    uuid_uint16 timeMid;
-    uuid_uint16 timeHi;
+    uuid_pool* pPool;
+    uuid_thread thread;
+    uuid_event event;
+    uuid_chacha_rng rng;    /* Seeded from the pool's generator. Only used when config.pRNG is not NULL. */
+} uuid_pool_producer;
+
+/* NULL for the default generator, which is thread-local. */
+static uuid_rand* uuid_pool_producer_get_rng(uuid_pool_producer* pProducer)
+{
+    if (pProducer->pPool->config.pRNG == NULL) {
+        return NULL;
+    }
 
-    UUID_ASSERT(pUUID != NULL);
-    UUID_ASSERT(pRNG  != NULL);
+    return (uuid_rand*)&pProducer->rng;
+}
 
-    result = uuid_get_time(&time);
-    if (result != UUID_SUCCESS) {
-        return result;
+static void uuid_pool_wake_producers(uuid_pool* pPool)
+{
+    uuid_pool_producer* pProducers = (uuid_pool_producer*)pPool->pProducers;
+    uuid_uint32 iProducer;
+
+    for (iProducer = 0; iProducer < pPool->config.producerCount; iProducer += 1) {
+        uuid_event_signal(&pProducers[iProducer].event);
     }
+}
 
-    timeLow = (uuid_uint32)((time >>  0) & 0xFFFFFFFF);
-    timeMid = (uuid_uint16)((time >> 32) & 0x0000FFFF);
-    timeHi  = (uuid_uint16)((time >> 48) & 0x00000FFF);
+/* Returns false if nothing could be generated, in which case the producer should wait before trying again. */
+static int uuid_pool_refill(uuid_pool* pPool, uuid_rand* pRNG)
+{
+    unsigned char uuids[UUID_POOL_BATCH_SIZE * 16];
+    uuid_uint64 capacity = pPool->mask + 1;
+    uuid_uint64 count;
+    uuid_uint64 time;
+    size_t batchSize;
+    size_t iUUID;
 
-    /* Time High and Version */
-    pUUID[0] = (unsigned char)((timeHi  >>  8) & 0xFF);
-    pUUID[1] = (unsigned char)((timeHi  >>  0) & 0xFF);
+    while (uuid_atomic_load_64(&pPool->isShuttingDown) == 0) {
+        count = uuid_pool_get_count(pPool);
+        if (count >= capacity) {
+            break;
+        }
 
-    /* Time Mid */
-    pUUID[2] = (unsigned char)((timeMid >>  8) & 0xFF);
-    pUUID[3] = (unsigned char)((timeMid >>  0) & 0xFF);
+        batchSize = UUID_POOL_BATCH_SIZE;
+        if (batchSize > capacity - count) {
+            batchSize = (size_t)(capacity - count);
+        }
 
-    /* Time Low */
-    pUUID[4] = (unsigned char)((timeLow >> 24) & 0xFF);
-    pUUID[5] = (unsigned char)((timeLow >> 16) & 0xFF);
-    pUUID[6] = (unsigned char)((timeLow >>  8) & 0xFF);
-    pUUID[7] = (unsigned char)((timeLow >>  0) & 0xFF);
+        /* Take the time before generating so a UUID never looks newer than it is. */
+        time = uuid_pool_get_time();
 
+        if (uuid_pool_generate(pPool, pRNG, uuids, batchSize) != UUID_SUCCESS) {
+            return 0;
+        }
 
-    /* For the clock sequence and node ID we're always using a random number. */
-    result = uuid_rand_generate(pRNG, pUUID + 8, UUID_SIZE - 8);
-    if (result != UUID_SUCCESS) {
-        UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
-        return result;
+        for (iUUID = 0; iUUID < batchSize; iUUID += 1) {
+            if (!uuid_pool_enqueue(pPool, uuids + (iUUID * 16), time)) {
+                return 1;   /* Another producer filled it up. The rest of the batch is thrown away. */
+            }
+        }
     }
 
-    /* Setting the version number breaks the ordering property of these UUIDs so I'm leaving this unset. */
-    /*pUUID[6] = (unsigned char)(0x40 | (pUUID[6] & 0x0F));*/
+    return 1;
+}
 
-    /* Byte 8 needs to be updated to reflect the variant. In our case it'll always be Variant 1. */
-    pUUID[8] = (unsigned char)(0x80 | (pUUID[8] & 0x3F));
+static void uuid_pool_producer_entry(void* pUserData)
+{
+    uuid_pool_producer* pProducer = (uuid_pool_producer*)pUserData;
+    uuid_pool* pPool = pProducer->pPool;
+    uuid_uint64 now;
+    uuid_uint64 minTime;
+    int isIdle;
+
+    while (uuid_atomic_load_64(&pPool->isShuttingDown) == 0) {
+        if (pPool->config.maxAgeInMilliseconds > 0) {
+            now = uuid_pool_get_time();
+            uuid_atomic_store_64(&pPool->time, now);
+
+            /* Throw away anything that has gone stale so consumers don't need to do it. */
+            minTime = uuid_pool_get_min_time(pPool, now);
+            while (uuid_pool_dequeue(pPool, NULL, minTime, 1) == UUID_POOL_STALE) {
+            }
+        }
 
-    return UUID_SUCCESS;
-}
+        isIdle = 1;
+        if (uuid_atomic_load_64(&pPool->isRefillRequested) != 0 || uuid_pool_get_count(pPool) < pPool->config.lowWatermark) {
+            uuid_atomic_exchange_64(&pPool->isRefillRequested, 0);
+            isIdle = !uuid_pool_refill(pPool, uuid_pool_producer_get_rng(pProducer));
+        }
+
+        if (isIdle) {
+            uuid_event_wait(&pProducer->event, uuid_pool_get_timeout(pPool));
+        }
+    }
 
+    /* The default random number generator is thread-local. */
+    uuid_default_rng_shutdown();
+}
+#endif
 
-typedef enum
+static void uuid_pool_request_refill(uuid_pool* pPool)
 {
-    UUID_VERSION_1       = 1,   /* Timed. */
-    UUID_VERSION_2       = 2,   /* ??? */
-    UUID_VERSION_3       = 3,   /* Named with MD5 hashing. */
-    UUID_VERSION_4       = 4,   /* Random. */
-    UUID_VERSION_5       = 5,   /* Named with SHA1 hashing. */
-    UUID_VERSION_ORDERED = 100  /* Unofficial. Similar to version 1, but the time part is swapped so that it's sorted by time. Useful for database keys. */
-} uuid_version;
+    /* Only the first consumer to ask needs to wake up the producers. The flag is checked first so it's not written on every pop. */
+    if (uuid_atomic_load_64(&pPool->isRefillRequested) == 0 && uuid_atomic_exchange_64(&pPool->isRefillRequested, 1) == 0) {
+    #if defined(UUID_SUPPORT_THREADS)
+        uuid_pool_wake_producers(pPool);
+    #endif
+    }
+}
 
-static uuid_result uuidn(unsigned char* pUUID, uuid_rand* pRNG, const unsigned char* pNamespaceUUID, const char* pName, uuid_version version)
+UUID_API uuid_result uuid_pool_init(const uuid_pool_config* pConfig, uuid_pool* pPool)
 {
+#if defined(UUID_SUPPORT_THREADS)
+    uuid_pool_producer* pProducers;
+    uuid_uint32 iProducer;
+    uuid_uint32 iCell;
     uuid_result result;
-#if !defined(UUID_NO_CRYPTORAND)
-    uuid_cryptorand cryptorandRNG;
 #endif
 
-    if (pUUID == NULL) {
+    if (pPool == NULL) {
         return UUID_INVALID_ARGS;
     }
 
-    UUID_ZERO_MEMORY(pUUID, UUID_SIZE);
-
-    /* Some versions need s random number generator. */
-    if (version == UUID_VERSION_1 || version == UUID_VERSION_4 || version == UUID_VERSION_ORDERED) {
-        if (pRNG == NULL) {
-        #if !defined(UUID_NO_CRYPTORAND)
-            result = uuid_cryptorand_init(&cryptorandRNG);
-            if (result != UUID_SUCCESS) {
-                return result;
-            }
+    UUID_ZERO_OBJECT(pPool);
 
-            pRNG = &cryptorandRNG;
-        #else
-            return UUID_INVALID_ARGS;   /* No random number generator available. */
-        #endif
-        }
+    if (pConfig == NULL || pConfig->capacity == 0 || (pConfig->capacity & (pConfig->capacity - 1)) != 0 || pConfig->lowWatermark > pConfig->capacity || pConfig->producerCount == 0) {
+        return UUID_INVALID_ARGS;
     }
 
-    switch (version)
-    {
-        case UUID_VERSION_1:       result = uuid1_internal(pUUID, pRNG);                  break;
-        case UUID_VERSION_2:       result = UUID_NOT_IMPLEMENTED;                         break;
-        case UUID_VERSION_3:       result = uuid3_internal(pUUID, pNamespaceUUID, pName); break;
-        case UUID_VERSION_4:       result = uuid4_internal(pUUID, pRNG);                  break;
-        case UUID_VERSION_5:       result = uuid5_internal(pUUID, pNamespaceUUID, pName); break;
-        case UUID_VERSION_ORDERED: result = uuid_ordered_internal(pUUID, pRNG);           break;
-        default:                   result = UUID_INVALID_ARGS;                            break;  /* Unknown or unsupported version. */
-    };
+#if defined(UUID_SUPPORT_THREADS)
+    pPool->config = *pConfig;
+    pPool->mask   = pConfig->capacity - 1;
+    pPool->time   = uuid_pool_get_time();
 
-#if !defined(UUID_NO_CRYPTORAND)
-    if (pRNG == &cryptorandRNG) {
-        uuid_cryptorand_uninit(&cryptorandRNG);
+    pPool->lockedRNG.base.onGenerate = uuid_pool_locked_rng_generate;
+    pPool->lockedRNG.pRNG            = pConfig->pRNG;
+
+    if (pPool->config.lowWatermark == 0) {
+        pPool->config.lowWatermark = pConfig->capacity / 2;
     }
-#endif
 
-    return result;
-}
+    pPool->pCells = (uuid_pool_cell*)uuid_malloc(sizeof(*pPool->pCells) * pConfig->capacity, &pConfig->allocationCallbacks);
+    if (pPool->pCells == NULL) {
+        return UUID_OUT_OF_MEMORY;
+    }
 
+    for (iCell = 0; iCell < pConfig->capacity; iCell += 1) {
+        pPool->pCells[iCell].sequence = iCell;
+    }
 
-UUID_API uuid_result uuid1(unsigned char* pUUID, uuid_rand* pRNG)
-{
-    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_1);
-}
+    pProducers = (uuid_pool_producer*)uuid_malloc(sizeof(*pProducers) * pConfig->producerCount, &pConfig->allocationCallbacks);
+    if (pProducers == NULL) {
+        uuid_free(pPool->pCells, &pConfig->allocationCallbacks);
+        return UUID_OUT_OF_MEMORY;
+    }
 
-UUID_API uuid_result uuid3(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
-{
-    return uuidn(pUUID, NULL, pNamespaceUUID, pName, UUID_VERSION_3);
-}
+    pPool->pProducers = pProducers;
 
-UUID_API uuid_result uuid4(unsigned char* pUUID, uuid_rand* pRNG)
-{
-    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_4);
-}
+    for (iProducer = 0; iProducer < pConfig->producerCount; iProducer += 1) {
+        uuid_pool_producer* pProducer = &pProducers[iProducer];
 
-UUID_API uuid_result uuid5(unsigned char* pUUID, const unsigned char* pNamespaceUUID, const char* pName)
-{
-    return uuidn(pUUID, NULL, pNamespaceUUID, pName, UUID_VERSION_5);
-}
+        UUID_ZERO_OBJECT(pProducer);
+        pProducer->pPool = pPool;
 
-UUID_API uuid_result uuid_ordered(unsigned char* pUUID, uuid_rand* pRNG)
-{
-    return uuidn(pUUID, pRNG, NULL, NULL, UUID_VERSION_ORDERED);
-}
+        result = UUID_SUCCESS;
+        if (pConfig->pRNG != NULL) {
+            uuid_chacha_rng_config rngConfig = uuid_chacha_rng_config_init(uuid_pool_get_rng(pPool));
+            result = uuid_chacha_rng_init(&rngConfig, &pProducer->rng);
+        }
 
+        if (result == UUID_SUCCESS) {
+            result = uuid_event_init(&pProducer->event);
+            if (result == UUID_SUCCESS) {
+                result = uuid_thread_create(&pProducer->thread, uuid_pool_producer_entry, pProducer);
+                if (result != UUID_SUCCESS) {
+                    uuid_event_uninit(&pProducer->event);
+                }
+            }
 
+            if (result != UUID_SUCCESS) {
+                uuid_chacha_rng_uninit(&pProducer->rng);
+            }
+        }
 
+        if (result != UUID_SUCCESS) {
+            pPool->config.producerCount = iProducer;    /* Only uninitialize the producers that were started. */
+            uuid_pool_uninit(pPool);
+            return result;
+        }
+    }
 
-static void uuid_format_byte(char* dst, unsigned char byte)
-{
-    const char* hex = "0123456789abcdef";
-    dst[0] = hex[(byte & 0xF0) >> 4];
-    dst[1] = hex[(byte & 0x0F)     ];
+    return UUID_SUCCESS;
+#else
+    return UUID_NOT_IMPLEMENTED;
+#endif
 }
 
-UUID_API uuid_result uuid_format(char* dst, size_t dstCap, const unsigned char* pUUID)
+UUID_API void uuid_pool_uninit(uuid_pool* pPool)
 {
-    const char* format = "xxxx-xx-xx-xx-xxxxxx";
+#if defined(UUID_SUPPORT_THREADS)
+    uuid_pool_producer* pProducers;
+    uuid_uint32 iProducer;
 
-    if (dst == NULL) {
-        return UUID_INVALID_ARGS;
+    if (pPool == NULL || pPool->pProducers == NULL) {
+        return;
     }
 
-    if (dstCap < UUID_SIZE_FORMATTED) {
-        if (dstCap > 0) {
-            dst[0] = '\0';
-        }
+    pProducers = (uuid_pool_producer*)pPool->pProducers;
 
-        return UUID_INVALID_ARGS;
+    uuid_atomic_exchange_64(&pPool->isShuttingDown, 1);
+    uuid_pool_wake_producers(pPool);
+
+    for (iProducer = 0; iProducer < pPool->config.producerCount; iProducer += 1) {
+        uuid_thread_join(&pProducers[iProducer].thread);
+        uuid_event_uninit(&pProducers[iProducer].event);
+        uuid_chacha_rng_uninit(&pProducers[iProducer].rng);
     }
 
-    if (pUUID == NULL) {
-        dst[0] = '\0';
+    uuid_free(pPool->pProducers, &pPool->config.allocationCallbacks);
+    uuid_free(pPool->pCells, &pPool->config.allocationCallbacks);
+    UUID_ZERO_OBJECT(pPool);
+#else
+    (void)pPool;
+#endif
+}
+
+UUID_API uuid_result uuid_pool_pop(uuid_pool* pPool, unsigned char* pUUID)
+{
+    uuid_uint64 minTime = 0;
+    uuid_uint32 iAttempt;
+
+    if (pPool == NULL || pUUID == NULL || pPool->pCells == NULL) {
         return UUID_INVALID_ARGS;
     }
 
-    /* All we need to do here is convert the string to hex with dashes. */
-    for (;;) {
-        if (format[0] == '\0') {
+    if (pPool->config.maxAgeInMilliseconds > 0) {
+        minTime = uuid_pool_get_min_time(pPool, uuid_atomic_load_64(&pPool->time));
+    }
+
+    for (iAttempt = 0; iAttempt < UUID_POOL_MAX_STALE_DISCARDS; iAttempt += 1) {
+        uuid_pool_dequeue_result result = uuid_pool_dequeue(pPool, pUUID, minTime, 0);
+        if (result == UUID_POOL_EMPTY) {
             break;
         }
 
-        if (format[0] == 'x') {
-            uuid_format_byte(dst, pUUID[0]);
-            dst   += 2;
-            pUUID += 1;
-        } else {
-            dst[0] = format[0];
-            dst += 1;
-        }
+        if (result == UUID_POOL_FRESH) {
+            if (uuid_pool_get_count(pPool) < pPool->config.lowWatermark) {
+                uuid_pool_request_refill(pPool);
+            }
 
-        format += 1;
+            return UUID_SUCCESS;
+        }
     }
 
-    /* Never forget to null terminate. */
-    dst[0] = '\0';
+    /* Nothing usable in the ring. Don't wait for the producers, just generate it here. */
+    uuid_pool_request_refill(pPool);
 
-    return UUID_SUCCESS;
+    return uuid_pool_generate(pPool, uuid_pool_get_rng(pPool), pUUID, 1);
 }
-
 #endif  /* uuid_c */
 #endif  /* UUID_IMPLEMENTATION */
 
@@ -0,0 +1,895 @@
+/*
+C++ wrapper for uuid.h. Requires C++20. This is header-only, but uuid.h still needs to be implemented
+in exactly one translation unit by defining UUID_IMPLEMENTATION before including it, as normal.
+
+    uuids::uuid id = uuids::v7();
+
+    std::unordered_map<uuids::uuid, Thing> things;
+    things[id] = thing;
+
+    std::string str = std::format("{}", id);
+
+`uuids::uuid` is a trivially copyable, 16-byte value type aligned to 16 bytes. It can be passed and
+returned by value in registers. It compares the same as `uuid_compare()`, hashes the same as
+`uuid_hash()` with a seed of 0, and can be used as a key in ordered containers, hashed containers and
+flat containers without converting it to a string. It can be constructed from bytes or from a string
+at compile time:
+
+    constexpr uuids::uuid ns("6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+
+The string constructor accepts the same formats as `uuid_parse()` and reads up to the first null
+terminator or the end of the array, whichever comes first. An invalid string is a compile error when
+it's used in a constant expression and results in the nil UUID otherwise. Use `uuids::uuid::parse()`
+if you need to know whether parsing succeeded.
+
+The `_uuid` literal is always evaluated at compile time, so an invalid string is always an error:
+
+    using namespace uuids::literals;
+    constexpr uuids::uuid ns = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid;
+
+Version 3 and 5 UUIDs can also be generated at compile time. These have their own MD5 and SHA-1
+implementations which don't depend on the ones configured for uuid.h, and produce the same bytes as
+`uuid3()` and `uuid5()`:
+
+    constexpr uuids::uuid id = uuids::uuid5_ct(ns, "www.example.com");
+
+The generation functions return the nil UUID if generation fails, which can only happen if the random
+number generator fails. They take an optional `uuid_rand*`, which can come from one of the random
+number generator classes:
+
+    uuids::chacha_rng rng;
+    uuids::uuid id = uuids::v4(rng.get());
+
+    uuids::generator generator(rng.get());
+    uuids::uuid id = generator.v7();
+
+These own the underlying object and uninitialize it when they're destroyed. They can be moved but not
+copied. Moving one changes the address of the underlying object, so anything holding the old pointer
+from `get()`, such as a `buffered_rng` that wraps it or a `generator` using it for version 7 UUIDs,
+must not use it afterwards. Check `result()` after construction to see whether initialization
+succeeded.
+*/
+#ifndef uuid_hpp
+#define uuid_hpp
+
+#if __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#error "uuid.hpp requires C++20."
+#endif
+
+#include "uuid.h"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__has_include)
+    #if __has_include(<format>)
+        #include <format>
+    #endif
+#endif
+
+namespace uuids
+{
+    namespace detail
+    {
+        constexpr std::uint64_t load_be64(const unsigned char* p) noexcept
+        {
+            return
+                ((std::uint64_t)p[0] << 56) | ((std::uint64_t)p[1] << 48) | ((std::uint64_t)p[2] << 40) | ((std::uint64_t)p[3] << 32) |
+                ((std::uint64_t)p[4] << 24) | ((std::uint64_t)p[5] << 16) | ((std::uint64_t)p[6] <<  8) | ((std::uint64_t)p[7] <<  0);
+        }
+
+        constexpr std::uint64_t load_le64(const unsigned char* p) noexcept
+        {
+            return
+                ((std::uint64_t)p[0] <<  0) | ((std::uint64_t)p[1] <<  8) | ((std::uint64_t)p[2] << 16) | ((std::uint64_t)p[3] << 24) |
+                ((std::uint64_t)p[4] << 32) | ((std::uint64_t)p[5] << 40) | ((std::uint64_t)p[6] << 48) | ((std::uint64_t)p[7] << 56);
+        }
+
+        constexpr std::uint64_t bswap64(std::uint64_t x) noexcept
+        {
+            return
+                ((x & 0x00000000000000FFULL) << 56) | ((x & 0x000000000000FF00ULL) << 40) | ((x & 0x0000000000FF0000ULL) << 24) | ((x & 0x00000000FF000000ULL) <<  8) |
+                ((x & 0x000000FF00000000ULL) >>  8) | ((x & 0x0000FF0000000000ULL) >> 24) | ((x & 0x00FF000000000000ULL) >> 40) | ((x & 0xFF00000000000000ULL) >> 56);
+        }
+
+        /* The low and high halves of a 64x64 to 128-bit multiply, XORed together. */
+        constexpr std::uint64_t mul128_fold64(std::uint64_t a, std::uint64_t b) noexcept
+        {
+        #if defined(__SIZEOF_INT128__)
+            __extension__ typedef unsigned __int128 uint128;
+            uint128 product = (uint128)a * b;
+            return (std::uint64_t)product ^ (std::uint64_t)(product >> 64);
+        #else
+            std::uint64_t aLo = a & 0xFFFFFFFF;
+            std::uint64_t aHi = a >> 32;
+            std::uint64_t bLo = b & 0xFFFFFFFF;
+            std::uint64_t bHi = b >> 32;
+            std::uint64_t loLo = aLo * bLo;
+            std::uint64_t hiLo = aHi * bLo;
+            std::uint64_t loHi = aLo * bHi;
+            std::uint64_t hiHi = aHi * bHi;
+            std::uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+            std::uint64_t upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+            std::uint64_t lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+            return lower ^ upper;
+        #endif
+        }
+
+        constexpr int hex_value(char c) noexcept
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        constexpr bool decode_hex(unsigned char* pBytes, const char* pHex, std::size_t byteCount) noexcept
+        {
+            for (std::size_t i = 0; i < byteCount; i += 1) {
+                int hi = hex_value(pHex[i*2 + 0]);
+                int lo = hex_value(pHex[i*2 + 1]);
+                if (hi < 0 || lo < 0) {
+                    return false;
+                }
+
+                pBytes[i] = (unsigned char)((hi << 4) | lo);
+            }
+
+            return true;
+        }
+
+        /* xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx */
+        constexpr bool parse_canonical(unsigned char* pBytes, const char* pSrc) noexcept
+        {
+            if (pSrc[8] != '-' || pSrc[13] != '-' || pSrc[18] != '-' || pSrc[23] != '-') {
+                return false;
+            }
+
+            return
+                decode_hex(pBytes +  0, pSrc +  0, 4) &&
+                decode_hex(pBytes +  4, pSrc +  9, 2) &&
+                decode_hex(pBytes +  6, pSrc + 14, 2) &&
+                decode_hex(pBytes +  8, pSrc + 19, 2) &&
+                decode_hex(pBytes + 10, pSrc + 24, 6);
+        }
+
+        constexpr char to_lower(char c) noexcept
+        {
+            return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+        }
+
+        /* The same formats as uuid_parse(). */
+        constexpr bool parse(unsigned char* pBytes, std::string_view str) noexcept
+        {
+            switch (str.size())
+            {
+                case 32: return decode_hex(pBytes, str.data(), UUID_SIZE);
+                case 36: return parse_canonical(pBytes, str.data());
+                case 38: return str[0] == '{' && str[37] == '}' && parse_canonical(pBytes, str.data() + 1);
+                case 45:
+                {
+                    const char* pPrefix = "urn:uuid:";
+                    for (std::size_t i = 0; i < 9; i += 1) {
+                        if (to_lower(str[i]) != pPrefix[i]) {
+                            return false;
+                        }
+                    }
+
+                    return parse_canonical(pBytes, str.data() + 9);
+                }
+                default: return false;
+            }
+        }
+
+        /*
+        This is deliberately not constexpr. Calling it during constant evaluation is what turns an
+        invalid UUID string into a compile error.
+        */
+        inline void invalid_uuid_string() noexcept
+        {
+        }
+
+
+        /*
+        Compile time MD5 and SHA-1 for version 3 and 5 UUIDs. These are slow and are only intended for
+        constant evaluation. The message is always the namespace followed by the name, so rather than
+        building a padded copy of it, each byte of the padded message is worked out as it's needed.
+        */
+        class name_message
+        {
+        public:
+            constexpr name_message(const unsigned char* pNamespace, std::string_view name) noexcept
+                : m_pNamespace(pNamespace)
+                , m_name(name)
+            {
+            }
+
+            constexpr std::size_t size() const noexcept
+            {
+                return UUID_SIZE + m_name.size();
+            }
+
+            /* The number of 64 byte blocks after padding, which needs room for the 0x80 byte and the 8 byte length. */
+            constexpr std::size_t block_count() const noexcept
+            {
+                return (size() + 1 + 8 + 63) / 64;
+            }
+
+            constexpr unsigned char byte_at(std::size_t i, bool bigEndianLength) const noexcept
+            {
+                std::size_t lengthOffset = block_count()*64 - 8;
+                std::uint64_t lengthInBits = (std::uint64_t)size() * 8;
+
+                if (i < UUID_SIZE) {
+                    return m_pNamespace[i];
+                }
+                if (i < size()) {
+                    return (unsigned char)m_name[i - UUID_SIZE];
+                }
+                if (i == size()) {
+                    return 0x80;
+                }
+                if (i >= lengthOffset) {
+                    std::size_t shift = (i - lengthOffset) * 8;
+                    return (unsigned char)(lengthInBits >> (bigEndianLength ? (56 - shift) : shift));
+                }
+
+                return 0;
+            }
+
+        private:
+            const unsigned char* m_pNamespace;
+            std::string_view m_name;
+        };
+
+        constexpr std::uint32_t rotl32(std::uint32_t x, int n) noexcept
+        {
+            return (x << n) | (x >> (32 - n));
+        }
+
+        constexpr std::array<unsigned char, 16> md5(const name_message& message) noexcept
+        {
+            constexpr std::uint32_t k[64] = {
+                0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+                0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE, 0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+                0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+                0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED, 0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+                0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+                0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05, 0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+                0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+                0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391
+            };
+            constexpr int s[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+            std::uint32_t state[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+            std::array<unsigned char, 16> digest{};
+
+            for (std::size_t iBlock = 0; iBlock < message.block_count(); iBlock += 1) {
+                std::uint32_t m[16] = {};
+                std::uint32_t a = state[0];
+                std::uint32_t b = state[1];
+                std::uint32_t c = state[2];
+                std::uint32_t d = state[3];
+
+                for (std::size_t i = 0; i < 64; i += 1) {
+                    m[i / 4] |= (std::uint32_t)message.byte_at(iBlock*64 + i, false) << ((i % 4) * 8);
+                }
+
+                for (std::size_t i = 0; i < 64; i += 1) {
+                    std::uint32_t f;
+                    std::size_t g;
+
+                    if (i < 16) {
+                        f = (b & c) | (~b & d);
+                        g = i;
+                    } else if (i < 32) {
+                        f = (d & b) | (~d & c);
+                        g = (5*i + 1) % 16;
+                    } else if (i < 48) {
+                        f = b ^ c ^ d;
+                        g = (3*i + 5) % 16;
+                    } else {
+                        f = c ^ (b | ~d);
+                        g = (7*i) % 16;
+                    }
+
+                    f = f + a + k[i] + m[g];
+                    a = d;
+                    d = c;
+                    c = b;
+                    b = b + rotl32(f, s[(i / 16)*4 + (i % 4)]);
+                }
+
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+            }
+
+            for (std::size_t i = 0; i < 16; i += 1) {
+                digest[i] = (unsigned char)(state[i / 4] >> ((i % 4) * 8));
+            }
+
+            return digest;
+        }
+
+        constexpr std::array<unsigned char, 20> sha1(const name_message& message) noexcept
+        {
+            std::uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+            std::array<unsigned char, 20> digest{};
+
+            for (std::size_t iBlock = 0; iBlock < message.block_count(); iBlock += 1) {
+                std::uint32_t w[80] = {};
+                std::uint32_t a = state[0];
+                std::uint32_t b = state[1];
+                std::uint32_t c = state[2];
+                std::uint32_t d = state[3];
+                std::uint32_t e = state[4];
+
+                for (std::size_t i = 0; i < 64; i += 1) {
+                    w[i / 4] |= (std::uint32_t)message.byte_at(iBlock*64 + i, true) << ((3 - (i % 4)) * 8);
+                }
+
+                for (std::size_t i = 16; i < 80; i += 1) {
+                    w[i] = rotl32(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+                }
+
+                for (std::size_t i = 0; i < 80; i += 1) {
+                    std::uint32_t f;
+                    std::uint32_t k;
+                    std::uint32_t temp;
+
+                    if (i < 20) {
+                        f = (b & c) | (~b & d);
+                        k = 0x5A827999;
+                    } else if (i < 40) {
+                        f = b ^ c ^ d;
+                        k = 0x6ED9EBA1;
+                    } else if (i < 60) {
+                        f = (b & c) | (b & d) | (c & d);
+                        k = 0x8F1BBCDC;
+                    } else {
+                        f = b ^ c ^ d;
+                        k = 0xCA62C1D6;
+                    }
+
+                    temp = rotl32(a, 5) + f + e + k + w[i];
+                    e = d;
+                    d = c;
+                    c = rotl32(b, 30);
+                    b = a;
+                    a = temp;
+                }
+
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+                state[4] += e;
+            }
+
+            for (std::size_t i = 0; i < 20; i += 1) {
+                digest[i] = (unsigned char)(state[i / 4] >> ((3 - (i % 4)) * 8));
+            }
+
+            return digest;
+        }
+    }
+
+    class alignas(16) uuid
+    {
+    public:
+        constexpr uuid() noexcept
+            : m_bytes{}
+        {
+        }
+
+        constexpr explicit uuid(const std::array<unsigned char, UUID_SIZE>& bytes) noexcept
+            : m_bytes(bytes)
+        {
+        }
+
+        template<std::size_t N>
+        constexpr explicit uuid(const char (&str)[N]) noexcept
+            : m_bytes{}
+        {
+            /* The array might be a buffer rather than a literal, so stop at the first null terminator. */
+            std::size_t len = 0;
+            while (len < N && str[len] != '\0') {
+                len += 1;
+            }
+
+            if (!detail::parse(m_bytes.data(), std::string_view(str, len))) {
+                if (std::is_constant_evaluated()) {
+                    detail::invalid_uuid_string();
+                }
+
+                m_bytes = {};
+            }
+        }
+
+        static constexpr uuid from_bytes(const unsigned char* pBytes) noexcept
+        {
+            uuid result;
+            for (std::size_t i = 0; i < UUID_SIZE; i += 1) {
+                result.m_bytes[i] = pBytes[i];
+            }
+
+            return result;
+        }
+
+        static constexpr std::optional<uuid> parse(std::string_view str) noexcept
+        {
+            uuid result;
+            if (!detail::parse(result.m_bytes.data(), str)) {
+                return std::nullopt;
+            }
+
+            return result;
+        }
+
+        static constexpr std::size_t size() noexcept
+        {
+            return UUID_SIZE;
+        }
+
+        constexpr const unsigned char* data() const noexcept
+        {
+            return m_bytes.data();
+        }
+
+        constexpr unsigned char* data() noexcept
+        {
+            return m_bytes.data();
+        }
+
+        constexpr const std::array<unsigned char, UUID_SIZE>& bytes() const noexcept
+        {
+            return m_bytes;
+        }
+
+        constexpr bool is_nil() const noexcept
+        {
+            return (detail::load_le64(m_bytes.data() + 0) | detail::load_le64(m_bytes.data() + 8)) == 0;
+        }
+
+        constexpr int version() const noexcept
+        {
+            return m_bytes[6] >> 4;
+        }
+
+        /* The same as uuid_hash(). */
+        constexpr std::uint64_t hash(std::uint64_t seed = 0) const noexcept
+        {
+            std::uint64_t lo = detail::load_le64(m_bytes.data() + 0) ^ (0x9E3779B97F4A7C15ULL + seed);
+            std::uint64_t hi = detail::load_le64(m_bytes.data() + 8) ^ (0xC2B2AE3D27D4EB4FULL - seed);
+            std::uint64_t h;
+
+            h = UUID_SIZE + detail::bswap64(lo) + hi + detail::mul128_fold64(lo, hi);
+
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ULL;
+            h ^= h >> 32;
+
+            return h;
+        }
+
+        /* Writes the 36 character lowercase form without a null terminator. Returns a pointer to the end. */
+        constexpr char* format_to(char* pDst) const noexcept
+        {
+            const char* pDigits = "0123456789abcdef";
+
+            for (std::size_t i = 0; i < UUID_SIZE; i += 1) {
+                if (i == 4 || i == 6 || i == 8 || i == 10) {
+                    *pDst++ = '-';
+                }
+
+                *pDst++ = pDigits[m_bytes[i] >> 4];
+                *pDst++ = pDigits[m_bytes[i] & 0x0F];
+            }
+
+            return pDst;
+        }
+
+        std::string to_string() const
+        {
+            char str[UUID_SIZE_FORMATTED - 1];
+            format_to(str);
+            return std::string(str, sizeof(str));
+        }
+
+        friend constexpr bool operator==(const uuid& a, const uuid& b) noexcept
+        {
+            return detail::load_le64(a.m_bytes.data() + 0) == detail::load_le64(b.m_bytes.data() + 0) && detail::load_le64(a.m_bytes.data() + 8) == detail::load_le64(b.m_bytes.data() + 8);
+        }
+
+        /* The same order as uuid_compare() which is the same as comparing the bytes. */
+        friend constexpr std::strong_ordering operator<=>(const uuid& a, const uuid& b) noexcept
+        {
+            std::uint64_t aHi = detail::load_be64(a.m_bytes.data() + 0);
+            std::uint64_t bHi = detail::load_be64(b.m_bytes.data() + 0);
+
+            if (aHi != bHi) {
+                return aHi <=> bHi;
+            }
+
+            return detail::load_be64(a.m_bytes.data() + 8) <=> detail::load_be64(b.m_bytes.data() + 8);
+        }
+
+    private:
+        std::array<unsigned char, UUID_SIZE> m_bytes;
+    };
+
+    static_assert(sizeof(uuid) == UUID_SIZE);
+    static_assert(alignof(uuid) == 16);
+    static_assert(std::is_trivially_copyable_v<uuid>);
+    static_assert(std::is_standard_layout_v<uuid>);
+
+
+    /* Generation. These return the nil UUID on failure. Pass nullptr for the default random number generator. */
+    inline uuid v1(uuid_rand* pRNG = nullptr) noexcept
+    {
+        uuid result;
+        uuid1(result.data(), pRNG);
+        return result;
+    }
+
+    inline uuid v4(uuid_rand* pRNG = nullptr) noexcept
+    {
+        uuid result;
+        uuid4(result.data(), pRNG);
+        return result;
+    }
+
+    inline uuid v6(uuid_rand* pRNG = nullptr) noexcept
+    {
+        uuid result;
+        uuid6(result.data(), pRNG);
+        return result;
+    }
+
+    inline uuid v7(uuid_rand* pRNG = nullptr) noexcept
+    {
+        uuid result;
+        uuid7(result.data(), pRNG);
+        return result;
+    }
+
+    inline uuid ordered(uuid_rand* pRNG = nullptr) noexcept
+    {
+        uuid result;
+        uuid_ordered(result.data(), pRNG);
+        return result;
+    }
+
+
+    /* Compile time version 3 and 5 UUIDs. These produce the same bytes as uuid3() and uuid5(). */
+    consteval uuid uuid3_ct(const uuid& ns, std::string_view name) noexcept
+    {
+        std::array<unsigned char, 16> hash = detail::md5(detail::name_message(ns.data(), name));
+        uuid result = uuid::from_bytes(hash.data());
+
+        result.data()[6] = (unsigned char)(0x30 | (result.data()[6] & 0x0F));
+        result.data()[8] = (unsigned char)(0x80 | (result.data()[8] & 0x3F));
+
+        return result;
+    }
+
+    consteval uuid uuid5_ct(const uuid& ns, std::string_view name) noexcept
+    {
+        std::array<unsigned char, 20> hash = detail::sha1(detail::name_message(ns.data(), name));
+        uuid result = uuid::from_bytes(hash.data());
+
+        result.data()[6] = (unsigned char)(0x50 | (result.data()[6] & 0x0F));
+        result.data()[8] = (unsigned char)(0x80 | (result.data()[8] & 0x3F));
+
+        return result;
+    }
+
+
+    namespace literals
+    {
+        /* Always evaluated at compile time. An invalid string is a compile error. */
+        consteval uuid operator""_uuid(const char* str, std::size_t len) noexcept
+        {
+            std::optional<uuid> result = uuid::parse(std::string_view(str, len));
+            if (!result.has_value()) {
+                detail::invalid_uuid_string();
+            }
+
+            return result.value_or(uuid());
+        }
+    }
+
+
+    /* Owns a uuid_chacha_rng. */
+    class chacha_rng
+    {
+    public:
+        chacha_rng() noexcept
+            : chacha_rng(uuid_chacha_rng_config_init(nullptr))
+        {
+        }
+
+        explicit chacha_rng(const uuid_chacha_rng_config& config) noexcept
+        {
+            m_result = uuid_chacha_rng_init(&config, &m_rng);
+            if (m_result != UUID_SUCCESS) {
+                std::memset(&m_rng, 0, sizeof(m_rng));  /* Makes sure generating fails rather than using garbage. */
+            }
+        }
+
+        ~chacha_rng()
+        {
+            release();
+        }
+
+        chacha_rng(chacha_rng&& other) noexcept
+            : m_rng(other.m_rng)
+            , m_result(other.m_result)
+        {
+            other.release();
+        }
+
+        chacha_rng& operator=(chacha_rng&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                m_rng    = other.m_rng;
+                m_result = other.m_result;
+                other.release();
+            }
+
+            return *this;
+        }
+
+        chacha_rng(const chacha_rng&) = delete;
+        chacha_rng& operator=(const chacha_rng&) = delete;
+
+        uuid_rand* get() noexcept
+        {
+            return (uuid_rand*)&m_rng;
+        }
+
+        uuid_result result() const noexcept
+        {
+            return m_result;
+        }
+
+        uuid_result reseed() noexcept
+        {
+            return uuid_chacha_rng_reseed(&m_rng);
+        }
+
+    private:
+        void release() noexcept
+        {
+            /* Uninitializing wipes the key, which is also what we want for the moved-from copy. */
+            if (m_result == UUID_SUCCESS) {
+                uuid_chacha_rng_uninit(&m_rng);
+            }
+
+            m_result = UUID_INVALID_OPERATION;
+        }
+
+        uuid_chacha_rng m_rng;
+        uuid_result m_result;
+    };
+
+
+    /* Owns a uuid_rand_buffered and its pool. The pool is on the heap so moving doesn't invalidate it. */
+    class buffered_rng
+    {
+    public:
+        explicit buffered_rng(uuid_rand* pUpstream = nullptr, std::size_t poolSize = 4096) noexcept
+            : m_pPool(new (std::nothrow) unsigned char[poolSize])
+        {
+            std::memset(&m_rng, 0, sizeof(m_rng));
+
+            if (m_pPool == nullptr) {
+                m_result = UUID_OUT_OF_MEMORY;
+                return;
+            }
+
+            m_result = uuid_rand_buffered_init(pUpstream, m_pPool.get(), poolSize, &m_rng);
+            if (m_result != UUID_SUCCESS) {
+                std::memset(&m_rng, 0, sizeof(m_rng));
+            }
+        }
+
+        ~buffered_rng()
+        {
+            release();
+        }
+
+        buffered_rng(buffered_rng&& other) noexcept
+            : m_pPool(std::move(other.m_pPool))
+            , m_rng(other.m_rng)
+            , m_result(other.m_result)
+        {
+            other.m_result = UUID_INVALID_OPERATION;
+            std::memset(&other.m_rng, 0, sizeof(other.m_rng));
+        }
+
+        buffered_rng& operator=(buffered_rng&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                m_pPool  = std::move(other.m_pPool);
+                m_rng    = other.m_rng;
+                m_result = other.m_result;
+                other.m_result = UUID_INVALID_OPERATION;
+                std::memset(&other.m_rng, 0, sizeof(other.m_rng));
+            }
+
+            return *this;
+        }
+
+        buffered_rng(const buffered_rng&) = delete;
+        buffered_rng& operator=(const buffered_rng&) = delete;
+
+        uuid_rand* get() noexcept
+        {
+            return (uuid_rand*)&m_rng;
+        }
+
+        uuid_result result() const noexcept
+        {
+            return m_result;
+        }
+
+        uuid_result flush() noexcept
+        {
+            return uuid_rand_buffered_flush(&m_rng);
+        }
+
+    private:
+        void release() noexcept
+        {
+            if (m_result == UUID_SUCCESS) {
+                uuid_rand_buffered_uninit(&m_rng);
+            }
+
+            m_result = UUID_INVALID_OPERATION;
+        }
+
+        std::unique_ptr<unsigned char[]> m_pPool;
+        uuid_rand_buffered m_rng;
+        uuid_result m_result;
+    };
+
+
+    /*
+    Owns a uuid_generator for strictly increasing time-based UUIDs. Like uuid_generator, this can be
+    shared between threads, but it must not be moved while other threads are using it.
+    */
+    class generator
+    {
+    public:
+        explicit generator(uuid_rand* pRNG = nullptr, uuid_clock* pClock = nullptr) noexcept
+        {
+            m_result = uuid_generator_init(pRNG, pClock, &m_generator);
+        }
+
+        ~generator()
+        {
+            release();
+        }
+
+        generator(generator&& other) noexcept
+            : m_result(other.m_result)
+        {
+            std::memcpy((void*)&m_generator, (const void*)&other.m_generator, sizeof(m_generator));
+            other.release();
+        }
+
+        generator& operator=(generator&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                std::memcpy((void*)&m_generator, (const void*)&other.m_generator, sizeof(m_generator));
+                m_result = other.m_result;
+                other.release();
+            }
+
+            return *this;
+        }
+
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+
+        uuid_result result() const noexcept
+        {
+            return m_result;
+        }
+
+        uuid v1() noexcept
+        {
+            uuid result;
+            uuid_generator_uuid1(&m_generator, result.data());
+            return result;
+        }
+
+        uuid v6() noexcept
+        {
+            uuid result;
+            uuid_generator_uuid6(&m_generator, result.data());
+            return result;
+        }
+
+        uuid v7() noexcept
+        {
+            uuid result;
+            uuid_generator_uuid7(&m_generator, result.data());
+            return result;
+        }
+
+        uuid ordered() noexcept
+        {
+            uuid result;
+            uuid_generator_ordered(&m_generator, result.data());
+            return result;
+        }
+
+    private:
+        void release() noexcept
+        {
+            if (m_result == UUID_SUCCESS) {
+                uuid_generator_uninit(&m_generator);
+            }
+
+            m_result = UUID_INVALID_OPERATION;
+        }
+
+        uuid_generator m_generator;
+        uuid_result m_result;
+    };
+}
+
+template<>
+struct std::hash<uuids::uuid>
+{
+    std::size_t operator()(const uuids::uuid& id) const noexcept
+    {
+        return (std::size_t)id.hash();
+    }
+};
+
+#if defined(__cpp_lib_format)
+/* Formats as the 36 character lowercase form. No format specifiers are supported. */
+template<>
+struct std::formatter<uuids::uuid, char>
+{
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it != '}') {
+            throw std::format_error("Invalid format specifier for uuids::uuid.");
+        }
+
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const uuids::uuid& id, FormatContext& ctx) const
+    {
+        char str[UUID_SIZE_FORMATTED - 1];
+        id.format_to(str);
+        return std::copy(str, str + sizeof(str), ctx.out());
+    }
+};
+#endif
+
+#endif  /* uuid_hpp */